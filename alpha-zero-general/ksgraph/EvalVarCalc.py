@@ -1,3 +1,6 @@
+import ctypes
+import os
+
 from pysat.solvers import Solver
 from pysat.formula import CNF
 import operator
@@ -71,7 +74,9 @@ class MarchPysatPropagate:
         self.freevars_all = freevars + freevars_neg
 
         self.node_count = 0
+        # both caches are keyed by the sorted cube, so that transpositions share entries
         self.cached_unsat_learnt_actions = {}
+        self.cached_results = {}
 
     def build_binary_implications(self, clauses):
         BinaryImp = defaultdict(list)
@@ -87,31 +92,21 @@ class MarchPysatPropagate:
         ]
         return freevarsArray
 
-    def propagate(self, node):
-
-        if tuple(node.prior_actions[:-1]) in self.cached_unsat_learnt_actions: # check if the parent node's unsat_learnt_actions are cached
-            node.unsat_learnt_actions = self.cached_unsat_learnt_actions[tuple(node.prior_actions[:-1])][:]
-
+    def lookahead(self, node):
+        """Propagate the node and each valid cubing literal under it, adding failed literals to
+        node.unsat_learnt_actions until none fails. Returns None if the node itself is refuted, and
+        otherwise the number of assigned edge variables, the reward of every valid literal and the
+        valid literals."""
         out1 = self.solver.propagate(assumptions=node.prior_actions+node.unsat_learnt_actions)
         assert out1 is not None
         not_unsat1, asgn1 = out1
+        if not not_unsat1:
+            return None
         len_asgn_edge_vars = len(set(asgn1).intersection(set(self.literals_all))) # number of assigned edge variables
 
-        # check for refutation
-        if not not_unsat1: # on second thought, this should never happen because FLE is being used and len(all_lit_rew) == 0 will be caught before this
-            assert False, "Refutation found in the parent node"
-            node.refuted = True
-            node.reward = 1.0 # max reward
-            return 0, None, {k: 0 for k in range(1, self.m+1)} # pass an empty dict
-        else:
-            node.refuted = False
-
-        #TODO: what if the result is SAT?
-
         while True:
             unsat_flag = False
             all_lit_rew = {}
-            all_var_rew = {}
             valid_cubing_lits = node.valid_cubing_lits(self.literals_all, self.freevars_all)
 
             for literal in valid_cubing_lits:
@@ -129,15 +124,50 @@ class MarchPysatPropagate:
 
             if not unsat_flag: # no refutation found
                 break
-        
-        if tuple(node.prior_actions) not in self.cached_unsat_learnt_actions:
-            self.cached_unsat_learnt_actions[tuple(node.prior_actions)] = node.unsat_learnt_actions[:]
+
+        return len_asgn_edge_vars, all_lit_rew, valid_cubing_lits
+
+    def propagate(self, node):
+        key = tuple(sorted(node.prior_actions))
+
+        if key in self.cached_results: # the node was propagated before
+            unsat_learnt_actions, cutoff, reward, result = self.cached_results[key]
+            node.unsat_learnt_actions = unsat_learnt_actions[:]
+            node.refuted = False
+            node.cutoff = cutoff
+            node.reward = reward
+            return result[0], result[1], dict(result[2])
+
+        parent_key = tuple(sorted(node.prior_actions[:-1]))
+        if parent_key in self.cached_unsat_learnt_actions: # check if the parent node's unsat_learnt_actions are cached
+            node.unsat_learnt_actions = self.cached_unsat_learnt_actions[parent_key][:]
+
+        out = self.lookahead(node)
+
+        # check for refutation
+        if out is None: # on second thought, this should never happen because FLE is being used and len(all_lit_rew) == 0 will be caught before this
+            assert False, "Refutation found in the parent node"
+            node.refuted = True
+            node.reward = 1.0 # max reward
+            return 0, None, {k: 0 for k in range(1, self.m+1)} # pass an empty dict
+        else:
+            node.refuted = False
+
+        #TODO: what if the result is SAT?
+
+        len_asgn_edge_vars, all_lit_rew, valid_cubing_lits = out
+        all_var_rew = {}
+
+        if key not in self.cached_unsat_learnt_actions:
+            self.cached_unsat_learnt_actions[key] = node.unsat_learnt_actions[:]
 
         if len(all_lit_rew) == 0:
             node.cutoff = True
             node.reward = 1.0 # no valid cubing literals found, so reward is max
             # print(f"Node: {node.prior_actions} - no valid cubing literals found, so reward is max")
-            return 0, None, {k: 0 for k in range(1, self.m+1)}
+            result = (0, None, {k: 0 for k in range(1, self.m+1)})
+            self.cached_results[key] = (node.unsat_learnt_actions[:], node.cutoff, node.reward, result)
+            return result[0], result[1], dict(result[2])
 
         # combine the rewards of the positive and negative literals
         for literal in valid_cubing_lits:
@@ -147,4 +177,51 @@ class MarchPysatPropagate:
         # get the key (var) of the best value (eval_var)
         next_best_var = max(all_var_rew.items(), key=operator.itemgetter(1))[0]
 
-        return 1, len_asgn_edge_vars, all_var_rew
\ No newline at end of file
+        self.cached_results[key] = (node.unsat_learnt_actions[:], node.cutoff, node.reward, (1, len_asgn_edge_vars, dict(all_var_rew)))
+        return 1, len_asgn_edge_vars, all_var_rew
+
+class MarchNativePropagate(MarchPysatPropagate):
+    """MarchPysatPropagate with the lookahead done in one call to the native reward engine of march
+    (march_rewards in march/marchlib.h), optionally with several threads. Needs march/libmarch.so,
+    built with `make libmarch.so` in march/, or the library given by lib_path or MARCH_LIB."""
+
+    def __init__(self, cnf, m, threads=1, lib_path=None) -> None:
+        super().__init__(cnf, m)
+        self.threads = threads
+
+        if lib_path is None:
+            lib_path = os.environ.get("MARCH_LIB", os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "march", "libmarch.so"))
+        self.lib = ctypes.CDLL(lib_path)
+        self.lib.march_ctx_new.restype = ctypes.c_void_p
+        self.lib.march_ctx_free.argtypes = [ctypes.c_void_p]
+        self.lib.march_load_clauses.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_int), ctypes.c_int]
+        int_p = ctypes.POINTER(ctypes.c_int)
+        self.lib.march_rewards.argtypes = [ctypes.c_void_p, int_p, ctypes.c_int, int_p, ctypes.c_int, ctypes.c_int, ctypes.c_int, int_p, int_p, int_p, int_p]
+
+        lits = [l for clause in self.cnf.clauses for l in clause + [0]]
+        self.ctx = self.lib.march_ctx_new()
+        self.lib.march_load_clauses(self.ctx, (ctypes.c_int * len(lits))(*lits), len(lits))
+
+    def __del__(self):
+        if getattr(self, "ctx", None):
+            self.lib.march_ctx_free(self.ctx)
+            self.ctx = None
+
+    def lookahead(self, node):
+        assumptions = node.prior_actions + node.unsat_learnt_actions
+        candidates = sorted(node.valid_cubing_lits(self.literals_all, self.freevars_all))
+
+        n = len(candidates)
+        counts = (ctypes.c_int * max(n, 1))()
+        learnt = (ctypes.c_int * max(n, 1))()
+        nroflearnt, assigned = ctypes.c_int(0), ctypes.c_int(0)
+
+        not_unsat = self.lib.march_rewards(self.ctx, (ctypes.c_int * max(len(assumptions), 1))(*assumptions), len(assumptions),
+                                           (ctypes.c_int * max(n, 1))(*candidates), n, self.m, self.threads,
+                                           counts, learnt, ctypes.byref(nroflearnt), ctypes.byref(assigned))
+        if not not_unsat:
+            return None
+
+        node.unsat_learnt_actions += learnt[:nroflearnt.value]
+        all_lit_rew = {literal: counts[i] for i, literal in enumerate(candidates) if counts[i] >= 0}
+        return assigned.value, all_lit_rew, list(all_lit_rew.keys())
@@ -14,7 +14,7 @@ import matplotlib.pyplot as plt
 
 import hashlib
 
-from ksgraph.EvalVarCalc import Node, MarchPysatPropagate
+from ksgraph.EvalVarCalc import Node, MarchPysatPropagate, MarchNativePropagate
 
 def calculate_hash(string):
     sha256_hash = hashlib.sha256()
@@ -33,7 +33,10 @@ class KSGame(Game):
         self.log_giveup_rew, self.log_giveup_rewA = [], []
         self.log_eval_var, self.log_eval_varA = [], []
 
-        self.pysat_propagate = MarchPysatPropagate(cnf=self.cnf, m=self.MAX_LITERALS)
+        if args.get('native'):
+            self.pysat_propagate = MarchNativePropagate(cnf=self.cnf, m=self.MAX_LITERALS, threads=args.get('threads') or 1)
+        else:
+            self.pysat_propagate = MarchPysatPropagate(cnf=self.cnf, m=self.MAX_LITERALS)
 
     def _make_representation(self):
         if self.args.MCTSmode in [0, 2]:
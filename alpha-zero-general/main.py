@@ -143,6 +143,9 @@ if __name__ == "__main__":
     parser.add_argument("-varpen", help="Variance penalty factor", type=float, default=0)
     parser.add_argument("-nMCTSEndOfG", help="MCTS end of game criteria (n cutoff)", type=int, default=-1)
 
+    parser.add_argument("-native", action="store_true", help="use march's native lookahead reward engine (march/libmarch.so)")
+    parser.add_argument("-threads", help="threads for the native reward engine", type=int, default=1)
+
     parser.add_argument("-prod", action="store_true", help="production mode") 
 
     args_parsed = parser.parse_args()
@@ -0,0 +1,222 @@
+/*------------------------------------------------------------------------*/
+
+// Benchmarks a canonicity kernel on a corpus of subgraphs recorded with
+// 'cadical-ks --order n --prefix-out <file>' (one subgraph per line: its
+// order and its edge variables as '0'/'1').  Every subgraph is checked
+// '--repeat' times and the time per check is reported as percentiles per
+// order, so that changes of the kernel can be compared without the noise
+// of a SAT search, whose path changes with every change of the kernel.
+//
+// The binary is built once per solver ('bench_canon_cadical', ...).  With
+// '--verdicts <file>' the verdict of every check is written, including the
+// witness of each noncanonical subgraph, so that the kernels can be
+// compared with 'cmp' (see 'make check').
+
+/*------------------------------------------------------------------------*/
+
+#include "canon.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static void error (const char *fmt, ...) {
+  va_list ap;
+  va_start (ap, fmt);
+  fputs ("bench_canon: error: ", stderr);
+  vfprintf (stderr, fmt, ap);
+  va_end (ap);
+  fputc ('\n', stderr);
+  exit (1);
+}
+
+struct Prefix {
+  int k;
+  string edges;
+};
+
+static vector<Prefix> corpus;
+
+static void read_corpus (const char *path) {
+  FILE *file = fopen (path, "r");
+  if (!file)
+    error ("can not read '%s'", path);
+  char line[1 << 12];
+  long lineno = 0;
+  while (fgets (line, sizeof line, file)) {
+    lineno++;
+    Prefix prefix;
+    char edges[sizeof line];
+    if (sscanf (line, "%d %s", &prefix.k, edges) != 2 || prefix.k < 2 ||
+        prefix.k > 30 || (int) strlen (edges) != prefix.k * (prefix.k - 1) / 2)
+      error ("invalid subgraph in '%s' line %ld", path, lineno);
+    prefix.edges = edges;
+    corpus.push_back (prefix);
+  }
+  fclose (file);
+}
+
+/*------------------------------------------------------------------------*/
+
+static double nanoseconds () {
+  return chrono::duration_cast<chrono::nanoseconds> (
+             chrono::steady_clock::now ().time_since_epoch ())
+      .count ();
+}
+
+static double percentile (const vector<double> &sorted, double p) {
+  if (sorted.empty ())
+    return 0;
+  size_t rank = p * sorted.size ();
+  if (rank >= sorted.size ())
+    rank = sorted.size () - 1;
+  return sorted[rank];
+}
+
+// One row of the report: the checks of one order with one verdict.
+
+static void report (FILE *json, const char *what, int k,
+                    vector<double> &times) {
+  if (times.empty ())
+    return;
+  sort (times.begin (), times.end ());
+  double total = 0;
+  for (double t : times)
+    total += t;
+  printf ("%-12s %5d %9zu %10.0f %10.0f %10.0f %10.0f %12.0f\n", what, k,
+          times.size (), percentile (times, 0.5), percentile (times, 0.9),
+          percentile (times, 0.99), times.back (), total / times.size ());
+  static const char *separator = "";
+  if (json)
+    fprintf (json,
+             "%s\n    {\"check\": \"%s\", \"order\": %d, \"count\": %zu, "
+             "\"p50_ns\": %.0f, \"p90_ns\": %.0f, \"p99_ns\": %.0f, "
+             "\"max_ns\": %.0f, \"mean_ns\": %.1f}",
+             separator, what, k, times.size (), percentile (times, 0.5),
+             percentile (times, 0.9), percentile (times, 0.99),
+             times.back (), total / times.size ());
+  separator = ",";
+}
+
+static void usage () {
+  printf ("usage: bench_canon_<kernel> [ <option> ... ] <corpus> ...\n"
+          "\n"
+          "  --repeat <n>       check every subgraph n times (default 3)\n"
+          "  --pseudo           the pseudo-test of the solvers (default: "
+          "exact)\n"
+          "  --mus              also time the 17 unembeddable subgraph "
+          "checks\n"
+          "  --verdicts <file>  write the verdicts and witnesses\n"
+          "  --json <file>      write the percentiles as JSON\n");
+}
+
+int main (int argc, char **argv) {
+  int repeat = 3;
+  bool pseudo = false, mus = false;
+  const char *verdicts_path = 0, *json_path = 0;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp (argv[i], "-h") || !strcmp (argv[i], "--help"))
+      return usage (), 0;
+    else if (!strcmp (argv[i], "--repeat") && i + 1 < argc)
+      repeat = atoi (argv[++i]);
+    else if (!strcmp (argv[i], "--pseudo"))
+      pseudo = true;
+    else if (!strcmp (argv[i], "--mus"))
+      mus = true;
+    else if (!strcmp (argv[i], "--verdicts") && i + 1 < argc)
+      verdicts_path = argv[++i];
+    else if (!strcmp (argv[i], "--json") && i + 1 < argc)
+      json_path = argv[++i];
+    else if (argv[i][0] == '-')
+      error ("invalid option '%s' (try '-h')", argv[i]);
+    else
+      read_corpus (argv[i]);
+  }
+  if (corpus.empty ())
+    error ("no subgraphs (try '-h')");
+  if (repeat < 1)
+    error ("invalid '--repeat %d'", repeat);
+
+  int max_order = 0;
+  for (const auto &prefix : corpus)
+    max_order = max (max_order, prefix.k);
+  Kernel *kernel = new_kernel (max_order, pseudo);
+  if (mus && !kernel->mus_graphs ())
+    error ("the %s kernel has no unembeddable subgraph check",
+           kernel_name ());
+
+  FILE *verdicts = verdicts_path ? fopen (verdicts_path, "w") : 0;
+  if (verdicts_path && !verdicts)
+    error ("can not write '%s'", verdicts_path);
+  FILE *json = json_path ? fopen (json_path, "w") : 0;
+  if (json_path && !json)
+    error ("can not write '%s'", json_path);
+
+  // Canonical and noncanonical checks of each order, and MUS checks.
+  //
+  vector<vector<double>> canonical (max_order + 1),
+      noncanonical (max_order + 1), unembeddable (max_order + 1);
+  Witness witness;
+  vector<int> P;
+  for (const auto &prefix : corpus) {
+    const int k = prefix.k;
+    kernel->load (k, prefix.edges);
+    bool result = false;
+    const double start = nanoseconds ();
+    for (int r = 0; r < repeat; r++)
+      result = kernel->canonical (k, witness);
+    const double time = (nanoseconds () - start) / repeat;
+    (result ? canonical : noncanonical)[k].push_back (time);
+    if (verdicts) {
+      fprintf (verdicts, "%d %d", k, result);
+      if (!result) {
+        fprintf (verdicts, " %d %d %d :", witness.x, witness.y, witness.mi);
+        for (int j = 0; j <= witness.mi && j < (int) witness.p.size (); j++)
+          fprintf (verdicts, " %d", witness.p[j]);
+      }
+    }
+    if (mus && k >= 10) {
+      for (int g = 0; g < kernel->mus_graphs (); g++) {
+        bool found = false;
+        const double start = nanoseconds ();
+        for (int r = 0; r < repeat; r++)
+          found = kernel->has_mus (k, g, P);
+        unembeddable[k].push_back ((nanoseconds () - start) / repeat);
+        if (verdicts && found) {
+          fprintf (verdicts, " | mus %d :", g);
+          for (int v : P)
+            fprintf (verdicts, " %d", v);
+        }
+      }
+    }
+    if (verdicts)
+      fputc ('\n', verdicts);
+  }
+
+  printf ("c %s kernel, %zu subgraphs, %d repetitions, %s test\n",
+          kernel_name (), corpus.size (), repeat, pseudo ? "pseudo" : "exact");
+  printf ("%-12s %5s %9s %10s %10s %10s %10s %12s\n", "check", "order",
+          "count", "p50 ns", "p90 ns", "p99 ns", "max ns", "mean ns");
+  if (json)
+    fprintf (json, "{\"kernel\": \"%s\", \"pseudo\": %s, \"results\": [",
+             kernel_name (), pseudo ? "true" : "false");
+  for (int k = 0; k <= max_order; k++) {
+    report (json, "canonical", k, canonical[k]);
+    report (json, "noncanonical", k, noncanonical[k]);
+    report (json, "mus", k, unembeddable[k]);
+  }
+  if (json) {
+    fputs ("\n]}\n", json);
+    fclose (json);
+  }
+  if (verdicts)
+    fclose (verdicts);
+  return 0;
+}
@@ -0,0 +1,49 @@
+#ifndef _canon_hpp_INCLUDED
+#define _canon_hpp_INCLUDED
+
+#include <string>
+#include <vector>
+
+// The canonicity check of one of the solvers, run on a recorded subgraph
+// instead of the assignment of a solver.  Subgraphs are given as in the
+// corpus: the edge variables of a graph of order 'k' as '0'/'1', where the
+// edge between vertices i < j is variable j*(j-1)/2+i+1 (column-wise, the
+// layout of cadical-ks and maplesat-ks).  The SMS encodings number the
+// edges row-wise, so 'canon_sms.cpp' fills the adjacency matrix of SMS
+// from this layout.
+
+struct Witness {
+  int x, y, mi;          // first entry where p(M) < M, last defined p[]
+  std::vector<int> p;    // the permutation (p[0..mi])
+};
+
+class Kernel {
+public:
+  virtual ~Kernel () {}
+
+  // Sets the subgraph of the next calls, outside of the timed part.
+  //
+  virtual void load (int k, const std::string &edges) = 0;
+
+  // True if the loaded subgraph is canonical, and otherwise the witness
+  // of its noncanonicity if the kernel has one.
+  //
+  virtual bool canonical (int k, Witness &) = 0;
+
+  // Whether the loaded subgraph contains the 'g'th minimal unembeddable
+  // subgraph (of 'mus_graphs'), and then its embedding 'P' (vertex of the
+  // subgraph to vertex of the MUS, -1 if not part of it).
+  //
+  virtual int mus_graphs () const { return 0; }
+  virtual bool has_mus (int k, int g, std::vector<int> &P) {
+    (void) k, (void) g, (void) P;
+    return false;
+  }
+};
+
+// One kernel per binary, since the solvers define the same globals.
+//
+const char *kernel_name ();
+Kernel *new_kernel (int max_order, bool pseudo);
+
+#endif
@@ -0,0 +1,46 @@
+#include "canon.hpp"
+
+#include "cadical.hpp"
+#include "symbreak.hpp"
+
+// The kernel of 'cadical-ks', fed through the propagator interface: every
+// subgraph is one decision level of assignments on an idle solver.
+
+class CadicalKernel : public Kernel {
+  CaDiCaL::Solver solver;
+  SymmetryBreaker *breaker; // never deleted (its destructor prints statistics)
+  std::vector<int> lits;
+  bool pseudo;
+
+public:
+  CadicalKernel (int max_order, bool p) : pseudo (p) {
+    breaker = new SymmetryBreaker (&solver, max_order, 0);
+  }
+
+  void load (int k, const std::string &edges) {
+    breaker->notify_backtrack (0);
+    breaker->notify_new_decision_level ();
+    lits.clear ();
+    for (int j = 0; j < k * (k - 1) / 2; j++)
+      lits.push_back (edges[j] == '1' ? j + 1 : -(j + 1));
+    breaker->notify_assignments (lits.data (), lits.size ());
+  }
+
+  bool canonical (int k, Witness &w) {
+    w.p.resize (k);
+    return breaker->is_canonical (k, w.p.data (), w.x, w.y, w.mi, pseudo);
+  }
+
+  int mus_graphs () const { return 17; }
+  bool has_mus (int k, int g, std::vector<int> &P) {
+    int p[12];
+    P.assign (k, -1);
+    return breaker->has_mus_subgraph (k, P.data (), p, g);
+  }
+};
+
+const char *kernel_name () { return "cadical-ks"; }
+
+Kernel *new_kernel (int max_order, bool pseudo) {
+  return new CadicalKernel (max_order, pseudo);
+}
@@ -0,0 +1,46 @@
+#include "canon.hpp"
+
+#include "core/Solver.h"
+
+using namespace Minisat;
+
+// The kernel of 'maplesat-ks', which reads the assignment of the solver
+// directly.  The pseudo test is an option of the solver.
+
+class MaplesatKernel : public Kernel, public Solver {
+public:
+  MaplesatKernel (int max_order, bool pseudo) {
+    const char *option = pseudo ? "-pseudo-test" : "-no-pseudo-test";
+    int argc = 2;
+    char *argv[] = {(char *) "bench_canon", (char *) option, 0};
+    parseOptions (argc, argv);
+    // The order is only used to tell the checks of subgraphs from the
+    // check of the whole graph, which the corpus does not have.
+    n = max_order + 1;
+    while (nVars () < n * (n - 1) / 2)
+      newVar ();
+  }
+
+  void load (int k, const std::string &edges) {
+    for (int j = 0; j < k * (k - 1) / 2; j++)
+      assigns[j] = edges[j] == '1' ? l_True : l_False;
+  }
+
+  bool canonical (int k, Witness &w) {
+    w.p.resize (k);
+    return is_canonical (k, w.p.data (), w.x, w.y, w.mi);
+  }
+
+  int mus_graphs () const { return 17; }
+  bool has_mus (int k, int g, std::vector<int> &P) {
+    int p[12];
+    P.assign (k, -1);
+    return has_gub_subgraph (k, P.data (), p, g);
+  }
+};
+
+const char *kernel_name () { return "maplesat-ks"; }
+
+Kernel *new_kernel (int max_order, bool pseudo) {
+  return new MaplesatKernel (max_order, pseudo);
+}
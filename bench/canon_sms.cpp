@@ -0,0 +1,46 @@
+#include "canon.hpp"
+
+#include "minimalityCheck.hpp"
+
+// The minimality check of SMS.  It tests a different canonical form (the
+// lexicographically smallest adjacency matrix read row by row) than the
+// orderly generation of cadical-ks and maplesat-ks (the largest one read
+// column by column), so its verdicts are counted but can not be compared.
+
+class SmsKernel : public Kernel {
+  adjacency_matrix_t matrix;
+  bool pseudo;
+
+public:
+  SmsKernel (bool p) : pseudo (p) {}
+
+  void load (int k, const std::string &edges) {
+    matrix.assign (k, std::vector<truth_value_t> (k, truth_value_false));
+    for (int j = 1, v = 0; j < k; j++)
+      for (int i = 0; i < j; i++, v++)
+        if (edges[v] == '1')
+          matrix[i][j] = matrix[j][i] = truth_value_true;
+  }
+
+  bool canonical (int k, Witness &w) {
+    vertex_ordering_t ordering (k);
+    for (int i = 0; i < k; i++)
+      ordering[i] = i;
+    minimalit_check_config_t config;
+    config.initial_partition = partition_t (k, false);
+    config.cutoff = pseudo ? 20000 : 0; // the cutoff of the smsd2 mode of solve.sh
+    try {
+      checkMinimality (matrix, ordering, config);
+    } catch (minimalit_check_result_t &result) {
+      w.x = w.y = w.mi = -1;
+      w.p = result.permutation;
+      return false;
+    } catch (LimitReachedException &) {
+    }
+    return true;
+  }
+};
+
+const char *kernel_name () { return "sms"; }
+
+Kernel *new_kernel (int, bool pseudo) { return new SmsKernel (pseudo); }
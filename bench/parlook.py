@@ -0,0 +1,49 @@
+import os
+import shutil
+import subprocess
+import sys
+
+# Checks that the parallel lookahead of march_cu (-t) cubes exactly as the
+# serial lookahead: it cubes the KS instances of orders 13 and 14 to depth
+# 5 without -t and with -t 1 and -t 4, and fails unless the cube files are
+# the same byte for byte.  See 'make parlook' in bench.
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from pipeline import generate_instance
+
+ORDERS = [13, 14]
+DEPTH = 5
+THREADS = [1, 4]
+
+def cube(instance, path, threads):
+    command = [os.path.join(ROOT, "march", "march_cu"), instance, "-d", str(DEPTH), "-o", path]
+    if threads:
+        command += ["-t", str(threads)]
+    subprocess.run(command, stdout=subprocess.DEVNULL, check=False)
+    with open(path, "rb") as file:
+        return file.read()
+
+def main():
+    directory = os.path.join(ROOT, "bench", "parlook-run")
+    shutil.rmtree(directory, ignore_errors=True)
+    os.makedirs(directory)
+
+    failures = []
+    for order in ORDERS:
+        instance = os.path.join(directory, f"ks{order}.cnf")
+        generate_instance(order, instance)
+        serial = cube(instance, instance + ".cubes", 0)
+        for threads in THREADS:
+            if cube(instance, instance + f".t{threads}.cubes", threads) != serial:
+                failures.append(f"ks{order} with -t {threads}")
+        print(f"ks{order}: {len(serial.splitlines())} cubes", flush=True)
+
+    if failures:
+        print("Parallel lookahead differs from the serial one: " + ", ".join(failures))
+        return 1
+    print("Parallel lookahead: the same cubes as the serial one with -t " + " and -t ".join(map(str, THREADS)))
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
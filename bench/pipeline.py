@@ -0,0 +1,167 @@
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import time
+
+# Runs the whole pipeline of parallel-solve.py (simplify -> cube -> solve)
+# on the KS instances of small orders with a fixed configuration and
+# worker count, and compares the times of each phase with a baseline.
+# The instances are generated with the KS encoding of SMS, so nothing has
+# to be shipped, and their edge variables renumbered column by column as
+# cadical-ks and march_cu -order expect them.  With the simplification
+# budget of parallel-solve.py (10000 conflicts) the orders 13 to 15 would
+# be solved by the simplification alone, so the pipeline gives it only 100
+# conflicts: then every order is cubed and its cubes solved (1, 2 and 30
+# seconds, 4, 1 and 1 cubes, 34, 216 and 2352 solutions), and a run in
+# which an order has no cubes fails.  All solvers are deterministic, so
+# the cubes are the same in every run and only the times change.
+#
+# Run from anywhere; the pipeline runs in the root of the repository (it
+# needs cadical-ks/build/cadical-ks and march/march_cu, see 'make pipeline'
+# in bench).  Without a baseline the first run records it.
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, ROOT)
+from summary import summarize
+
+# The times compared with the baseline (process times summed over all
+# solver runs, and the wall clock time of the whole run) and the counts
+# which show whether the runs are comparable at all.
+PHASES = ["simp_time", "cubing_time", "solving_time", "wall_time"]
+COUNTS = ["nodes", "total_cubes", "cubes_generated", "leaf_cubes", "timeouted_cubes", "solutions"]
+
+def parse_orders(text):
+    orders = []
+    for part in text.split(","):
+        first, _, last = part.partition("-")
+        orders.extend(range(int(first), int(last or first) + 1))
+    return orders
+
+# The SMS encoding numbers the edge {u,v} with u < v row by row, the
+# orderly generation of cadical-ks column by column as v*(v-1)/2+u+1 (see
+# bench/canon.hpp).  All other variables keep their numbers.
+
+def column_wise(order):
+    renumber = {}
+    row = 1
+    for u in range(order):
+        for v in range(u + 1, order):
+            renumber[row] = v * (v - 1) // 2 + u + 1
+            row += 1
+    return renumber
+
+def generate_instance(order, path):
+    env = dict(os.environ, PYTHONPATH=os.path.join(ROOT, "sms"))
+    subprocess.run([sys.executable, os.path.join(ROOT, "sms", "encodings", "kochen_specker.py"),
+                    "-v", str(order), "--no-solve", "--cnf-file", path + ".sms"], env=env, check=True)
+    renumber = column_wise(order)
+    with open(path + ".sms", "r") as sms, open(path, "w") as cnf:
+        for line in sms:
+            if line[0] in "cp":
+                cnf.write(line)
+                continue
+            lits = [int(lit) for lit in line.split()]
+            cnf.write(" ".join(str(renumber.get(abs(lit), abs(lit)) * (1 if lit > 0 else -1)) if lit else "0" for lit in lits) + "\n")
+    os.remove(path + ".sms")
+
+def run_order(order, args):
+    directory = os.path.join(args.run_dir, f"ks{order}")
+    shutil.rmtree(directory, ignore_errors=True)
+    os.makedirs(directory)
+    instance = os.path.join(directory, f"ks{order}.cnf")
+    generate_instance(order, instance)
+
+    command = [sys.executable, "parallel-solve.py", str(order), os.path.relpath(instance, ROOT),
+               "-m", str(order * (order - 1) // 2), "--solving-mode", "satcas", "--cubing-mode", "march",
+               "--cutoff", "d", "--cutoffv", str(args.depth), "--simp-conflicts", str(args.simp_conflicts),
+               "--timeout", str(args.timeout), "--workers", str(args.workers)]
+    print(f"ks{order}: {' '.join(command)}", flush=True)
+    start = time.time()
+    with open(os.path.join(directory, "parallel-solve.log"), "w") as log:
+        subprocess.run(command, cwd=ROOT, stdout=log, stderr=subprocess.STDOUT, check=True)
+    wall_time = time.time() - start
+
+    summary = summarize(directory)
+    result = {phase: round(summary[phase], 3) for phase in PHASES if phase != "wall_time"}
+    result["wall_time"] = round(wall_time, 3)
+    result.update({count: summary[count] for count in COUNTS})
+    print(f"ks{order}: " + ", ".join(f"{key} {value}" for key, value in result.items()), flush=True)
+    return result
+
+# A phase regresses if it takes more than 'margin' (a fraction) longer
+# than in the baseline, plus 'slack' seconds so that the phases of the
+# small orders, which take fractions of a second, do not fail on noise.
+
+def compare(baseline, results, margin, slack):
+    failures = []
+    print(f"{'order':>5} {'phase':<16} {'baseline':>10} {'current':>10} {'change':>8}")
+    for order, result in results.items():
+        base = baseline["orders"].get(order)
+        if base is None:
+            print(f"{order:>5} not in the baseline")
+            continue
+        for count in COUNTS:
+            if base.get(count) != result[count]:
+                print(f"{order:>5} {count:<16} {base.get(count)!s:>10} {result[count]!s:>10} (runs differ)")
+        if base.get("solutions") != result["solutions"]:
+            failures.append(f"ks{order} solutions")
+        for phase in PHASES:
+            old, new = base.get(phase, 0.0), result[phase]
+            change = f"{100 * (new - old) / old:+.0f}%" if old else "-"
+            regressed = new > old * (1 + margin) + slack
+            print(f"{order:>5} {phase:<16} {old:>10.2f} {new:>10.2f} {change:>8}" + ("  REGRESSION" if regressed else ""))
+            if regressed:
+                failures.append(f"ks{order} {phase}")
+    return failures
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark the KS pipeline (simplify -> cube -> solve) of small orders against a baseline')
+    parser.add_argument('--orders', default="13-15", help='Orders to run, e.g. 13-15 or 13,15 (default: 13-15)')
+    parser.add_argument('--workers', type=int, default=4, help='Worker processes of parallel-solve.py (default: 4)')
+    parser.add_argument('--depth', type=int, default=3, help='Cubing depth (default: 3)')
+    parser.add_argument('--simp-conflicts', type=int, default=100, help='Conflicts of each simplification (default: 100, so that the orders 13 to 15 are cubed)')
+    parser.add_argument('--timeout', type=int, default=3600, help='Timeout of each cube in seconds (default: 3600)')
+    parser.add_argument('--baseline', default=os.path.join(ROOT, "bench", "pipeline-baseline.json"), help='Baseline to compare with, recorded if it does not exist')
+    parser.add_argument('--record', action='store_true', help='Overwrite the baseline with this run')
+    parser.add_argument('--margin', type=float, default=0.2, help='Allowed slowdown of a phase as a fraction (default: 0.2)')
+    parser.add_argument('--slack', type=float, default=1.0, help='Allowed slowdown of a phase in seconds on top of the margin (default: 1)')
+    parser.add_argument('--run-dir', default=os.path.join(ROOT, "bench", "pipeline-run"), help='Directory of the runs (default: bench/pipeline-run)')
+    parser.add_argument('--json', help='Write the results of this run as JSON to this file')
+    args = parser.parse_args()
+    args.run_dir = os.path.abspath(args.run_dir)
+
+    config = {"workers": args.workers, "depth": args.depth, "simp_conflicts": args.simp_conflicts, "timeout": args.timeout,
+              "solving_mode": "satcas", "cubing_mode": "march"}
+    results = {str(order): run_order(order, args) for order in parse_orders(args.orders)}
+    run = {"config": config, "orders": results}
+    uncubed = [f"ks{order}" for order, result in results.items() if result["total_cubes"] == 0]
+    if uncubed:
+        print(f"Solved by the simplification alone, so cubing and solving are not timed: {', '.join(uncubed)} (lower --simp-conflicts)")
+        return 1
+    if args.json:
+        with open(args.json, "w") as file:
+            json.dump(run, file, indent=2)
+
+    if args.record or not os.path.exists(args.baseline):
+        with open(args.baseline, "w") as file:
+            json.dump(run, file, indent=2)
+        print(f"Recorded baseline {args.baseline}")
+        return 0
+
+    with open(args.baseline, "r") as file:
+        baseline = json.load(file)
+    if baseline["config"] != config:
+        print(f"Baseline {args.baseline} was recorded with {baseline['config']}, not {config}")
+        return 1
+    failures = compare(baseline, results, args.margin, args.slack)
+    if failures:
+        print(f"Regressions: {', '.join(failures)}")
+        return 1
+    print("No regressions")
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
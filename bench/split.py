@@ -0,0 +1,68 @@
+import importlib.util
+import json
+import os
+import queue
+import shutil
+import sys
+
+# Checks the split of a cube which parallel-solve.py --predict-split
+# predicts to be hard: it runs solve.sh -cas on the KS instance of order 16
+# (which takes minutes) through run_command of parallel-solve.py with a
+# timeout of 10 seconds, so the first status snapshot after --predict-split
+# seconds stops cadical-ks.  The solver has to stop as on its own timeout,
+# that is leave its checkpoint, the --stats-json summary and a final
+# status, and the cube has to be queued again, starting from the
+# checkpoint.  See 'make split' in bench.
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from pipeline import generate_instance
+
+ORDER = 16
+
+def load_parallel_solve():
+    spec = importlib.util.spec_from_file_location("parallel_solve", os.path.join(ROOT, "parallel-solve.py"))
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module
+
+def main():
+    directory = os.path.join(ROOT, "bench", "split-run")
+    shutil.rmtree(directory, ignore_errors=True)
+    os.makedirs(directory)
+    instance = os.path.relpath(os.path.join(directory, f"ks{ORDER}.cnf"), ROOT)
+    generate_instance(ORDER, os.path.join(ROOT, instance))
+
+    solver = load_parallel_solve()
+    solver.predict_split_g, solver.timeout_g, solver.solving_mode_g = 1, 10, "satcas"
+    solver.mg, solver.orderg, solver.numMCTSg = ORDER * (ORDER - 1) // 2, ORDER, 2
+    solver.cutoffg, solver.cutoffvg, solver.dg = "d", 3, 0
+    solver.queue = queue.Queue()
+
+    os.chdir(ROOT)
+    solver.run_command(f"./solve.sh {ORDER} -cadical 3600 -cas {instance}")
+
+    failures = []
+    for suffix in [".ckpt", ".log.json", ".status"]:
+        if not os.path.exists(instance + suffix):
+            failures.append(f"no {instance}{suffix}")
+    if not failures:
+        with open(instance + ".status", "r") as file:
+            if not json.load(file).get("done"):
+                failures.append("status not done")
+        with open(instance + ".log.json", "r") as file:
+            result = json.load(file).get("result")
+            if result != "UNKNOWN":
+                failures.append(f"result {result} instead of UNKNOWN")
+    queued = solver.queue.get() if not solver.queue.empty() else ""
+    if f"'{instance}.ckpt'" not in queued:
+        failures.append(f"cube not queued again from its checkpoint: {queued!r}")
+
+    if failures:
+        print("Split failed: " + ", ".join(failures))
+        return 1
+    print(f"Split ks{ORDER}: checkpoint, summary and status written, cube queued again from {instance}.ckpt")
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
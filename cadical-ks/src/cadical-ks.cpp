@@ -14,6 +14,7 @@
 
 #include "symbreak.hpp"
 #include "exhaustive.hpp"
+#include "checkpoint.hpp"
 
 /*------------------------------------------------------------------------*/
 
@@ -64,6 +65,8 @@ class App : public Handler, public Terminator {
   //
   void print_usage (bool all = false);
   void print_witness (FILE *);
+  void write_stats_json (const char *path, const char *input, int res,
+                         int order, const std::string &propagator);
 
 #ifndef QUIET
   void signal_message (const char *msg, int sig);
@@ -300,6 +303,72 @@ bool App::set (const char *arg) { return solver->set_long_option (arg); }
 
 /*------------------------------------------------------------------------*/
 
+// Distinct variables of witnesses on the extension stack, as the scripts
+// used to count from the file of '-e' ('sed' on the last literal).
+
+struct EliminatedCounter : public WitnessIterator {
+  std::set<int> vars;
+  bool witness (const vector<int> &, const vector<int> &w, uint64_t) {
+    if (!w.empty ())
+      vars.insert (abs (w.back ()));
+    return true;
+  }
+};
+
+// Summary of the run for scripts, instead of scraping the log (see
+// '--stats-json' and 'summary.py').  With '--order' the edge variables
+// are the first 'order * (order - 1) / 2' variables.
+
+void App::write_stats_json (const char *path, const char *input, int res,
+                            int order, const std::string &propagator) {
+  FILE *file = fopen (path, "w");
+  if (!file) {
+    solver->error ("can not write statistics to '%s'", path);
+    return;
+  }
+  Internal *internal = solver->internal;
+  EliminatedCounter counter;
+  solver->traverse_witnesses_backward (counter);
+  fputs ("{\n  \"solver\": \"cadical-ks\",\n", file);
+  fputs ("  \"input\": \"", file);
+  for (const char *p = input ? input : "<stdin>"; *p; p++) {
+    if (*p == '"' || *p == '\\')
+      fputc ('\\', file);
+    fputc (*p, file);
+  }
+  fputs ("\",\n", file);
+  fprintf (file, "  \"result\": \"%s\",\n",
+           res == 10   ? "SATISFIABLE"
+           : res == 20 ? "UNSATISFIABLE"
+                       : "UNKNOWN");
+  fprintf (file, "  \"exit\": %d,\n", res);
+  fprintf (file, "  \"process_time\": %.3f,\n",
+           internal->process_time ());
+  fprintf (file, "  \"real_time\": %.3f,\n", internal->real_time ());
+  fprintf (file, "  \"conflicts\": %" PRId64 ",\n",
+           internal->stats.conflicts);
+  fprintf (file, "  \"decisions\": %" PRId64 ",\n",
+           internal->stats.decisions);
+  fprintf (file, "  \"propagations\": %" PRId64 ",\n",
+           internal->stats.propagations.search);
+  fprintf (file, "  \"variables\": %d,\n", max_var);
+  fprintf (file, "  \"eliminated_variables\": %zu", counter.vars.size ());
+  if (order) {
+    const int edges = order * (order - 1) / 2;
+    fprintf (file, ",\n  \"order\": %d,\n", order);
+    fprintf (file, "  \"eliminated_edge_variables\": %zu",
+             (size_t) std::distance (counter.vars.begin (),
+                                     counter.vars.upper_bound (edges)));
+  }
+  if (!propagator.empty ())
+    fprintf (file, ",\n  %s", propagator.c_str ());
+  fputs ("\n}\n", file);
+  if (fclose (file))
+    solver->error ("writing statistics to '%s' failed", path);
+}
+
+/*------------------------------------------------------------------------*/
+
 bool App::most_likely_existing_cnf_file (const char *path) {
   if (!File::exists (path))
     return false;
@@ -385,6 +454,12 @@ int App::main (int argc, char **argv) {
   bool dimacs_specified = false;
   int optimize = 0, preprocessing = 0, localsearch = 0;
   const char *output_path = 0, *extension_path = 0;
+  const char *checkpoint_path = 0, *warm_path = 0;
+  const char *latency_path = 0, *stats_json_path = 0, *prefix_path = 0;
+  const char *record_path = 0, *replay_path = 0, *sample_path = 0;
+  const char *status_path = 0;
+  std::string propagator_stats;
+  int latency_interval = 0, sample_frequency = 100, status_interval = 5;
   int conflict_limit = -1, decision_limit = -1, proofsize_limit = -1;
   const char *conflict_limit_specified = 0;
   const char *proofsize_limit_specified = 0;
@@ -507,6 +582,23 @@ int App::main (int argc, char **argv) {
         APPERR ("invalid decision limit");
       else
         decision_limit_specified = argv[i];
+    } else if (!strcmp (argv[i], "--checkpoint")) {
+      if (++i == argc)
+        APPERR ("argument to '--checkpoint' missing");
+      else if (checkpoint_path)
+        APPERR ("multiple checkpoint options '--checkpoint %s' and "
+                "'--checkpoint %s'",
+                checkpoint_path, argv[i]);
+      else
+        checkpoint_path = argv[i];
+    } else if (!strcmp (argv[i], "--warm")) {
+      if (++i == argc)
+        APPERR ("argument to '--warm' missing");
+      else if (warm_path)
+        APPERR ("multiple warm start options '--warm %s' and '--warm %s'",
+                warm_path, argv[i]);
+      else
+        warm_path = argv[i];
     } else if (!strcmp (argv[i], "--order")) {
       if (++i == argc)
         APPERR ("argument to '--order' missing");
@@ -546,6 +638,101 @@ int App::main (int argc, char **argv) {
         if (solver->permoutfile == NULL)
           std::cout << "c could not open " << argv[i] << std::endl, exit(1);
       }
+    } else if (!strcmp (argv[i], "--latency")) {
+      if (++i == argc)
+        APPERR ("argument to '--latency' missing");
+      else if (latency_path)
+        APPERR ("multiple latency options '--latency %s' and "
+                "'--latency %s'",
+                latency_path, argv[i]);
+      else if (!File::writable (argv[i]))
+        APPERR ("latency file '%s' not writable", argv[i]);
+      else
+        latency_path = argv[i];
+    } else if (!strcmp (argv[i], "--status")) {
+      if (++i == argc)
+        APPERR ("argument to '--status' missing");
+      else if (status_path)
+        APPERR ("multiple status options '--status %s' and "
+                "'--status %s'",
+                status_path, argv[i]);
+      else if (!File::writable (argv[i]))
+        APPERR ("status file '%s' not writable", argv[i]);
+      else
+        status_path = argv[i];
+    } else if (!strcmp (argv[i], "--status-interval")) {
+      if (++i == argc)
+        APPERR ("argument to '--status-interval' missing");
+      else if (!parse_int_str (argv[i], status_interval) ||
+               status_interval <= 0)
+        APPERR ("invalid argument in '--status-interval %s'", argv[i]);
+    } else if (!strcmp (argv[i], "--sample")) {
+      if (++i == argc)
+        APPERR ("argument to '--sample' missing");
+      else if (sample_path)
+        APPERR ("multiple sample options '--sample %s' and "
+                "'--sample %s'",
+                sample_path, argv[i]);
+      else if (!File::writable (argv[i]))
+        APPERR ("sample file '%s' not writable", argv[i]);
+      else
+        sample_path = argv[i];
+    } else if (!strcmp (argv[i], "--sample-frequency")) {
+      if (++i == argc)
+        APPERR ("argument to '--sample-frequency' missing");
+      else if (!parse_int_str (argv[i], sample_frequency) ||
+               sample_frequency <= 0 || sample_frequency > 100000)
+        APPERR ("invalid argument in '--sample-frequency %s'", argv[i]);
+    } else if (!strcmp (argv[i], "--prefix-out")) {
+      if (++i == argc)
+        APPERR ("argument to '--prefix-out' missing");
+      else if (prefix_path)
+        APPERR ("multiple prefix options '--prefix-out %s' and "
+                "'--prefix-out %s'",
+                prefix_path, argv[i]);
+      else if (!File::writable (argv[i]))
+        APPERR ("prefix file '%s' not writable", argv[i]);
+      else
+        prefix_path = argv[i];
+    } else if (!strcmp (argv[i], "--prop-record")) {
+      if (++i == argc)
+        APPERR ("argument to '--prop-record' missing");
+      else if (record_path)
+        APPERR ("multiple trace options '--prop-record %s' and "
+                "'--prop-record %s'",
+                record_path, argv[i]);
+      else if (!File::writable (argv[i]))
+        APPERR ("trace file '%s' not writable", argv[i]);
+      else
+        record_path = argv[i];
+    } else if (!strcmp (argv[i], "--prop-replay")) {
+      if (++i == argc)
+        APPERR ("argument to '--prop-replay' missing");
+      else if (replay_path)
+        APPERR ("multiple trace options '--prop-replay %s' and "
+                "'--prop-replay %s'",
+                replay_path, argv[i]);
+      else if (!File::exists (argv[i]))
+        APPERR ("trace file '%s' does not exist", argv[i]);
+      else
+        replay_path = argv[i];
+    } else if (!strcmp (argv[i], "--stats-json")) {
+      if (++i == argc)
+        APPERR ("argument to '--stats-json' missing");
+      else if (stats_json_path)
+        APPERR ("multiple statistics options '--stats-json %s' and "
+                "'--stats-json %s'",
+                stats_json_path, argv[i]);
+      else if (!File::writable (argv[i]))
+        APPERR ("statistics file '%s' not writable", argv[i]);
+      else
+        stats_json_path = argv[i];
+    } else if (!strcmp (argv[i], "--latency-interval")) {
+      if (++i == argc)
+        APPERR ("argument to '--latency-interval' missing");
+      else if (!parse_int_str (argv[i], latency_interval) ||
+               latency_interval < 0)
+        APPERR ("invalid argument in '--latency-interval %s'", argv[i]);
     }
 #ifndef __WIN32
     else if (!strcmp (argv[i], "-t")) {
@@ -640,6 +827,24 @@ int App::main (int argc, char **argv) {
       !strcmp (dimacs_path, proof_path) && strcmp (dimacs_path, "-"))
     APPERR ("DIMACS input file '%s' also specified as DRAT proof file",
             dimacs_path);
+  if (warm_path && !File::exists (warm_path))
+    APPERR ("checkpoint file '%s' does not exist", warm_path);
+  if (warm_path && solver->proof_specified)
+    APPERR ("learned clauses of '--warm %s' are not in the DRAT proof",
+            warm_path);
+  if (latency_path && !order)
+    APPERR ("'--latency %s' requires '--order'", latency_path);
+  if (prefix_path && !order)
+    APPERR ("'--prefix-out %s' requires '--order'", prefix_path);
+  if (status_path && !order)
+    APPERR ("'--status %s' requires '--order'", status_path);
+  if ((record_path || replay_path) && !order)
+    APPERR ("'--prop-%s %s' requires '--order'",
+            record_path ? "record" : "replay",
+            record_path ? record_path : replay_path);
+  if (record_path && replay_path)
+    APPERR ("can not use '--prop-record %s' and '--prop-replay %s' together",
+            record_path, replay_path);
 
   /*----------------------------------------------------------------------*/
   // The '--less' option is not fully functional yet (it is also not
@@ -724,6 +929,13 @@ int App::main (int argc, char **argv) {
       assert (succeeded), (void) succeeded;
     }
   }
+#ifndef __WIN32
+  // 'SIGUSR2' stops the search as if the time limit was reached, such that
+  // the checkpoint, statistics and status are still written (used by
+  // 'parallel-solve.py' to split cubes which are predicted to be hard).
+  Signal::stop ();
+  solver->connect_terminator (this);
+#endif
   if (verbose () || solver->proof_specified)
     solver->section ("proof tracing");
   if (solver->proof_specified) {
@@ -769,6 +981,8 @@ int App::main (int argc, char **argv) {
                                cube_literals);
   if (err)
     APPERR ("%s", err);
+  if (incremental && (record_path || replay_path))
+    APPERR ("can not record or replay the propagator on cubes");
   if (read_solution_path) {
     solver->section ("parsing solution");
     solver->message ("reading solution file from '%s'", read_solution_path);
@@ -776,6 +990,19 @@ int App::main (int argc, char **argv) {
       APPERR ("%s", err);
   }
 
+  // The learned clauses of a checkpoint are added as original clauses.
+
+  Checkpoint warm;
+  if (warm_path) {
+    solver->section ("warm start");
+    if ((err = warm.read (warm_path)))
+      APPERR ("%s in '%s'", err, warm_path);
+    solver->message ("restoring %zu units and %zu learned literals from "
+                     "checkpoint '%s'",
+                     warm.units.size (), warm.learned.size (), warm_path);
+    warm.restore (solver);
+  }
+
   solver->section ("options");
   if (optimize > 0) {
     solver->optimize (optimize);
@@ -784,6 +1011,16 @@ int App::main (int argc, char **argv) {
   solver->options ();
 
   int res = 0;
+  Checkpoint checkpoint;
+
+  if (sample_path) {
+    if (!CaDiCaL::Sampler::start (solver->internal, sample_path,
+                                  sample_frequency))
+      APPERR ("can not sample to '%s'", sample_path);
+    solver->message ("sampling %d times per second to %s'%s'%s",
+                     sample_frequency, tout.green_code (), sample_path,
+                     tout.normal_code ());
+  }
 
   if (incremental) {
     bool reporting = get ("report") > 1 || get ("verbose") > 0;
@@ -923,14 +1160,61 @@ int App::main (int argc, char **argv) {
       }
     } else if (order > 0) {
       SymmetryBreaker se(solver, order, unembeddable_check);
+      if (warm_path)
+        se.load (warm);
+      if (latency_path)
+        se.record_latency (latency_path, latency_interval);
+      if (status_path)
+        se.record_progress (new CaDiCaL::Progress (
+            solver->internal, status_path, status_interval, order));
+      FILE *prefix_file = prefix_path ? fopen (prefix_path, "w") : 0;
+      se.record_prefixes (prefix_file);
+      if (record_path)
+        se.record_trace (fopen (record_path, "wb"));
       max_var = solver->active ();
-      res = solver->solve ();
+      if (replay_path) {
+        // Times the propagator on the recorded calls without solving.
+        FILE *replay_file = fopen (replay_path, "rb");
+        if (!replay_file)
+          APPERR ("can not read trace file '%s'", replay_path);
+        CaDiCaL::PropagatorReplay replay;
+        const bool ok = se.replay_trace (replay_file, replay);
+        fclose (replay_file);
+        replay.print (stdout);
+        fflush (stdout);
+        if (!ok)
+          APPERR ("replay of '%s' failed", replay_path);
+      } else
+        res = solver->solve ();
+      if (!res && checkpoint_path)
+        se.save (checkpoint);
+      if (stats_json_path)
+        propagator_stats = se.stats_json ();
+      if (prefix_file)
+        fclose (prefix_file);
     } else {
       max_var = solver->active ();
       res = solver->solve ();
     }
   }
 
+  CaDiCaL::Sampler::stop ();
+
+  // Only a solver that ran out of time or hit a limit leaves a checkpoint
+  // for the solvers of its subproblems (see '--warm').
+
+  if (!res && checkpoint_path) {
+    solver->section ("writing checkpoint");
+    checkpoint.capture (solver);
+    solver->message ("writing %zu units and %zu learned literals to "
+                     "checkpoint %s'%s'%s",
+                     checkpoint.units.size (), checkpoint.learned.size (),
+                     tout.green_code (), checkpoint_path,
+                     tout.normal_code ());
+    if ((err = checkpoint.write (checkpoint_path)))
+      APPERR ("%s '%s'", err, checkpoint_path);
+  }
+
   if (solver->proof_specified) {
     solver->section ("closing proof");
     solver->close_proof_trace (!get ("quiet"));
@@ -979,6 +1263,9 @@ int App::main (int argc, char **argv) {
     fclose (write_result_file);
   solver->statistics ();
   solver->resources ();
+  if (stats_json_path)
+    write_stats_json (stats_json_path, dimacs_path, res, order,
+                      propagator_stats);
   solver->section ("shutting down");
   solver->message ("exit %d", res);
   if (less_pipe) {
@@ -1060,6 +1347,8 @@ void App::catch_signal (int sig) {
 #else
   (void) sig;
 #endif
+  // Interrupted runs still leave their samples.
+  CaDiCaL::Sampler::write ();
 }
 
 void App::catch_alarm () {
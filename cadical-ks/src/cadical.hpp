@@ -196,6 +196,7 @@ enum State {
 
 // Opaque classes needed in the API and declared in the same namespace.
 
+class Checkpoint;
 class File;
 struct Internal;
 struct External;
@@ -986,6 +987,7 @@ private:
   friend class App;
   friend class Mobical;
   friend class Parser;
+  friend class Checkpoint; // Reads and restores saved phases.
 
   // Read solution in competition format for debugging and testing.
   //
@@ -1123,6 +1125,16 @@ public:
   // to an assignment.
   //
   virtual void notify_assignment (int lit, bool is_fixed) = 0;
+
+  // The assignments which are not fixed are notified in batches, in trail
+  // order, with one call for all the new assignments since the last one.
+  // The literals are only valid during the call.  By default each is
+  // passed on to 'notify_assignment'.
+  //
+  virtual void notify_assignments (const int *lits, size_t size) {
+    for (size_t i = 0; i < size; i++)
+      notify_assignment (lits[i], false);
+  }
   virtual void notify_new_decision_level () = 0;
   virtual void notify_backtrack (size_t new_level) = 0;
 
@@ -0,0 +1,155 @@
+#include "internal.hpp"
+#include "checkpoint.hpp"
+
+namespace CaDiCaL {
+
+static const int checkpoint_magic = 0x504b4343; // 'CCKP'
+
+void Checkpoint::capture (Solver *solver, int max_size) {
+  Internal *internal = solver->internal;
+  External *external = solver->external;
+
+  max_var = external->max_var;
+  units.clear ();
+  learned.clear ();
+  phases.assign (max_var + 1, 0);
+  if (internal->unsat)
+    return;
+
+  for (int idx = 1; idx <= max_var; idx++) {
+    const int tmp = external->fixed (idx);
+    if (tmp) {
+      units.push_back (tmp < 0 ? -idx : idx);
+      continue;
+    }
+    const int ilit = external->e2i[idx];
+    if (!ilit)
+      continue;
+    const signed char phase = internal->phases.saved[abs (ilit)];
+    phases[idx] = ilit < 0 ? -phase : phase;
+  }
+
+  // Root-level satisfied clauses are skipped and falsified literals
+  // removed, which can only make a clause shorter.
+
+  for (const auto &c : internal->clauses) {
+    if (c->garbage || !c->redundant)
+      continue;
+    const size_t before = learned.size ();
+    bool satisfied = false;
+    for (const auto &lit : *c) {
+      const int tmp = internal->fixed (lit);
+      if (tmp > 0) {
+        satisfied = true;
+        break;
+      }
+      if (!tmp)
+        learned.push_back (internal->externalize (lit));
+    }
+    const size_t size = learned.size () - before;
+    if (satisfied || !size || size > (size_t) max_size)
+      learned.resize (before);
+    else
+      learned.push_back (0);
+  }
+}
+
+void Checkpoint::restore (Solver *solver) const {
+  for (const auto &lit : units)
+    solver->add (lit), solver->add (0);
+  for (const auto &lit : learned)
+    solver->add (lit);
+
+  // The saved phases of variables the solver knows about.
+
+  Internal *internal = solver->internal;
+  External *external = solver->external;
+  const int vars = min (max_var, external->max_var);
+  for (int idx = 1; idx <= vars; idx++) {
+    const signed char phase = phases[idx];
+    const int ilit = external->e2i[idx];
+    if (!phase || !ilit)
+      continue;
+    internal->phases.saved[abs (ilit)] = ilit < 0 ? -phase : phase;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+
+const char *Checkpoint::write (const char *path) const {
+  FILE *file = fopen (path, "wb");
+  if (!file)
+    return "can not write checkpoint";
+  const int header[6] = {checkpoint_magic,
+                         max_var,
+                         (int) units.size (),
+                         (int) learned.size (),
+                         (int) phases.size (),
+                         (int) hashes.size ()};
+  bool ok = fwrite (header, sizeof header, 1, file) == 1;
+  ok = ok && fwrite (units.data (), sizeof (int), units.size (), file) ==
+                 units.size ();
+  ok = ok && fwrite (learned.data (), sizeof (int), learned.size (),
+                     file) == learned.size ();
+  ok = ok && fwrite (phases.data (), 1, phases.size (), file) ==
+                 phases.size ();
+  for (const auto &set : hashes) {
+    const int size = set.size ();
+    ok = ok && fwrite (&size, sizeof size, 1, file) == 1;
+    ok = ok && fwrite (set.data (), sizeof (uint64_t), set.size (),
+                       file) == set.size ();
+  }
+  if (fclose (file))
+    ok = false;
+  return ok ? 0 : "writing checkpoint failed";
+}
+
+const char *Checkpoint::read (const char *path) {
+  FILE *file = fopen (path, "rb");
+  if (!file)
+    return "can not read checkpoint";
+  int header[6];
+  const char *res = 0;
+  if (fread (header, sizeof header, 1, file) != 1 ||
+      header[0] != checkpoint_magic || header[1] < 0 || header[2] < 0 ||
+      header[3] < 0 || header[4] != header[1] + 1 || header[5] < 0)
+    res = "invalid checkpoint header";
+  else {
+    max_var = header[1];
+    units.resize (header[2]);
+    learned.resize (header[3]);
+    phases.resize (header[4]);
+    hashes.resize (header[5]);
+    if (fread (units.data (), sizeof (int), units.size (), file) !=
+            units.size () ||
+        fread (learned.data (), sizeof (int), learned.size (), file) !=
+            learned.size () ||
+        fread (phases.data (), 1, phases.size (), file) != phases.size ())
+      res = "truncated checkpoint";
+    for (auto &set : hashes) {
+      int size;
+      if (res || fread (&size, sizeof size, 1, file) != 1 || size < 0) {
+        res = "truncated checkpoint";
+        break;
+      }
+      set.resize (size);
+      if (fread (set.data (), sizeof (uint64_t), size, file) !=
+          (size_t) size) {
+        res = "truncated checkpoint";
+        break;
+      }
+    }
+    if (!res && !learned.empty () && learned.back ())
+      res = "invalid learned clauses in checkpoint";
+    for (const auto &lit : units)
+      if (!res && (!lit || abs (lit) > max_var))
+        res = "invalid unit in checkpoint";
+    for (const auto &lit : learned)
+      if (!res && abs (lit) > max_var)
+        res = "invalid learned clauses in checkpoint";
+  }
+  fclose (file);
+  return res;
+}
+
+} // namespace CaDiCaL
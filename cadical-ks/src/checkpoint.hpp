@@ -0,0 +1,52 @@
+#ifndef _checkpoint_hpp_INCLUDED
+#define _checkpoint_hpp_INCLUDED
+
+#include <cstdint>
+#include <vector>
+
+namespace CaDiCaL {
+
+class Solver;
+
+// What a solver that ran out of time has learned about its formula, so
+// that the solvers of its subproblems (the formula together with a cube)
+// can start from there instead of from scratch: the root-level units, the
+// short learned clauses (all implied by the formula, and by the clauses
+// the orderly generation propagator added), and the saved phases.  The
+// irredundant clauses are not part of it since every subproblem contains
+// them anyway.  Propagators can store their own caches in 'hashes' (see
+// 'SymmetryBreaker::save').
+//
+// The checkpoint file is binary: a header of six 32-bit integers (magic,
+// maximum variable, units, learned literals, phases and hash sets),
+// followed by the units, the zero-terminated learned clauses, one phase
+// byte per variable, and the hash sets, each as its size followed by its
+// 64-bit hashes.
+
+class Checkpoint {
+public:
+  int max_var = 0;
+  std::vector<int> units;
+  std::vector<int> learned;
+  std::vector<signed char> phases; // indexed by variable, 0 if unknown
+  std::vector<std::vector<uint64_t>> hashes;
+
+  // Fill in from a solver after 'solve' returned without result.  Only
+  // learned clauses with at most 'max_size' literals are kept.
+  //
+  void capture (Solver *solver, int max_size = 8);
+
+  // Add the units and learned clauses to a solver which already has its
+  // formula, and set its saved phases.
+  //
+  void restore (Solver *solver) const;
+
+  // Both return zero on success and an error message otherwise.
+  //
+  const char *write (const char *path) const;
+  const char *read (const char *path);
+};
+
+} // namespace CaDiCaL
+
+#endif
@@ -0,0 +1,412 @@
+#include "compress.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <queue>
+
+extern "C" {
+#include <unistd.h>
+}
+
+namespace CaDiCaL {
+
+/*------------------------------------------------------------------------*/
+
+// Bits are written least significant first, except for Huffman codes,
+// which are stored reversed to get them most significant first.
+
+struct BitWriter {
+  std::vector<unsigned char> &out;
+  uint64_t buffer = 0;
+  int count = 0;
+
+  BitWriter (std::vector<unsigned char> &o) : out (o) {}
+
+  void put (uint32_t bits, int width) {
+    buffer |= (uint64_t) bits << count;
+    count += width;
+    while (count >= 8) {
+      out.push_back (buffer & 0xff);
+      buffer >>= 8;
+      count -= 8;
+    }
+  }
+
+  void flush () {
+    if (count)
+      out.push_back (buffer & 0xff);
+    buffer = 0;
+    count = 0;
+  }
+};
+
+// The length and distance codes of DEFLATE (RFC 1951).
+
+static const int length_base[29] = {
+    3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+    31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+
+static const int length_extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1,
+                                     1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                     4, 4, 4, 4, 5, 5, 5, 5, 0};
+
+static const int distance_base[30] = {
+    1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+    33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+    1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+
+static const int distance_extra[30] = {0, 0, 0,  0,  1,  1,  2,  2,
+                                       3, 3, 4,  4,  5,  5,  6,  6,
+                                       7, 7, 8,  8,  9,  9,  10, 10,
+                                       11, 11, 12, 12, 13, 13};
+
+static const int code_length_order[19] = {16, 17, 18, 0, 8,  7, 9,
+                                          6,  10, 5,  11, 4, 12, 3,
+                                          13, 2,  14, 1, 15};
+
+static int length_code (int length) {
+  int code = 28;
+  while (length_base[code] > length)
+    code--;
+  return code;
+}
+
+static int distance_code (int distance) {
+  int code = 29;
+  while (distance_base[code] > distance)
+    code--;
+  return code;
+}
+
+/*------------------------------------------------------------------------*/
+
+// Huffman code lengths of at most 'limit' bits.  If the optimal code is
+// too deep the frequencies are flattened until it fits.  Codes with a
+// single symbol get a second one, since not all decoders accept
+// incomplete codes.
+
+static void huffman_lengths (std::vector<uint32_t> freq, int limit,
+                             std::vector<unsigned char> &lengths) {
+  const int n = freq.size ();
+  lengths.assign (n, 0);
+  int used = 0;
+  for (int i = 0; i < n; i++)
+    used += freq[i] > 0;
+  if (used < 2) {
+    for (int i = 0; used < 2 && i < n; i++)
+      if (!freq[i])
+        freq[i] = 1, used++;
+  }
+  typedef std::pair<uint64_t, int> Node;
+  for (;;) {
+    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> heap;
+    std::vector<int> parent (2 * n, -1);
+    for (int i = 0; i < n; i++)
+      if (freq[i])
+        heap.push (Node (freq[i], i));
+    int next = n;
+    while (heap.size () > 1) {
+      const Node a = heap.top ();
+      heap.pop ();
+      const Node b = heap.top ();
+      heap.pop ();
+      parent[a.second] = parent[b.second] = next;
+      heap.push (Node (a.first + b.first, next++));
+    }
+    int deepest = 0;
+    for (int i = 0; i < n; i++) {
+      if (!freq[i])
+        continue;
+      int depth = 0;
+      for (int j = i; parent[j] >= 0; j = parent[j])
+        depth++;
+      lengths[i] = depth;
+      deepest = std::max (deepest, depth);
+    }
+    if (deepest <= limit)
+      return;
+    for (auto &f : freq)
+      if (f)
+        f = (f >> 1) | 1;
+  }
+}
+
+static void huffman_codes (const std::vector<unsigned char> &lengths,
+                           std::vector<uint32_t> &codes) {
+  int count[16] = {0};
+  for (auto l : lengths)
+    count[l]++;
+  count[0] = 0;
+  uint32_t next[16] = {0}, code = 0;
+  for (int bits = 1; bits < 16; bits++) {
+    code = (code + count[bits - 1]) << 1;
+    next[bits] = code;
+  }
+  codes.assign (lengths.size (), 0);
+  for (size_t i = 0; i < lengths.size (); i++) {
+    const int l = lengths[i];
+    if (!l)
+      continue;
+    uint32_t c = next[l]++, reversed = 0;
+    for (int j = 0; j < l; j++)
+      reversed = (reversed << 1) | (c & 1), c >>= 1;
+    codes[i] = reversed;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+
+// A literal if 'distance' is zero and a match otherwise.
+
+struct Symbol {
+  uint16_t value; // literal byte or match length
+  uint16_t distance;
+};
+
+static void write_block (BitWriter &bits, const std::vector<Symbol> &syms,
+                         bool last) {
+  std::vector<uint32_t> lfreq (286, 0), dfreq (30, 0);
+  for (const auto &s : syms)
+    if (s.distance) {
+      lfreq[257 + length_code (s.value)]++;
+      dfreq[distance_code (s.distance)]++;
+    } else
+      lfreq[s.value]++;
+  lfreq[256] = 1;
+
+  std::vector<unsigned char> llen, dlen;
+  huffman_lengths (lfreq, 15, llen);
+  huffman_lengths (dfreq, 15, dlen);
+  int hlit = 286, hdist = 30;
+  while (hlit > 257 && !llen[hlit - 1])
+    hlit--;
+  while (hdist > 1 && !dlen[hdist - 1])
+    hdist--;
+
+  // Run-length encoding of both code lengths with the symbols 16 (repeat
+  // previous), 17 and 18 (repeat zero), stored with their extra bits.
+
+  std::vector<unsigned char> all (llen.begin (), llen.begin () + hlit);
+  all.insert (all.end (), dlen.begin (), dlen.begin () + hdist);
+  std::vector<std::pair<int, int>> rle;
+  for (size_t i = 0; i < all.size ();) {
+    const int value = all[i];
+    size_t run = 1;
+    while (i + run < all.size () && all[i + run] == value)
+      run++;
+    i += run;
+    if (!value) {
+      while (run >= 11) {
+        const size_t k = std::min (run, (size_t) 138);
+        rle.push_back ({18, (int) k - 11});
+        run -= k;
+      }
+      if (run >= 3)
+        rle.push_back ({17, (int) run - 3}), run = 0;
+    } else {
+      rle.push_back ({value, 0}), run--;
+      while (run >= 3) {
+        const size_t k = std::min (run, (size_t) 6);
+        rle.push_back ({16, (int) k - 3});
+        run -= k;
+      }
+    }
+    while (run--)
+      rle.push_back ({value, 0});
+  }
+  std::vector<uint32_t> cfreq (19, 0);
+  for (const auto &r : rle)
+    cfreq[r.first]++;
+  std::vector<unsigned char> clen;
+  huffman_lengths (cfreq, 7, clen);
+  int hclen = 19;
+  while (hclen > 4 && !clen[code_length_order[hclen - 1]])
+    hclen--;
+
+  std::vector<uint32_t> lcodes, dcodes, ccodes;
+  huffman_codes (llen, lcodes);
+  huffman_codes (dlen, dcodes);
+  huffman_codes (clen, ccodes);
+
+  bits.put (last, 1);
+  bits.put (2, 2);
+  bits.put (hlit - 257, 5);
+  bits.put (hdist - 1, 5);
+  bits.put (hclen - 4, 4);
+  for (int i = 0; i < hclen; i++)
+    bits.put (clen[code_length_order[i]], 3);
+  for (const auto &r : rle) {
+    bits.put (ccodes[r.first], clen[r.first]);
+    if (r.first == 16)
+      bits.put (r.second, 2);
+    else if (r.first == 17)
+      bits.put (r.second, 3);
+    else if (r.first == 18)
+      bits.put (r.second, 7);
+  }
+
+  for (const auto &s : syms) {
+    if (!s.distance) {
+      bits.put (lcodes[s.value], llen[s.value]);
+      continue;
+    }
+    const int lc = length_code (s.value);
+    bits.put (lcodes[257 + lc], llen[257 + lc]);
+    bits.put (s.value - length_base[lc], length_extra[lc]);
+    const int dc = distance_code (s.distance);
+    bits.put (dcodes[dc], dlen[dc]);
+    bits.put (s.distance - distance_base[dc], distance_extra[dc]);
+  }
+  bits.put (lcodes[256], llen[256]);
+}
+
+/*------------------------------------------------------------------------*/
+
+static uint32_t crc32 (const unsigned char *data, size_t size) {
+  static uint32_t table[256];
+  static std::once_flag initialized;
+  std::call_once (initialized, [] {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int j = 0; j < 8; j++)
+        c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+      table[i] = c;
+    }
+  });
+  uint32_t crc = 0xffffffffu;
+  for (size_t i = 0; i < size; i++)
+    crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  return crc ^ 0xffffffffu;
+}
+
+void Compressor::gzip (const unsigned char *data, size_t size,
+                       std::vector<unsigned char> &out) {
+  static const unsigned char header[10] = {0x1f, 0x8b, 8, 0, 0,
+                                           0,    0,    0, 0, 255};
+  out.assign (header, header + sizeof header);
+
+  const int window = 1 << 15, max_length = 258, max_chain = 32;
+  const int hash_bits = 15, hash_size = 1 << hash_bits;
+  std::vector<int> head (hash_size, -1), prev (window, -1);
+  auto hash = [&] (size_t i) {
+    const uint32_t v = data[i] | data[i + 1] << 8 | data[i + 2] << 16;
+    return (v * 2654435761u) >> (32 - hash_bits);
+  };
+  auto insert = [&] (size_t i) {
+    if (i + 3 > size)
+      return;
+    const uint32_t h = hash (i);
+    prev[i & (window - 1)] = head[h];
+    head[h] = i;
+  };
+
+  BitWriter bits (out);
+  std::vector<Symbol> syms;
+  const size_t block_symbols = 1 << 15;
+  size_t i = 0;
+  while (i < size) {
+    int best = 0, distance = 0;
+    if (i + 3 <= size) {
+      const size_t limit = std::min ((size_t) max_length, size - i);
+      int candidate = head[hash (i)];
+      for (int chain = max_chain;
+           candidate >= 0 && i - candidate <= (size_t) window && chain--;
+           candidate = prev[candidate & (window - 1)]) {
+        const unsigned char *p = data + candidate, *q = data + i;
+        if (p[best] != q[best])
+          continue;
+        size_t l = 0;
+        while (l < limit && p[l] == q[l])
+          l++;
+        if ((int) l > best) {
+          best = l, distance = i - candidate;
+          if (l == limit)
+            break;
+        }
+      }
+    }
+    if (best >= 3) {
+      syms.push_back ({(uint16_t) best, (uint16_t) distance});
+      for (int j = 0; j < best; j++)
+        insert (i + j);
+      i += best;
+    } else {
+      syms.push_back ({data[i], 0});
+      insert (i++);
+    }
+    if (syms.size () == block_symbols) {
+      write_block (bits, syms, false);
+      syms.clear ();
+    }
+  }
+  write_block (bits, syms, true);
+  bits.flush ();
+
+  const uint32_t trailer[2] = {crc32 (data, size), (uint32_t) size};
+  for (auto word : trailer)
+    for (int j = 0; j < 4; j++)
+      out.push_back (word >> (8 * j));
+}
+
+/*------------------------------------------------------------------------*/
+
+static const size_t compressor_block_size = 1 << 20;
+
+Compressor::Compressor (int i, FILE *o, int threads)
+    : input (i), output (o), next_read (0), next_write (0),
+      end_of_input (false), failed (false) {
+  for (int t = 0; t < std::max (1, threads); t++)
+    workers.emplace_back (&Compressor::work, this);
+}
+
+size_t Compressor::read_block (std::vector<unsigned char> &block) {
+  block.resize (compressor_block_size);
+  size_t size = 0;
+  while (!end_of_input && size < block.size ()) {
+    const ssize_t n = ::read (input, block.data () + size,
+                              block.size () - size);
+    if (n > 0)
+      size += n;
+    else if (n == 0 || errno != EINTR)
+      end_of_input = true;
+  }
+  block.resize (size);
+  return size;
+}
+
+// Blocks are read one after the other, compressed in parallel and written
+// in the order they were read.  An empty input still gives one (empty)
+// member, since an empty file is not a valid gzip file.
+
+void Compressor::work () {
+  std::vector<unsigned char> block, compressed;
+  for (;;) {
+    uint64_t seq;
+    {
+      std::lock_guard<std::mutex> guard (read_lock);
+      if (!read_block (block) && next_read)
+        return;
+      seq = next_read++;
+    }
+    gzip (block.data (), block.size (), compressed);
+    std::unique_lock<std::mutex> guard (write_lock);
+    written.wait (guard, [&] { return next_write == seq; });
+    if (fwrite (compressed.data (), 1, compressed.size (), output) !=
+        compressed.size ())
+      failed = true;
+    next_write++;
+    written.notify_all ();
+  }
+}
+
+void Compressor::finish () {
+  for (auto &worker : workers)
+    worker.join ();
+  workers.clear ();
+  ::close (input);
+  if (fclose (output))
+    failed = true;
+}
+
+} // namespace CaDiCaL
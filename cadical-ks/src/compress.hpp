@@ -0,0 +1,56 @@
+#ifndef _compress_hpp_INCLUDED
+#define _compress_hpp_INCLUDED
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CaDiCaL {
+
+// Compresses everything written to the write end of a pipe into a '.gz'
+// file in the background, instead of piping to an external 'gzip'.  The
+// input is cut into blocks, which worker threads compress independently
+// (as 'pigz' does) into gzip members written in order.  A sequence of
+// members is a valid gzip file, which 'gzip -d' and 'zcat' decompress as
+// a whole.  The compression itself is a dependency free DEFLATE (greedy
+// LZ77 matching with hash chains and dynamic Huffman codes).
+
+class Compressor {
+
+  int input;    // read end of the pipe
+  FILE *output; // compressed file
+
+  std::mutex read_lock, write_lock;
+  std::condition_variable written;
+  uint64_t next_read, next_write; // block sequence numbers
+  bool end_of_input;
+  bool failed;
+
+  std::vector<std::thread> workers;
+
+  size_t read_block (std::vector<unsigned char> &);
+  void work ();
+
+public:
+  // Takes over both 'input' and 'output'.
+  //
+  Compressor (int input, FILE *output, int threads);
+
+  // Returns after the write end of the pipe is closed and everything is
+  // compressed and written.  Then 'ok' tells whether writing succeeded.
+  //
+  void finish ();
+  bool ok () const { return !failed; }
+
+  // One gzip member.
+  //
+  static void gzip (const unsigned char *data, size_t size,
+                    std::vector<unsigned char> &out);
+};
+
+} // namespace CaDiCaL
+
+#endif
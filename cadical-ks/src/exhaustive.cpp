@@ -1,7 +1,7 @@
 #include "exhaustive.hpp"
 #include <iostream>
 
-ExhaustiveSearch::ExhaustiveSearch(CaDiCaL::Solver * s, int order) : solver(s) {
+ExhaustiveSearch::ExhaustiveSearch(CaDiCaL::Solver * s, int order, bool q) : solver(s), quiet(q) {
     if (order <= 0) {
         std::cout << "c Error: Order must be positive for exhaustive search" << std::endl;
         return;
@@ -10,7 +10,8 @@ ExhaustiveSearch::ExhaustiveSearch(CaDiCaL::Solver * s, int order) : solver(s) {
     num_edge_vars = order * (order - 1) / 2;
     solver->connect_external_propagator(this);
     
-    std::cout << "c Running exhaustive search on order " << order << " (" << num_edge_vars << " edge variables)" << std::endl;
+    if (!quiet)
+        std::cout << "c Running exhaustive search on order " << order << " (" << num_edge_vars << " edge variables)" << std::endl;
     
     // Observe all variables
     int max_var = solver->vars();
@@ -22,7 +23,8 @@ ExhaustiveSearch::ExhaustiveSearch(CaDiCaL::Solver * s, int order) : solver(s) {
 ExhaustiveSearch::~ExhaustiveSearch() {
     if (num_edge_vars != 0) {
         solver->disconnect_external_propagator();
-        printf("Number of solutions: %ld\n", sol_count);
+        if (!quiet)
+            printf("Number of solutions: %ld\n", sol_count);
     }
 }
 
@@ -32,6 +34,11 @@ void ExhaustiveSearch::notify_assignment(int lit, bool is_fixed) {
     (void)is_fixed;
 }
 
+void ExhaustiveSearch::notify_assignments(const int * lits, size_t size) {
+    (void)lits;
+    (void)size;
+}
+
 void ExhaustiveSearch::notify_new_decision_level() {
     // Not needed for simple exhaustive search
 }
@@ -45,20 +52,20 @@ bool ExhaustiveSearch::cb_check_found_model(const std::vector<int> & model) {
     sol_count += 1;
 
 #ifdef VERBOSE
-    std::cout << "c New solution was found: ";
+    if (!quiet) std::cout << "c New solution was found: ";
 #endif
     std::vector<int> clause;
     // Only include the first num_edge_vars variables in the blocking clause
     for (int i = 0; i < num_edge_vars && i < model.size(); i++) {
 #ifdef VERBOSE
-        if (model[i] > 0) {
+        if (!quiet && model[i] > 0) {
             std::cout << model[i] << " ";
         }
 #endif
         clause.push_back(-model[i]);
     }
 #ifdef VERBOSE
-    std::cout << std::endl;
+    if (!quiet) std::cout << std::endl;
 #endif
     new_clauses.push_back(clause);
     solver->add_trusted_clause(clause);
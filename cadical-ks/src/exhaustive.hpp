@@ -8,13 +8,16 @@ class ExhaustiveSearch : CaDiCaL::ExternalPropagator {
     std::vector<std::vector<int>> new_clauses;
     int num_edge_vars = 0;
     long sol_count = 0;
+    bool quiet = false; // nothing on 'stdout'
 
 public:
-    ExhaustiveSearch(CaDiCaL::Solver * s, int order);
+    ExhaustiveSearch(CaDiCaL::Solver * s, int order, bool q = false);
     ~ExhaustiveSearch();
+    long solutions() const { return sol_count; }
     
     // Required ExternalPropagator interface methods
     void notify_assignment(int lit, bool is_fixed);
+    void notify_assignments(const int * lits, size_t size);
     void notify_new_decision_level();
     void notify_backtrack(size_t new_level);
     bool cb_check_found_model(const std::vector<int> & model);
@@ -734,15 +734,18 @@ bool Internal::external_check_solution () {
 
 /*----------------------------------------------------------------------------*/
 //
-// Notify the external propagator that an observed variable got assigned.
+// Notify the external propagator that observed variables got assigned,
+// all of them in one batch.
 //
 void Internal::notify_assignments () {
   if (!external_prop || external_prop_is_lazy)
     return;
 
   const size_t end_of_trail = trail.size ();
-  if (notified < end_of_trail)
-    LOG ("notify external propagator about new assignments");
+  if (notified >= end_of_trail)
+    return;
+  LOG ("notify external propagator about new assignments");
+  notification.clear ();
   while (notified < end_of_trail) {
     int ilit = trail[notified++];
     if (fixed (ilit) || !observed (ilit))
@@ -751,9 +754,11 @@ void Internal::notify_assignments () {
     int elit = externalize (ilit); // TODO: double-check tainting
     assert (elit);
     assert (external->observed (elit));
-    external->propagator->notify_assignment (elit, false);
+    notification.push_back (elit);
   }
-  return;
+  if (!notification.empty ())
+    external->propagator->notify_assignments (notification.data (),
+                                              notification.size ());
 }
 
 /*----------------------------------------------------------------------------*/
@@ -1,4 +1,5 @@
 #include "internal.hpp"
+#include "compress.hpp"
 
 /*------------------------------------------------------------------------*/
 
@@ -35,7 +36,8 @@ File::File (Internal *i, bool w, int c, int p, FILE *f, const char *n)
 #if !defined(QUIET) || !defined(NDEBUG)
       writing (w),
 #endif
-      close_file (c), child_pid (p), file (f), _name (strdup (n)),
+      close_file (c), child_pid (p), compressor (0), file (f),
+      _name (strdup (n)),
       _lineno (1), _bytes (0) {
   (void) w;
   assert (f), assert (n);
@@ -306,6 +308,25 @@ FILE *File::write_pipe (Internal *internal, const char *command,
   return res;
 }
 
+// The in-process alternative to 'write_pipe': the compressor threads read
+// what is written to the pipe.
+
+FILE *File::compress_pipe (Internal *internal, const char *path,
+                           Compressor *&compressor) {
+  int pipe_fds[2];
+  FILE *out = write_file (internal, path);
+  if (!out)
+    return 0;
+  if (pipe (pipe_fds) < 0) {
+    MSG ("could not generate pipe to compress '%s'", path);
+    fclose (out);
+    return 0;
+  }
+  MSG ("compressing '%s' with %d threads", path, internal->opts.gzip);
+  compressor = new Compressor (pipe_fds[0], out, internal->opts.gzip);
+  return ::fdopen (pipe_fds[1], "w");
+}
+
 #endif
 
 /*------------------------------------------------------------------------*/
@@ -356,8 +377,11 @@ File *File::read (Internal *internal, const char *path) {
 File *File::write (Internal *internal, const char *path) {
   FILE *file;
   int close_output = 3, child_pid = 0;
+  Compressor *compressor = 0;
 #ifndef _WIN32
-  if (has_suffix (path, ".xz"))
+  if (has_suffix (path, ".gz") && internal->opts.gzip)
+    file = compress_pipe (internal, path, compressor), close_output = 4;
+  else if (has_suffix (path, ".xz"))
     file = write_pipe (internal, "xz -c", path, child_pid);
   else if (has_suffix (path, ".bz2"))
     file = write_pipe (internal, "bzip2 -c", path, child_pid);
@@ -372,7 +396,9 @@ File *File::write (Internal *internal, const char *path) {
   if (!file)
     return 0;
 
-  return new File (internal, true, close_output, child_pid, file, path);
+  File *res = new File (internal, true, close_output, child_pid, file, path);
+  res->compressor = compressor;
+  return res;
 }
 
 void File::close (bool print) {
@@ -404,6 +430,16 @@ void File::close (bool print) {
     fclose (file);
     waitpid (child_pid, 0, 0);
   }
+  if (close_file == 4) {
+    if (print)
+      MSG ("closing compressor writing '%s'", name ());
+    fclose (file);
+    compressor->finish ();
+    if (!compressor->ok ())
+      MSG ("writing compressed '%s' failed", name ());
+    delete compressor;
+    compressor = 0;
+  }
 #endif
   file = 0; // mark as closed
 
@@ -416,7 +452,7 @@ void File::close (bool print) {
       double written_mb = written_bytes / (double) (1 << 20);
       MSG ("after writing %" PRIu64 " bytes %.1f MB", written_bytes,
            written_mb);
-      if (close_file == 3) {
+      if (close_file == 3 || close_file == 4) {
         size_t actual_bytes = size (name ());
         if (actual_bytes) {
           double actual_mb = actual_bytes / (double) (1 << 20);
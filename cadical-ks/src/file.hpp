@@ -26,9 +26,12 @@ namespace CaDiCaL {
 // Wraps a 'C' file 'FILE' with name and supports zipped reading and writing
 // through 'popen' using external helper tools.  Reading has line numbers.
 // Compression and decompression relies on external utilities, e.g., 'gzip',
-// 'bzip2', 'xz', and '7z', which should be in the 'PATH'.
+// 'bzip2', 'xz', and '7z', which should be in the 'PATH'.  Only writing
+// '.gz' files is done in-process by default (see 'Compressor' and the
+// 'gzip' option).
 
 struct Internal;
+class Compressor;
 
 class File {
 
@@ -37,8 +40,9 @@ class File {
   bool writing;
 #endif
 
-  int close_file; // need to close file (1=fclose, 2=pclose, 3=pipe)
+  int close_file; // 1=fclose, 2=pclose, 3=pipe, 4=compressor
   int child_pid;
+  Compressor *compressor;
   FILE *file;
   char *_name;
   uint64_t _lineno;
@@ -60,6 +64,8 @@ class File {
 #ifndef __WIN32
   static FILE *write_pipe (Internal *, const char *fmt, const char *path,
                            int &child_pid);
+  static FILE *compress_pipe (Internal *, const char *path,
+                              Compressor *&);
 #endif
 
 public:
@@ -221,6 +221,7 @@ struct Internal {
   bool from_propagator;         // differentiate new clauses...
   int tainted_literal;          // used for ILB
   size_t notified;           // next trail position to notify external prop
+  vector<int> notification;  // external literals notified in one batch
   Clause *probe_reason;      // set during probing
   size_t propagated;         // next trail position to propagate
   size_t propagated2;        // next binary trail position to propagate
@@ -0,0 +1,130 @@
+#include "latency.hpp"
+#include "resources.hpp"
+
+#include <cinttypes>
+
+namespace CaDiCaL {
+
+int Histogram::bucket (uint64_t ticks) {
+  if (ticks < (uint64_t) sub_buckets)
+    return ticks;
+  const int shift = 63 - __builtin_clzll (ticks) - sub_bits;
+  return (shift + 1) * sub_buckets + (int) (ticks >> shift) - sub_buckets;
+}
+
+uint64_t Histogram::lower (int bucket) {
+  if (bucket < sub_buckets)
+    return bucket;
+  const int shift = bucket / sub_buckets - 1;
+  return (uint64_t) (sub_buckets + bucket % sub_buckets) << shift;
+}
+
+void Histogram::add (uint64_t ticks) {
+  if (counts.empty ())
+    counts.assign (buckets, 0);
+  counts[bucket (ticks)]++;
+  count++;
+  total += ticks;
+  if (ticks > max)
+    max = ticks;
+}
+
+uint64_t Histogram::percentile (double p) const {
+  if (!count)
+    return 0;
+  uint64_t rank = p * count, seen = 0;
+  if (rank >= count)
+    rank = count - 1;
+  for (int b = 0; b < buckets; b++)
+    if ((seen += counts[b]) > rank)
+      return lower (b);
+  return max;
+}
+
+/*------------------------------------------------------------------------*/
+
+// The tick rate is estimated over a few milliseconds first, which is good
+// enough to schedule snapshots, and then over the whole run on output.
+
+Latency::Latency (const char *p, double seconds) : path (p) {
+  start_ticks = ticks ();
+  start_seconds = absolute_real_time ();
+  if (seconds > 0) {
+    while (absolute_real_time () - start_seconds < 2e-3)
+      ;
+    interval = seconds * 1e9 * ticks_per_nanosecond ();
+    next_snapshot = ticks () + interval;
+  }
+}
+
+double Latency::ticks_per_nanosecond () const {
+  const double elapsed = absolute_real_time () - start_seconds;
+  if (elapsed <= 0)
+    return 1;
+  return (ticks () - start_ticks) / (elapsed * 1e9);
+}
+
+int Latency::find (const std::string &name) {
+  for (size_t i = 0; i < histograms.size (); i++)
+    if (histograms[i].name == name)
+      return i;
+  histograms.push_back (Named ());
+  histograms.back ().name = name;
+  return histograms.size () - 1;
+}
+
+// Replaces the file atomically, so readers never see half a snapshot.
+
+void Latency::snapshot (uint64_t now) {
+  next_snapshot = now + interval;
+  const std::string tmp = path + ".tmp";
+  FILE *file = fopen (tmp.c_str (), "w");
+  if (!file)
+    return;
+  const bool ok = write (file);
+  if (fclose (file) || !ok)
+    remove (tmp.c_str ());
+  else
+    rename (tmp.c_str (), path.c_str ());
+}
+
+// Besides the summary each histogram lists its non-empty buckets as pairs
+// of lower bound and count, so that histograms of several runs can be
+// merged.  The lower bounds are in ticks (divide by 'ticks_per_ns'), since
+// with more than one tick per nanosecond the small buckets would round to
+// the same number of nanoseconds.
+
+bool Latency::write (FILE *file) const {
+  const double rate = ticks_per_nanosecond ();
+  fprintf (file, "{\n  \"seconds\": %.3f,\n  \"ticks_per_ns\": %.4f,\n",
+           absolute_real_time () - start_seconds, rate);
+  fputs ("  \"histograms\": {", file);
+  const char *separator = "\n";
+  for (const auto &named : histograms) {
+    const Histogram &h = named.histogram;
+    if (!h.count)
+      continue;
+    fprintf (file, "%s    \"%s\": {", separator, named.name.c_str ());
+    fprintf (file, "\"count\": %" PRIu64 ", ", h.count);
+    fprintf (file, "\"total_ns\": %.0f, ", h.total / rate);
+    fprintf (file, "\"mean_ns\": %.1f, ", h.total / rate / h.count);
+    fprintf (file, "\"p50_ns\": %.0f, ", h.percentile (0.5) / rate);
+    fprintf (file, "\"p90_ns\": %.0f, ", h.percentile (0.9) / rate);
+    fprintf (file, "\"p99_ns\": %.0f, ", h.percentile (0.99) / rate);
+    fprintf (file, "\"p999_ns\": %.0f, ", h.percentile (0.999) / rate);
+    fprintf (file, "\"max_ns\": %.0f,\n      \"buckets\": [", h.max / rate);
+    const char *comma = "";
+    for (int b = 0; b < Histogram::buckets; b++)
+      if (h.counts[b]) {
+        fprintf (file, "%s[%" PRIu64 ", %" PRIu64 "]", comma,
+                 Histogram::lower (b), h.counts[b]);
+        comma = ", ";
+      }
+    fputs ("]}", file);
+    separator = ",\n";
+  }
+  fputs ("\n  }\n}\n", file);
+  return !ferror (file);
+}
+
+} // namespace CaDiCaL
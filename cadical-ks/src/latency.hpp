@@ -0,0 +1,117 @@
+#ifndef _latency_hpp_INCLUDED
+#define _latency_hpp_INCLUDED
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+namespace CaDiCaL {
+
+// Latency histograms for the callbacks of an external propagator, in the
+// style of 'HdrHistogram': every power of two is split into 16 linear
+// buckets, which bounds the relative error of the reported percentiles by
+// 1/16 at a constant size of about 8 KB per histogram, whatever the range
+// of values.  Timing uses the time stamp counter where available, which
+// costs a few dozen cycles per call, and is converted to nanoseconds only
+// on output.  Unlike the totals in 'profile.hpp' this shows the tails,
+// e.g., the few canonicity checks which take a thousand times longer than
+// the median one.
+
+class Histogram {
+public:
+  static const int sub_bits = 4;
+  static const int sub_buckets = 1 << sub_bits;
+  static const int buckets = sub_buckets * (65 - sub_bits);
+
+  uint64_t count = 0, total = 0, max = 0;
+  std::vector<uint64_t> counts;
+
+  void add (uint64_t ticks);
+
+  // Smallest value of the bucket in which the 'p' quantile falls.
+  //
+  uint64_t percentile (double p) const;
+
+  static int bucket (uint64_t ticks);
+  static uint64_t lower (int bucket);
+};
+
+class Latency {
+
+  struct Named {
+    std::string name;
+    Histogram histogram;
+  };
+  std::vector<Named> histograms;
+
+  std::string path;      // JSON file
+  uint64_t interval = 0; // ticks between snapshots (zero = only at end)
+  uint64_t next_snapshot = 0;
+  uint64_t start_ticks;
+  double start_seconds;
+
+  double ticks_per_nanosecond () const;
+
+public:
+  Latency (const char *path, double interval);
+
+  // Histograms are created on demand and callers keep the index returned
+  // by 'find' instead of looking up the name on every call.
+  //
+  int find (const std::string &name);
+  void add (int histogram, uint64_t ticks) {
+    histograms[histogram].histogram.add (ticks);
+  }
+
+  // Writes the JSON file if the snapshot interval passed.  Cheap enough to
+  // be called from frequent callbacks.
+  //
+  void poll (uint64_t now) {
+    if (interval && now >= next_snapshot)
+      snapshot (now);
+  }
+  void snapshot (uint64_t now);
+
+  // Statistics per histogram in nanoseconds: count, mean, max, and the
+  // 50th, 90th, 99th and 99.9th percentile.  Returns false if the file
+  // cannot be written.
+  //
+  bool write (FILE *) const;
+
+  static uint64_t ticks () {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc ();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds> (
+               std::chrono::steady_clock::now ().time_since_epoch ())
+        .count ();
+#endif
+  }
+};
+
+// Times the scope it lives in, if 'latency' is non-zero.
+
+class LatencyTimer {
+  Latency *latency;
+  int histogram;
+  uint64_t start;
+
+public:
+  LatencyTimer (Latency *l, int h)
+      : latency (l), histogram (h), start (l ? Latency::ticks () : 0) {}
+  ~LatencyTimer () {
+    if (latency)
+      latency->add (histogram, Latency::ticks () - start);
+  }
+};
+
+} // namespace CaDiCaL
+
+#endif
@@ -0,0 +1,124 @@
+#include "progress.hpp"
+#include "internal.hpp"
+
+#include <cinttypes>
+#include <cmath>
+
+#ifndef __WIN32
+extern "C" {
+#include <unistd.h>
+}
+#endif
+
+namespace CaDiCaL {
+
+Progress::Progress (Internal *i, const char *p, double seconds, int n)
+    : internal (i), path (p), interval (seconds), order (n),
+      edge_vars (n * (n - 1) / 2) {
+  start = last_snapshot = absolute_real_time ();
+  next_snapshot = start + interval;
+  canonicals.assign (order, 0);
+  last_canonicals.assign (order, 0);
+}
+
+int Progress::edge_decisions (int level) const {
+  int res = 0;
+  for (int l = 1; l <= level; l++) {
+    const int decision = internal->control[l].decision;
+    if (decision && abs (internal->externalize (decision)) <= edge_vars)
+      res++;
+  }
+  return res;
+}
+
+void Progress::backtrack (int new_level) {
+  Clause *conflict = internal->conflict;
+  if (!conflict)
+    return;
+  const bool again = conflict == last_conflict && new_level < last_level;
+  last_conflict = conflict;
+  last_level = new_level;
+  if (again)
+    return;
+  const int level = internal->level;
+  const size_t trail = internal->trail.size ();
+  conflicts++;
+  levels += level;
+  trails += trail;
+  if (level > max_level)
+    max_level = level;
+  if (trail > max_trail)
+    max_trail = trail;
+  depths += edge_decisions (level);
+}
+
+void Progress::poll () {
+  if (absolute_real_time () >= next_snapshot)
+    snapshot (false);
+}
+
+// Replaces the file atomically, so readers never see half a snapshot
+// (as 'Latency::snapshot').
+
+void Progress::snapshot (bool done) {
+  const double now = absolute_real_time ();
+  next_snapshot = now + interval;
+  const std::string tmp = path + ".tmp";
+  FILE *file = fopen (tmp.c_str (), "w");
+  if (file) {
+    write (file, done);
+    if (fclose (file))
+      remove (tmp.c_str ());
+    else
+      rename (tmp.c_str (), path.c_str ());
+  }
+  last_snapshot = now;
+  last_conflicts = conflicts;
+  levels = trails = max_level = max_trail = 0;
+  last_canonicals = canonicals;
+}
+
+void Progress::write (FILE *file, bool done) const {
+  const double now = absolute_real_time ();
+  const double seconds = now - start, delta = now - last_snapshot;
+  const int64_t new_conflicts = conflicts - last_conflicts;
+  const double rate = delta > 0 ? new_conflicts / delta : 0;
+#ifndef __WIN32
+  fprintf (file, "{\n  \"pid\": %d,\n", (int) getpid ());
+#else
+  fputs ("{\n", file);
+#endif
+  fprintf (file, "  \"done\": %s,\n", done ? "true" : "false");
+  fprintf (file, "  \"seconds\": %.3f,\n", seconds);
+  fprintf (file, "  \"process_seconds\": %.3f,\n",
+           absolute_process_time ());
+  fprintf (file, "  \"conflicts\": %" PRId64 ",\n", conflicts);
+  fprintf (file, "  \"conflicts_per_second\": %.1f,\n", rate);
+  fprintf (file, "  \"decisions\": %" PRId64 ",\n",
+           internal->stats.decisions);
+  fprintf (file, "  \"level\": {\"mean\": %.1f, \"max\": %d},\n",
+           new_conflicts ? levels / (double) new_conflicts : 0.0,
+           max_level);
+  fprintf (file, "  \"trail\": {\"mean\": %.1f, \"max\": %zu},\n",
+           new_conflicts ? trails / (double) new_conflicts : 0.0,
+           max_trail);
+  fputs ("  \"canonical_per_second\": [", file);
+  for (int i = 0; i < order; i++)
+    fprintf (file, "%s%.1f", i ? ", " : "",
+             delta > 0 ? (canonicals[i] - last_canonicals[i]) / delta : 0);
+  fputs ("],\n", file);
+  if (conflicts) {
+    const double leaves = exp2 (depths / conflicts);
+    const double missing = leaves > conflicts ? leaves - conflicts : 0;
+    fprintf (file, "  \"mean_edge_decisions\": %.2f,\n",
+             depths / conflicts);
+    fprintf (file, "  \"knuth_leaves\": %.6g,\n", leaves);
+    fprintf (file, "  \"predicted_seconds\": %.1f\n}\n",
+             done ? 0 : missing * seconds / conflicts);
+  } else
+    fputs ("  \"knuth_leaves\": null,\n"
+           "  \"predicted_seconds\": null\n}\n",
+           file);
+}
+
+} // namespace CaDiCaL
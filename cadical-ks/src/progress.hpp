@@ -0,0 +1,83 @@
+#ifndef _progress_hpp_INCLUDED
+#define _progress_hpp_INCLUDED
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace CaDiCaL {
+
+struct Clause;
+struct Internal;
+
+// Periodic progress snapshots of a run with an orderly generation
+// propagator, so that the orchestrator of a cube and conquer run can see
+// early which cubes are hard instead of waiting for their timeout.  Every
+// 'interval' seconds (and at the end) a JSON file is replaced with the
+// conflicts per second, the decision level and trail size at conflicts,
+// the canonical subgraphs per order and second, and an estimate of the
+// size of the search tree over the edge variables.
+//
+// The estimate follows Knuth: a conflict is a probe reaching a leaf of a
+// binary tree at depth 'd', the number of decisions on edge variables on
+// its trail (other decisions do not branch the tree of orderly
+// generation), which estimates 2^d leaves.  The mean is taken over the
+// logarithms, '2^mean(d)', since the plain mean is dominated by the
+// deepest conflicts by dozens of orders of magnitude.  The conflicts still
+// missing at the average rate so far give the predicted remaining time.
+// Learned clauses cut the tree, so this overestimates (by two orders of
+// magnitude on 'ks22', shrinking as the run proceeds), but it separates
+// cubes which are close to done from those which have barely started.
+// Tree weights (the sum of 2^-d) do not work here, since backjumps and
+// restarts revisit the top of the tree, which lets them exceed one within
+// a second.
+
+class Progress {
+
+  Internal *internal;
+  std::string path; // JSON file
+  double interval;  // seconds between snapshots
+  double start, next_snapshot, last_snapshot;
+  const int order;
+  const int edge_vars;
+
+  int64_t conflicts = 0;
+  double depths = 0; // sum of the edge decisions of all conflicts
+
+  // Since the last snapshot.
+  //
+  int64_t last_conflicts = 0;
+  int64_t levels = 0, trails = 0;
+  int max_level = 0;
+  size_t max_trail = 0;
+  std::vector<int64_t> canonicals, last_canonicals;
+
+  // Chronological backtracking first backtracks to the level of the
+  // conflict and then jumps, which is one conflict, not two.
+  //
+  Clause *last_conflict = 0;
+  int last_level = 0;
+
+  int edge_decisions (int level) const;
+  void write (FILE *, bool done) const;
+
+public:
+  Progress (Internal *, const char *path, double interval, int order);
+
+  // Called whenever the propagator backtracks to 'new_level'.  Only
+  // backtracks during conflict analysis count, not restarts or
+  // inprocessing.
+  //
+  void backtrack (int new_level);
+  void canonical (int order) { canonicals[order - 1]++; }
+
+  // Writes a snapshot if the interval passed.
+  //
+  void poll ();
+  void snapshot (bool done);
+};
+
+} // namespace CaDiCaL
+
+#endif
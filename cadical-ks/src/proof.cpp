@@ -1,4 +1,5 @@
 #include "internal.hpp"
+#include "sampler.hpp"
 
 namespace CaDiCaL {
 
@@ -506,6 +507,7 @@ void Proof::add_derived_clause () {
   LOG (clause, "PROOF adding derived external clause (redundant: %d)",
        redundant);
   assert (clause_id);
+  SamplerFrame frame (Sampler::PROOF);
   if (lratbuilder) {
     proof_chain = lratbuilder->add_clause_get_proof (clause_id, clause);
   }
@@ -519,6 +521,7 @@ void Proof::add_derived_clause () {
 
 void Proof::add_trusted_clause (const vector<int> &clause) {
   LOG (clause, "PROOF adding trusted clause");
+  SamplerFrame frame (Sampler::PROOF);
   for (auto &tracer : tracers) {
     tracer->add_trusted_clause (clause);
   }
@@ -526,6 +529,7 @@ void Proof::add_trusted_clause (const vector<int> &clause) {
 
 void Proof::delete_clause () {
   LOG (clause, "PROOF deleting external clause");
+  SamplerFrame frame (Sampler::PROOF);
   if (lratbuilder)
     lratbuilder->delete_clause (clause_id, clause);
   for (auto &tracer : tracers) {
@@ -0,0 +1,201 @@
+#include "sampler.hpp"
+#include "internal.hpp"
+
+/*------------------------------------------------------------------------*/
+
+#ifndef __WIN32
+extern "C" {
+#include <fcntl.h>
+#include <sys/time.h>
+#include <unistd.h>
+}
+#endif
+
+/*------------------------------------------------------------------------*/
+
+namespace CaDiCaL {
+
+volatile bool Sampler::active = false;
+volatile int Sampler::depth = 0;
+volatile int Sampler::frames[Sampler::max_frames];
+
+#ifndef __WIN32
+
+// A sample is the mode of the solver (bits 0 to 14), whether it is in
+// stable mode (bit 15) and up to three frames of 12 bits.  The counts are
+// kept in a fixed open addressing table, since the signal handler can not
+// allocate.  Samples which do not fit are only counted.
+
+static const int mode_bits = 16, frame_bits = 12;
+static const uint64_t STABLE = 1 << 15;
+static const uint64_t USED = (uint64_t) 1 << 63;
+
+static const unsigned table_size = 1 << 12;
+static struct {
+  uint64_t key, count;
+} table[table_size];
+static uint64_t dropped;
+
+static Internal *sampled;
+static const char *sample_path;
+static struct sigaction old_prof, old_usr1;
+
+static void tick (int) {
+  uint64_t key = sampled->mode;
+  if (sampled->in_mode (Internal::SEARCH) && sampled->stable)
+    key |= STABLE;
+  const int d = Sampler::depth;
+  for (int i = 0; i < d && i < 3; i++)
+    key |= (uint64_t) Sampler::frames[i] << (mode_bits + i * frame_bits);
+  key |= USED;
+  unsigned pos = (key * 0x9E3779B97F4A7C15ull) >> 52;
+  for (unsigned probes = 0; probes < table_size; probes++) {
+    if (table[pos].key == key) {
+      table[pos].count++;
+      return;
+    }
+    if (!table[pos].key) {
+      table[pos].key = key;
+      table[pos].count = 1;
+      return;
+    }
+    pos = (pos + 1) & (table_size - 1);
+  }
+  dropped++;
+}
+
+static void dump (int) { Sampler::write (); }
+
+/*------------------------------------------------------------------------*/
+
+// Output without 'stdio', which is not async-signal-safe.
+
+struct Line {
+  char buffer[256];
+  int size = 0;
+  void put (const char *s) {
+    while (*s && size < (int) sizeof buffer - 1)
+      buffer[size++] = *s++;
+  }
+  void put (uint64_t n) {
+    char digits[24];
+    int i = 0;
+    do
+      digits[i++] = '0' + n % 10;
+    while (n /= 10);
+    while (i && size < (int) sizeof buffer - 1)
+      buffer[size++] = digits[--i];
+  }
+  void frame (const char *name) { put (";"), put (name); }
+};
+
+static const char *mode_names[] = {
+    "block", "condition", "cover",    "decompose", "deduplicate",
+    "elim",  "lucky",     "probe",    "search",    "simplify",
+    "subsume", "ternary", "transred", "vivify",    "walk"};
+
+static void put_frame (Line &line, uint64_t frame) {
+  if (frame == Sampler::PROOF)
+    line.frame ("proof");
+  else if (frame & 0x100)
+    line.frame ("canonical_"), line.put (frame & 0xff);
+  else if (frame & 0x200)
+    line.frame ("mus_"), line.put (frame & 0xff);
+  else
+    line.frame ("frame_"), line.put (frame);
+}
+
+void Sampler::write () {
+  if (!sample_path)
+    return;
+  const int fd = open (sample_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    return;
+  for (unsigned i = 0; i < table_size; i++) {
+    const uint64_t key = table[i].key, count = table[i].count;
+    if (!key)
+      continue;
+    Line line;
+    line.put ("cadical-ks");
+    const unsigned mode = key & (STABLE - 1);
+    if (mode & Internal::SEARCH)
+      line.frame ("search"), line.frame (key & STABLE ? "stable" : "focused");
+    if (mode & Internal::SIMPLIFY)
+      line.frame ("simplify");
+    for (int b = 0; b < 15; b++)
+      if ((mode & (1u << b)) && (1u << b) != Internal::SEARCH &&
+          (1u << b) != Internal::SIMPLIFY)
+        line.frame (mode_names[b]);
+    bool frames = false;
+    for (int f = 0; f < 3; f++) {
+      const uint64_t frame =
+          (key >> (mode_bits + f * frame_bits)) & ((1 << frame_bits) - 1);
+      if (frame)
+        put_frame (line, frame), frames = true;
+    }
+    if (!mode && !frames)
+      line.frame ("other");
+    line.put (" "), line.put (count), line.put ("\n");
+    if (::write (fd, line.buffer, line.size) != line.size)
+      break;
+  }
+  if (dropped) {
+    Line line;
+    line.put ("cadical-ks;dropped "), line.put (dropped), line.put ("\n");
+    const ssize_t written = ::write (fd, line.buffer, line.size);
+    (void) written;
+  }
+  close (fd);
+}
+
+bool Sampler::start (Internal *internal, const char *path, int frequency) {
+  const int fd = open (path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    return false;
+  close (fd);
+  sampled = internal;
+  sample_path = path;
+  depth = 0;
+  active = true;
+
+  // Neither handler interrupts the other.
+  //
+  struct sigaction action;
+  action.sa_flags = SA_RESTART;
+  sigemptyset (&action.sa_mask);
+  sigaddset (&action.sa_mask, SIGPROF);
+  sigaddset (&action.sa_mask, SIGUSR1);
+  action.sa_handler = tick;
+  sigaction (SIGPROF, &action, &old_prof);
+  action.sa_handler = dump;
+  sigaction (SIGUSR1, &action, &old_usr1);
+
+  struct itimerval timer;
+  timer.it_interval.tv_sec = 0;
+  timer.it_interval.tv_usec = 1000000 / frequency;
+  timer.it_value = timer.it_interval;
+  setitimer (ITIMER_PROF, &timer, 0);
+  return true;
+}
+
+void Sampler::stop () {
+  if (!active)
+    return;
+  struct itimerval timer = {};
+  setitimer (ITIMER_PROF, &timer, 0);
+  sigaction (SIGPROF, &old_prof, 0);
+  sigaction (SIGUSR1, &old_usr1, 0);
+  write ();
+  active = false;
+  sample_path = 0;
+}
+
+#else
+
+bool Sampler::start (Internal *, const char *, int) { return false; }
+void Sampler::stop () {}
+void Sampler::write () {}
+
+#endif
+
+} // namespace CaDiCaL
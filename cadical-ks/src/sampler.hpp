@@ -0,0 +1,69 @@
+#ifndef _sampler_hpp_INCLUDED
+#define _sampler_hpp_INCLUDED
+
+#include <cstdint>
+
+namespace CaDiCaL {
+
+struct Internal;
+
+// Sampling profiler for production runs, which unlike '--profile' does not
+// call 'getrusage' around every profiled function.  A 'SIGPROF' timer
+// samples the phase the solver is in: its 'mode' (search, simplification
+// and the inprocessing technique) and a small stack of frames entered by
+// the application (the canonicity check of each order, the unembeddable
+// subgraph checks, proof writing).  The counts are written in the folded
+// stack format of 'flamegraph.pl' ('cadical-ks;search;canonical_17 42'),
+// at the end and whenever the process receives 'SIGUSR1'.
+//
+// Entering and leaving a frame is a test of a global flag, so frames cost
+// nothing unless sampling was started.  There is one sampler per process,
+// which only makes sense for single threaded applications like
+// 'cadical-ks' (see 'App').
+
+class Sampler {
+
+  static const int max_frames = 3;
+
+public:
+  static volatile bool active;
+  static volatile int depth;
+  static volatile int frames[max_frames];
+
+  static const int PROOF = 1;
+  static int canonical (int order) { return 0x100 + order; }
+  static int mus (int graph) { return 0x200 + graph; }
+
+  static void enter (int frame) {
+    if (!active)
+      return;
+    if (depth < max_frames)
+      frames[depth] = frame;
+    depth = depth + 1;
+  }
+  static void leave () {
+    if (active && depth > 0)
+      depth = depth - 1;
+  }
+
+  // Samples 'frequency' times per second of process time and writes the
+  // folded stacks to 'path'.  Returns false if the file can not be opened.
+  //
+  static bool start (Internal *, const char *path, int frequency);
+  static void stop ();
+
+  // Only uses 'open' and 'write', thus can be called in signal handlers.
+  //
+  static void write ();
+};
+
+// Enters a frame for the life time of the object.
+
+struct SamplerFrame {
+  SamplerFrame (int frame) { Sampler::enter (frame); }
+  ~SamplerFrame () { Sampler::leave (); }
+};
+
+} // namespace CaDiCaL
+
+#endif
@@ -29,6 +29,7 @@ static volatile bool alarm_set = false;
 static int alarm_time = -1;
 
 void Handler::catch_alarm () { catch_signal (SIGALRM); }
+void Handler::catch_stop () { catch_alarm (); }
 
 #endif
 
@@ -45,6 +46,8 @@ SIGNALS
 #ifndef __WIN32
 
 static void (*SIGALRM_handler) (int);
+static void (*SIGUSR2_handler) (int);
+static volatile bool stop_set = false;
 
 void Signal::reset_alarm () {
   if (!alarm_set)
@@ -56,6 +59,14 @@ void Signal::reset_alarm () {
   alarm_time = -1;
 }
 
+static void reset_stop () {
+  if (!stop_set)
+    return;
+  (void) signal (SIGUSR2, SIGUSR2_handler);
+  SIGUSR2_handler = 0;
+  stop_set = false;
+}
+
 #endif
 
 void Signal::reset () {
@@ -67,6 +78,7 @@ void Signal::reset () {
 #undef SIGNAL
 #ifndef __WIN32
   reset_alarm ();
+  reset_stop ();
 #endif
   caught_signal = false;
 }
@@ -80,6 +92,8 @@ const char *Signal::name (int sig) {
 #ifndef __WIN32
   if (sig == SIGALRM)
     return "SIGALRM";
+  if (sig == SIGUSR2)
+    return "SIGUSR2";
 #endif
   return "UNKNOWN";
 }
@@ -92,7 +106,10 @@ const char *Signal::name (int sig) {
 
 static void catch_signal (int sig) {
 #ifndef __WIN32
-  if (sig == SIGALRM && absolute_real_time () >= alarm_time) {
+  if (sig == SIGUSR2) {
+    if (signal_handler)
+      signal_handler->catch_stop ();
+  } else if (sig == SIGALRM && absolute_real_time () >= alarm_time) {
     if (!caught_alarm) {
       caught_alarm = true;
       if (signal_handler)
@@ -131,6 +148,12 @@ void Signal::alarm (int seconds) {
   ::alarm (seconds);
 }
 
+void Signal::stop () {
+  assert (!stop_set);
+  SIGUSR2_handler = signal (SIGUSR2, catch_signal);
+  stop_set = true;
+}
+
 #endif
 
 } // namespace CaDiCaL
@@ -12,6 +12,7 @@ public:
   virtual void catch_signal (int sig) = 0;
 #ifndef __WIN32
   virtual void catch_alarm ();
+  virtual void catch_stop (); // Defaults to 'catch_alarm'.
 #endif
 };
 
@@ -23,6 +24,11 @@ public:
 #ifndef __WIN32
   static void alarm (int seconds);
   static void reset_alarm ();
+
+  // Catch 'SIGUSR2' as a request to stop gracefully, as if the time limit
+  // was reached, instead of aborting.
+  //
+  static void stop ();
 #endif
 
   static const char *name (int sig);
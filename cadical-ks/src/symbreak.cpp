@@ -10,31 +10,34 @@ FILE * musoutfile = NULL;
 
 // The kth entry estimates the number of permuations needed to show canonicity in order (k+1)
 long perm_cutoff[MAXORDER] = {0, 0, 0, 0, 0, 0, 20, 50, 125, 313, 783, 1958, 4895, 12238, 30595, 76488, 191220, 478050, 1195125, 2987813, 7469533, 18673833, 46684583};
-long canon = 0;
-long noncanon = 0;
-double canontime = 0;
-double noncanontime = 0;
-long canonarr[MAXORDER] = {};
-long noncanonarr[MAXORDER] = {};
-double canontimearr[MAXORDER] = {};
-double noncanontimearr[MAXORDER] = {};
+// Statistics are per thread, so several solvers can run in one process
+thread_local long canon = 0;
+thread_local long noncanon = 0;
+thread_local double canontime = 0;
+thread_local double noncanontime = 0;
+thread_local long canonarr[MAXORDER] = {};
+thread_local long noncanonarr[MAXORDER] = {};
+thread_local double canontimearr[MAXORDER] = {};
+thread_local double noncanontimearr[MAXORDER] = {};
 #ifdef PERM_STATS
-long canon_np[MAXORDER] = {};
-long noncanon_np[MAXORDER] = {};
+thread_local long canon_np[MAXORDER] = {};
+thread_local long noncanon_np[MAXORDER] = {};
 #endif
-long muscount = 0;
-long muscounts[17] = {};
-double mustime = 0;
+thread_local long muscount = 0;
+thread_local long muscounts[17] = {};
+thread_local double mustime = 0;
 
-SymmetryBreaker::SymmetryBreaker(CaDiCaL::Solver * s, int order, int uc) : solver(s) {
+SymmetryBreaker::SymmetryBreaker(CaDiCaL::Solver * s, int order, int uc, bool q) : solver(s), quiet(q) {
     if (order == 0) {
         std::cout << "c Need to provide order to use programmatic code" << std::endl;
         return;
     }
-    if (uc == 0) {
-        std::cout << "c Not checking for unembeddable subgraphs" << std::endl;
-    } else {
-        std::cout << "c Checking for " << uc << " unembeddable subgraphs" << std::endl;
+    if (!quiet) {
+        if (uc == 0) {
+            std::cout << "c Not checking for unembeddable subgraphs" << std::endl;
+        } else {
+            std::cout << "c Checking for " << uc << " unembeddable subgraphs" << std::endl;
+        }
     }
     n = order;
     num_edge_vars = n*(n-1)/2;
@@ -47,9 +50,10 @@ SymmetryBreaker::SymmetryBreaker(CaDiCaL::Solver * s, int order, int uc) : solve
         assign[i] = l_Undef;
         fixed[i] = false;
     }
-    std::cout << "c Running orderly generation on order " << n << " (" << num_edge_vars << " edge variables)" << std::endl;
+    if (!quiet)
+        std::cout << "c Running orderly generation on order " << n << " (" << num_edge_vars << " edge variables)" << std::endl;
     // The root-level of the trail is always there
-    current_trail.push_back(std::vector<int>());
+    trail_lim.push_back(0);
     // Observe the edge variables for orderly generation
     for (int i = 0; i < num_edge_vars; i++) {
         solver->add_observed_var(i+1);
@@ -62,6 +66,16 @@ SymmetryBreaker::~SymmetryBreaker () {
         delete [] assign;
         delete [] colsuntouched;
         delete [] fixed;
+        if (latency) {
+            latency->snapshot(CaDiCaL::Latency::ticks());
+            delete latency;
+        }
+        delete trace;
+        if (progress) {
+            progress->snapshot(true);
+            delete progress;
+        }
+        if (quiet) return;
         printf("Number of solutions   : %ld\n", sol_count);
         printf("Canonical subgraphs   : %-12" PRIu64 "   (%.0f /sec)\n", canon, canon/canontime);
         for(int i=2; i<n; i++) {
@@ -92,61 +106,158 @@ SymmetryBreaker::~SymmetryBreaker () {
     }
 }
 
+// The statistics printed above as JSON members (without the braces) for
+// the summary of '--stats-json'.  Entry i of the arrays is order i+1.
+
+std::string SymmetryBreaker::stats_json () const {
+    std::string res = "\"solutions\": " + std::to_string(sol_count);
+    res += ",\n  \"canonical\": [";
+    for (int i = 0; i < n; i++)
+        res += (i ? ", " : "") + std::to_string(canonarr[i]);
+    res += "],\n  \"noncanonical\": [";
+    for (int i = 0; i < n; i++)
+        res += (i ? ", " : "") + std::to_string(noncanonarr[i]);
+    res += "],\n  \"canonicity_time\": " + std::to_string(canontime + noncanontime);
+    res += ",\n  \"mus\": [";
+    for (int g = 0; g < unembeddable_check; g++)
+        res += (g ? ", " : "") + std::to_string(muscounts[g]);
+    res += "],\n  \"mus_time\": " + std::to_string(mustime);
+    return res;
+}
+
+// The canonical subgraph hashes of each order carry over to other solvers
+// of the same order.
+
+void SymmetryBreaker::save (CaDiCaL::Checkpoint & checkpoint) const {
+    checkpoint.hashes.assign(n, std::vector<uint64_t>());
+    for (int i = 0; i < n; i++)
+        checkpoint.hashes[i].assign(canonical_hashes[i].begin(), canonical_hashes[i].end());
+}
+
+void SymmetryBreaker::load (const CaDiCaL::Checkpoint & checkpoint) {
+    if ((int) checkpoint.hashes.size() != n)
+        return;
+    for (int i = 0; i < n; i++)
+        canonical_hashes[i].insert(checkpoint.hashes[i].begin(), checkpoint.hashes[i].end());
+}
+
+// Writes the latency histograms as JSON to 'path' at the end, and every
+// 'interval' seconds if positive.
+
+void SymmetryBreaker::record_latency (const char * path, double interval) {
+    static const char * callbacks[CALLBACKS] = {
+        "notify_assignment", "notify_assignments", "notify_new_decision_level",
+        "notify_backtrack", "cb_check_found_model", "cb_has_external_clause",
+        "cb_add_external_clause_lit"};
+    latency = new CaDiCaL::Latency(path, interval);
+    for (int i = 0; i < CALLBACKS; i++)
+        callback_latency[i] = latency->find(callbacks[i]);
+    for (int i = 2; i < n; i++) {
+        canon_latency[i] = latency->find("canonical_" + std::to_string(i+1));
+        noncanon_latency[i] = latency->find("noncanonical_" + std::to_string(i+1));
+    }
+    for (int g = 0; g < unembeddable_check; g++)
+        mus_latency[g] = latency->find("unembeddable_" + std::to_string(g));
+}
+
 void SymmetryBreaker::notify_assignment(int lit, bool is_fixed) {
+    CaDiCaL::LatencyTimer timer(latency, callback_latency[ASSIGNMENT]);
+    if (trace) {
+        if (is_fixed)
+            trace->fixed(lit);
+        else
+            trace->assign(&lit, 1);
+    }
     assign[abs(lit)-1] = (lit > 0 ? l_True : l_False);
     if (is_fixed) {
         fixed[abs(lit)-1] = true;
     } else {
-        current_trail.back().push_back(lit);
+        current_trail.push_back(lit);
     }
 }
 
+void SymmetryBreaker::notify_assignments(const int * lits, size_t size) {
+    CaDiCaL::LatencyTimer timer(latency, callback_latency[ASSIGNMENTS]);
+    if (trace)
+        trace->assign(lits, size);
+    for (size_t i = 0; i < size; i++)
+        assign[abs(lits[i])-1] = (lits[i] > 0 ? l_True : l_False);
+    current_trail.insert(current_trail.end(), lits, lits + size);
+}
+
 void SymmetryBreaker::notify_new_decision_level () {
-    current_trail.push_back(std::vector<int>());
+    CaDiCaL::LatencyTimer timer(latency, callback_latency[LEVEL]);
+    if (trace)
+        trace->level();
+    trail_lim.push_back(current_trail.size());
 }
 
 void SymmetryBreaker::notify_backtrack (size_t new_level) {
-    while (current_trail.size() > new_level + 1) {
-        for (const auto& lit: current_trail.back()) {
-            const int x = abs(lit) - 1;
-            // Don't remove literals that have been fixed
-            if(fixed[x])
-                continue;
-            assign[x] = l_Undef;
-            const int col = 1+(-1+sqrt(1+8*x))/2;
-            for(int i=col; i<n; i++)
-                colsuntouched[i] = false;
-        }
-        current_trail.pop_back();
+    CaDiCaL::LatencyTimer timer(latency, callback_latency[BACKTRACK]);
+    if (trace)
+        trace->backtrack(new_level);
+    if (progress)
+        progress->backtrack(new_level);
+    if (trail_lim.size() <= new_level + 1)
+        return;
+    const size_t start = trail_lim[new_level + 1];
+    int mincol = n;
+    for (size_t j = start; j < current_trail.size(); j++) {
+        const int x = abs(current_trail[j]) - 1;
+        // Don't remove literals that have been fixed
+        if(fixed[x])
+            continue;
+        assign[x] = l_Undef;
+        const int col = 1+(-1+sqrt(1+8*x))/2;
+        mincol = MIN(mincol, col);
     }
+    for(int i=mincol; i<n; i++)
+        colsuntouched[i] = false;
+    current_trail.resize(start);
+    trail_lim.resize(new_level + 1);
 }
 
 bool SymmetryBreaker::cb_check_found_model (const std::vector<int> & model) {
     assert(model.size() == num_edge_vars);
+    CaDiCaL::LatencyTimer timer(latency, callback_latency[MODEL]);
     sol_count += 1;
 
 #ifdef VERBOSE
-    std::cout << "c New solution was found: ";
+    if (!quiet) std::cout << "c New solution was found: ";
 #endif
     std::vector<int> clause;
     for (const auto& lit: model) {
 #ifdef VERBOSE
-        if (lit > 0) {
+        if (!quiet && lit > 0) {
             std::cout << lit << " ";
         }
 #endif
         clause.push_back(-lit);
     }
 #ifdef VERBOSE
-    std::cout << std::endl;
+    if (!quiet) std::cout << std::endl;
 #endif
     new_clauses.push_back(clause);
     solver->add_trusted_clause(clause);
 
+    if (trace)
+        trace->model(model, false);
     return false;
 }
 
 bool SymmetryBreaker::cb_has_external_clause () {
+    const bool res = has_external_clause();
+    if (trace)
+        trace->has_clause(res);
+    return res;
+}
+
+bool SymmetryBreaker::has_external_clause () {
+    CaDiCaL::LatencyTimer timer(latency, callback_latency[HAS_CLAUSE]);
+    if (latency)
+        latency->poll(CaDiCaL::Latency::ticks());
+    if (progress)
+        progress->poll();
     if(!new_clauses.empty())
         return true;
 
@@ -183,11 +294,22 @@ bool SymmetryBreaker::cb_has_external_clause () {
             // Found a new subgraph of order i+1 to test for canonicity
             // Uses a pseudo-check except when i+1 = n
             const double before = CaDiCaL::absolute_process_time();
+            const uint64_t ticks = latency ? CaDiCaL::Latency::ticks() : 0;
             // Run canonicity check
             int p[i+1]; // Permutation on i+1 vertices
             int x, y;   // These will be the indices of first adjacency matrix entry that demonstrates noncanonicity (when such indices exist)
             int mi;     // This will be the index of the maximum defined entry of p
+            CaDiCaL::Sampler::enter(CaDiCaL::Sampler::canonical(i+1));
             bool ret = (hash == 0) ? true : is_canonical(i+1, p, x, y, mi, i < n-1);
+            CaDiCaL::Sampler::leave();
+            // Recorded subgraphs are the corpus of 'bench/bench_canon': the
+            // order and then the edge variables of the subgraph as '0'/'1'
+            if(prefixes != NULL && hash != 0) {
+                fprintf(prefixes, "%d ", i+1);
+                for(int j = 0; j < i*(i+1)/2; j++)
+                    fputc(assign[j]==l_True ? '1' : '0', prefixes);
+                fputc('\n', prefixes);
+            }
 #ifdef VVERBOSE
             if(!ret) {
                 printf("x: %d y: %d, mi: %d, ", x, y, mi);
@@ -201,6 +323,8 @@ bool SymmetryBreaker::cb_has_external_clause () {
             }
 #endif
             const double after = CaDiCaL::absolute_process_time();
+            if (latency)
+                latency->add(ret ? canon_latency[i] : noncanon_latency[i], CaDiCaL::Latency::ticks() - ticks);
 
             // If subgraph is canonical
             if (ret) {
@@ -208,6 +332,8 @@ bool SymmetryBreaker::cb_has_external_clause () {
                 canontime += (after-before);
                 canonarr[i]++;
                 canontimearr[i] += (after-before);
+                if (progress)
+                    progress->canonical(i+1);
                 canonical_hashes[i].insert(hash);
 
                 if(canonicaloutfile != NULL) {
@@ -308,9 +434,14 @@ bool SymmetryBreaker::cb_has_external_clause () {
         for(int j=0; j<n; j++) P[j] = -1;
 
         const double before = CaDiCaL::absolute_process_time();
+        const uint64_t ticks = latency ? CaDiCaL::Latency::ticks() : 0;
+        CaDiCaL::Sampler::enter(CaDiCaL::Sampler::mus(g));
         bool ret = has_mus_subgraph(n, P, p, g);
+        CaDiCaL::Sampler::leave();
         const double after = CaDiCaL::absolute_process_time();
         mustime += (after-before);
+        if (latency)
+            latency->add(mus_latency[g], CaDiCaL::Latency::ticks() - ticks);
 
         // If graph has minimal unembeddable subgraph (MUS)
         if (ret) {
@@ -378,28 +509,64 @@ bool SymmetryBreaker::cb_has_external_clause () {
 }
 
 int SymmetryBreaker::cb_add_external_clause_lit () {
-    if (new_clauses.empty()) return 0;
-    else {
-        assert(!new_clauses.empty());
+    CaDiCaL::LatencyTimer timer(latency, callback_latency[CLAUSE_LIT]);
+    int lit = 0;
+    if (!new_clauses.empty()) {
         size_t clause_idx = new_clauses.size() - 1;
         if (new_clauses[clause_idx].empty()) {
             new_clauses.pop_back();
-            return 0;
+        } else {
+            lit = new_clauses[clause_idx].back();
+            new_clauses[clause_idx].pop_back();
         }
-
-        int lit = new_clauses[clause_idx].back();
-        new_clauses[clause_idx].pop_back();
-        return lit;
     }
+    if (trace)
+        trace->clause_lit(lit);
+    return lit;
 }
 
-int SymmetryBreaker::cb_decide () { return 0; }
-int SymmetryBreaker::cb_propagate () { return 0; }
+int SymmetryBreaker::cb_decide () {
+    if (trace)
+        trace->decide(0);
+    return 0;
+}
+int SymmetryBreaker::cb_propagate () {
+    if (trace)
+        trace->propagate(0);
+    return 0;
+}
 int SymmetryBreaker::cb_add_reason_clause_lit (int plit) {
-    (void)plit;
+    if (trace)
+        trace->reason(plit, 0);
     return 0;
 };
 
+// Feeds a trace recorded with 'record_trace' to the callbacks instead of
+// the solver, which must not be solving.  Found models are still added as
+// trusted clauses to the solver, which only matters for its proof.
+
+bool SymmetryBreaker::replay_trace (FILE * file, CaDiCaL::PropagatorReplay & replay) {
+    struct Adapter {
+        SymmetryBreaker * sb;
+        void fixed (int lit) { sb->notify_assignment(lit, true); }
+        void assign (const std::vector<int> & lits) {
+            if (lits.size() == 1)
+                sb->notify_assignment(lits[0], false);
+            else
+                sb->notify_assignments(lits.data(), lits.size());
+        }
+        void level () { sb->notify_new_decision_level(); }
+        void backtrack (size_t new_level) { sb->notify_backtrack(new_level); }
+        bool model (const std::vector<int> & m) { return sb->cb_check_found_model(m); }
+        bool has_clause (bool &) { return sb->cb_has_external_clause(); }
+        int clause_lit () { return sb->cb_add_external_clause_lit(); }
+        int decide () { return sb->cb_decide(); }
+        int propagate () { return sb->cb_propagate(); }
+        int reason (int plit) { return sb->cb_add_reason_clause_lit(plit); }
+    } adapter = { this };
+    return replay.run(file, adapter);
+}
+
 // Returns true when the k-vertex subgraph (with adjacency matrix M) is canonical
 // M is determined by the current assignment to the first k*(k-1)/2 variables
 // If M is noncanonical, then p, x, and y will be updated so that
@@ -1,4 +1,9 @@
 #include "internal.hpp"
+#include "checkpoint.hpp"
+#include "latency.hpp"
+#include "progress.hpp"
+#include "proptrace.hpp"
+#include "sampler.hpp"
 #include <set>
 
 #define l_False 0
@@ -13,20 +18,44 @@ const int MAXORDER = 40;
 class SymmetryBreaker : CaDiCaL::ExternalPropagator {
     CaDiCaL::Solver * solver;
     std::vector<std::vector<int>> new_clauses;
-    std::deque<std::vector<int>> current_trail;
+    std::vector<int> current_trail; // assigned (non-fixed) literals of all decision levels
+    std::vector<size_t> trail_lim;  // trail_lim[l] is the position in current_trail where decision level l starts
     int * assign;
     bool * fixed;
     int * colsuntouched;
     int n = 0;
     int unembeddable_check = 0;
+    bool quiet = false; // nothing on 'stdout' (the statistics are in 'stats_json')
     long sol_count = 0;
     int num_edge_vars = 0;
     std::set<unsigned long> canonical_hashes[MAXORDER];
     std::set<unsigned long> solution_hashes;
+    // Latency histograms of the callbacks, the canonicity checks by order
+    // and the unembeddable subgraph checks by graph (see 'record_latency')
+    enum { ASSIGNMENT, ASSIGNMENTS, LEVEL, BACKTRACK, MODEL, HAS_CLAUSE, CLAUSE_LIT, CALLBACKS };
+    CaDiCaL::Latency * latency = 0;
+    int callback_latency[CALLBACKS] = {};
+    int canon_latency[MAXORDER] = {};
+    int noncanon_latency[MAXORDER] = {};
+    int mus_latency[17] = {};
+    FILE * prefixes = 0; // subgraphs checked for canonicity (see 'record_prefixes')
+    CaDiCaL::PropagatorTraceWriter * trace = 0; // see 'record_trace'
+    CaDiCaL::Progress * progress = 0; // see 'record_progress'
+    bool has_external_clause ();
 public:
-    SymmetryBreaker(CaDiCaL::Solver * s, int order, int uc);
+    SymmetryBreaker(CaDiCaL::Solver * s, int order, int uc, bool q = false);
     ~SymmetryBreaker ();
+    long solutions () const { return sol_count; }
+    void save (CaDiCaL::Checkpoint & checkpoint) const;
+    void load (const CaDiCaL::Checkpoint & checkpoint);
+    void record_latency (const char * path, double interval);
+    void record_prefixes (FILE * file) { prefixes = file; }
+    void record_trace (FILE * file) { trace = new CaDiCaL::PropagatorTraceWriter(file); }
+    bool replay_trace (FILE * file, CaDiCaL::PropagatorReplay & replay);
+    void record_progress (CaDiCaL::Progress * p) { progress = p; } // takes ownership
+    std::string stats_json () const;
     void notify_assignment(int lit, bool is_fixed);
+    void notify_assignments(const int * lits, size_t size);
     void notify_new_decision_level ();
     void notify_backtrack (size_t new_level);
     bool cb_check_found_model (const std::vector<int> & model);
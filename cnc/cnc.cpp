@@ -0,0 +1,1230 @@
+/*------------------------------------------------------------------------*/
+
+// Cube-and-conquer driver doing what 'parallel-solve.py' does, but in one
+// process: the formulas are kept in memory and CaDiCaL (with the orderly
+// generation propagator) and march_cu are called through their library
+// interfaces instead of running 'apply.sh', 'simplify-by-conflicts.sh',
+// 'march_cu' and 'solve.sh' on intermediate files.
+//
+// Every subproblem is a cube on top of a base formula.  It is simplified
+// by a conflict limited CaDiCaL run with the cube as units, and then either
+// cubed one level deeper by march (or by its MCTS, see 'march_mcts') or, at
+// the cutoff, solved.  A solve that runs out of its time budget starts
+// over with its simplified formula as new base formula, with a deeper
+// cutoff, and its subproblems start from what it learned (see
+// 'CaDiCaL::Checkpoint').  Simplify, cube and solve steps are tasks of a work-stealing
+// pool: a worker runs its own newest task first, which keeps the tree
+// depth first, and otherwise steals the oldest task of another worker.
+//
+// With '--serve <port>' the tasks are run by worker processes instead,
+// possibly on other hosts, which connect with '--connect <host:port>'
+// (see 'Coordinator' below).
+
+/*------------------------------------------------------------------------*/
+
+#include "cadical.hpp"
+#include "symbreak.hpp"
+#include "exhaustive.hpp"
+#include "checkpoint.hpp"
+
+extern "C" {
+#include "marchlib.h"
+}
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+using CaDiCaL::Solver;
+
+/*------------------------------------------------------------------------*/
+
+// Options and their defaults are the ones of 'parallel-solve.py'.
+
+struct Options {
+  int order = 0;                  // vertices, needed by the propagators
+  int m = 0;                      // variables to cube on
+  string solving_mode = "other";  // 'satcas', 'exhaustive-no-cas', 'other'
+  string cubing_mode = "march";   // 'march' or 'ams-native'
+  int mcts = 2;                   // simulations of 'ams-native'
+  char cutoff = 'd';              // depth or removed variables
+  int cutoffv = 5;
+  bool solve_after_cube = true;
+  int timeout = 3600;             // seconds per simplify or solve task
+  int conflicts = 10000;          // simplification conflict limit
+  int threads = 0;                // 0 for one per hardware thread
+};
+
+static Options opts;
+
+// Clauses as zero-terminated literal sequences.
+
+struct Formula {
+  int max_var = 0;
+  vector<int> lits;
+};
+
+typedef shared_ptr<const Formula> FormulaPtr;
+typedef shared_ptr<const CaDiCaL::Checkpoint> CheckpointPtr;
+
+struct Task {
+  enum Kind { SIMPLIFY, CUBE, SOLVE } kind;
+  FormulaPtr base;     // formula the cube applies to
+  vector<int> cube;
+  FormulaPtr formula;  // simplified formula of CUBE and SOLVE
+  int depth = 0;
+  int cutoffv = 0;
+  bool extension = false; // re-cubing a subproblem that timed out
+  CheckpointPtr warm;      // of the solve of 'base' that timed out
+};
+
+static struct {
+  atomic<long> simplified{0}, refuted{0}, cubed{0}, leaves{0};
+  atomic<long> satisfiable{0}, unsatisfiable{0}, recubed{0};
+  atomic<long> solutions{0};
+} stats;
+
+// The state of march_cube is global, so only one runs at a time.
+
+static mutex march_lock;
+static mutex output_lock;
+
+// A remote worker sends its messages and new tasks back to the
+// coordinator instead of printing and queuing them.
+
+static vector<string> *outlines;
+static vector<Task> *outbox;
+
+static void message (const char *fmt, ...) {
+  char line[512];
+  va_list ap;
+  va_start (ap, fmt);
+  vsnprintf (line, sizeof line, fmt, ap);
+  va_end (ap);
+  lock_guard<mutex> guard (output_lock);
+  if (outlines)
+    outlines->push_back (line);
+  else {
+    puts (line);
+    fflush (stdout);
+  }
+}
+
+static string cube_string (const vector<int> &cube) {
+  string res = "[";
+  for (size_t i = 0; i < cube.size (); i++) {
+    if (i)
+      res += ' ';
+    res += to_string (cube[i]);
+  }
+  return res + "]";
+}
+
+/*------------------------------------------------------------------------*/
+
+// Stops a solver once its task ran out of time.
+
+class Budget : public CaDiCaL::Terminator {
+  chrono::steady_clock::time_point deadline;
+
+public:
+  Budget (int seconds)
+      : deadline (chrono::steady_clock::now () + chrono::seconds (seconds)) {}
+  bool terminate () { return chrono::steady_clock::now () >= deadline; }
+};
+
+// The propagator of the solving mode, connected while this object lives.
+// It is quiet, since it would print outside of the lock of 'message'; the
+// workers report its solutions themselves.
+
+class Propagator {
+  unique_ptr<SymmetryBreaker> cas;
+  unique_ptr<ExhaustiveSearch> exhaustive;
+
+public:
+  Propagator (Solver *solver) {
+    if (opts.solving_mode == "satcas")
+      cas.reset (new SymmetryBreaker (solver, opts.order, 0, true));
+    else if (opts.solving_mode == "exhaustive-no-cas")
+      exhaustive.reset (new ExhaustiveSearch (solver, opts.order, true));
+  }
+  void load (const CaDiCaL::Checkpoint &checkpoint) {
+    if (cas)
+      cas->load (checkpoint);
+  }
+  void save (CaDiCaL::Checkpoint &checkpoint) const {
+    if (cas)
+      cas->save (checkpoint);
+  }
+  long solutions () const {
+    if (cas)
+      return cas->solutions ();
+    if (exhaustive)
+      return exhaustive->solutions ();
+    return 0;
+  }
+};
+
+// Collects the simplified formula as 'simplify-by-conflicts.sh' writes
+// it: the remaining clauses, together with the clauses of the extension
+// stack (only those of edge variables with orderly generation, and none
+// for the exhaustive search).  Also counts the removed variables up to
+// 'm', that is the witness variables of the extension stack.
+
+class Collector : public CaDiCaL::ClauseIterator,
+                  public CaDiCaL::WitnessIterator {
+  Formula &formula;
+  vector<bool> seen;
+
+public:
+  int removed = 0;
+
+  Collector (Formula &f) : formula (f), seen (opts.m + 1, false) {}
+
+  bool clause (const vector<int> &c) {
+    formula.lits.insert (formula.lits.end (), c.begin (), c.end ());
+    formula.lits.push_back (0);
+    return true;
+  }
+
+  bool witness (const vector<int> &c, const vector<int> &w, uint64_t) {
+    const int idx = abs (w.back ());
+    if (idx <= opts.m && !seen[idx]) {
+      seen[idx] = true;
+      removed++;
+    }
+    if (opts.solving_mode == "other" ||
+        (opts.solving_mode == "satcas" &&
+         idx <= opts.order * (opts.order - 1) / 2))
+      clause (c);
+    return true;
+  }
+};
+
+/*------------------------------------------------------------------------*/
+
+class Pool {
+  struct Worker {
+    mutex lock;
+    deque<Task> tasks;
+  };
+  vector<Worker> workers;
+
+  mutex lock;
+  condition_variable wakeup;
+  size_t queued = 0, running = 0;
+
+  bool pop (int worker, Task &task);
+  void work (int worker, const function<void (int, Task &)> &execute);
+
+public:
+  Pool (int threads) : workers (threads) {}
+  void push (int worker, Task task);
+  void run (const function<void (int, Task &)> &execute);
+};
+
+void Pool::push (int worker, Task task) {
+  {
+    lock_guard<mutex> guard (workers[worker].lock);
+    workers[worker].tasks.push_back (move (task));
+  }
+  {
+    lock_guard<mutex> guard (lock);
+    queued++;
+  }
+  wakeup.notify_one ();
+}
+
+// Every pop is preceded by taking one of the 'queued' tasks, so there is
+// a task left for it, although a scan can miss it while others push and
+// pop concurrently.
+
+bool Pool::pop (int worker, Task &task) {
+  const int n = workers.size ();
+  for (int i = 0; i < n; i++) {
+    Worker &w = workers[(worker + i) % n];
+    lock_guard<mutex> guard (w.lock);
+    if (w.tasks.empty ())
+      continue;
+    if (!i) {
+      task = move (w.tasks.back ());
+      w.tasks.pop_back ();
+    } else {
+      task = move (w.tasks.front ());
+      w.tasks.pop_front ();
+    }
+    return true;
+  }
+  return false;
+}
+
+void Pool::work (int worker, const function<void (int, Task &)> &execute) {
+  unique_lock<mutex> guard (lock);
+  for (;;) {
+    wakeup.wait (guard, [this] { return queued || !running; });
+    if (!queued)
+      break;
+    queued--;
+    running++;
+    guard.unlock ();
+    Task task;
+    while (!pop (worker, task))
+      this_thread::yield ();
+    execute (worker, task);
+    guard.lock ();
+    running--;
+    if (!queued && !running)
+      wakeup.notify_all ();
+  }
+}
+
+void Pool::run (const function<void (int, Task &)> &execute) {
+  vector<thread> threads;
+  for (size_t i = 0; i < workers.size (); i++)
+    threads.emplace_back (&Pool::work, this, (int) i, cref (execute));
+  for (auto &t : threads)
+    t.join ();
+}
+
+/*------------------------------------------------------------------------*/
+
+class Coordinator;
+
+static Pool *pool;
+static Coordinator *coordinator;
+
+static void push (int worker, Task task);
+
+static void load (Solver &solver, const Formula &formula,
+                  const CheckpointPtr &warm) {
+  solver.set ("quiet", 1);
+  solver.reserve (formula.max_var);
+  for (auto lit : formula.lits)
+    solver.add (lit);
+  if (warm)
+    warm->restore (&solver);
+}
+
+static void simplify (int worker, Task &task) {
+  Solver solver;
+  load (solver, *task.base, task.warm);
+  for (auto lit : task.cube)
+    solver.add (lit), solver.add (0);
+  solver.limit ("conflicts", opts.conflicts);
+  Budget budget (opts.timeout);
+  solver.connect_terminator (&budget);
+
+  int res;
+  {
+    Propagator propagator (&solver);
+    if (task.warm)
+      propagator.load (*task.warm);
+    res = solver.solve ();
+    stats.solutions += propagator.solutions ();
+  }
+  stats.simplified++;
+
+  const string cube = cube_string (task.cube);
+  if (res == 20) {
+    stats.refuted++;
+    message ("c cube %s is UNSAT", cube.c_str ());
+    return;
+  }
+  if (res == 10) {
+    stats.satisfiable++;
+    message ("c cube %s is SAT", cube.c_str ());
+    return;
+  }
+
+  Formula *simplified = new Formula;
+  simplified->max_var = solver.vars ();
+  Collector collector (*simplified);
+  solver.traverse_clauses (collector);
+  solver.traverse_witnesses_backward (collector);
+  FormulaPtr formula (simplified);
+
+  int cutoffv = task.cutoffv;
+  if (task.extension)
+    cutoffv = opts.cutoff == 'v' ? collector.removed + 20 : opts.cutoffv + 5;
+  message ("c cube %s: %d variables removed", cube.c_str (),
+           collector.removed);
+
+  if ((opts.cutoff == 'd' && task.depth >= cutoffv) ||
+      (opts.cutoff == 'v' && collector.removed >= cutoffv)) {
+    stats.leaves++;
+    if (opts.solve_after_cube) {
+      Task solve;
+      solve.kind = Task::SOLVE;
+      solve.cube = task.cube;
+      solve.formula = formula;
+      solve.warm = task.warm;
+      push (worker, move (solve));
+    }
+    return;
+  }
+
+  task.kind = Task::CUBE;
+  task.formula = formula;
+  task.cutoffv = cutoffv;
+  task.extension = false;
+  push (worker, move (task));
+}
+
+// Cube the simplified formula one level deep, and simplify the children,
+// as cubes on the base formula.
+
+static void cube (int worker, Task &task) {
+  const Formula &f = *task.formula;
+  march_ctx *ctx = march_ctx_new ();
+  ctx->quiet_mode = LIBRARY_MODE; // the cubes go to 'out' only
+  march_load_clauses (ctx, f.lits.data (), f.lits.size ());
+
+  char *buffer = 0;
+  size_t size = 0;
+  FILE *out = open_memstream (&buffer, &size);
+  int res;
+  if (opts.cubing_mode == "ams-native") {
+    ctx->threads = 1;
+    res = march_mcts (ctx, 0, 0, 1, 0, opts.m, opts.mcts, out);
+  } else {
+    lock_guard<mutex> guard (march_lock);
+    res = march_cube (ctx, 0, 0, 1, opts.m, out);
+  }
+  fclose (out);
+  march_ctx_free (ctx);
+  stats.cubed++;
+
+  const string name = cube_string (task.cube);
+  if (res == 20) {
+    stats.refuted++;
+    message ("c cube %s is UNSAT", name.c_str ());
+    free (buffer);
+    return;
+  }
+
+  vector<Task> children;
+  istringstream lines (string (buffer, size));
+  free (buffer);
+  string line;
+  while (getline (lines, line)) {
+    if (line.compare (0, 2, "a "))
+      continue;
+    Task child;
+    child.kind = Task::SIMPLIFY;
+    child.base = task.base;
+    child.cube = task.cube;
+    child.depth = task.depth + 1;
+    child.cutoffv = task.cutoffv;
+    child.warm = task.warm;
+    istringstream lits (line.substr (2));
+    int lit;
+    while (lits >> lit && lit)
+      child.cube.push_back (lit);
+    if (child.cube.size () > task.cube.size ())
+      children.push_back (move (child));
+  }
+
+  // Nothing to branch on (no cubes, or only the empty one): solve it as
+  // it is.
+
+  if (children.empty ()) {
+    task.kind = Task::SOLVE;
+    push (worker, move (task));
+    return;
+  }
+
+  for (auto &child : children)
+    push (worker, move (child));
+}
+
+static void solve (int worker, Task &task) {
+  Solver solver;
+  load (solver, *task.formula, task.warm);
+  Budget budget (opts.timeout);
+  solver.connect_terminator (&budget);
+
+  int res;
+  CaDiCaL::Checkpoint *checkpoint = 0;
+  {
+    Propagator propagator (&solver);
+    if (task.warm)
+      propagator.load (*task.warm);
+    res = solver.solve ();
+    stats.solutions += propagator.solutions ();
+    if (!res) {
+      checkpoint = new CaDiCaL::Checkpoint;
+      propagator.save (*checkpoint);
+    }
+  }
+
+  const string cube = cube_string (task.cube);
+  if (res == 10) {
+    stats.satisfiable++;
+    message ("c cube %s solved: SATISFIABLE", cube.c_str ());
+  } else if (res == 20) {
+    stats.unsatisfiable++;
+    message ("c cube %s solved: UNSATISFIABLE", cube.c_str ());
+  } else {
+    stats.recubed++;
+    message ("c cube %s timed out, continue cubing this subproblem",
+             cube.c_str ());
+    Task recube;
+    recube.kind = Task::SIMPLIFY;
+    recube.base = task.formula;
+    recube.cutoffv = opts.cutoffv;
+    recube.extension = true;
+    checkpoint->capture (&solver);
+    recube.warm.reset (checkpoint);
+    push (worker, move (recube));
+  }
+}
+
+static void execute (int worker, Task &task) {
+  switch (task.kind) {
+  case Task::SIMPLIFY:
+    simplify (worker, task);
+    break;
+  case Task::CUBE:
+    cube (worker, task);
+    break;
+  case Task::SOLVE:
+    solve (worker, task);
+    break;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+
+static void error (const char *fmt, ...) {
+  va_list ap;
+  va_start (ap, fmt);
+  fputs ("cnc: error: ", stderr);
+  vfprintf (stderr, fmt, ap);
+  va_end (ap);
+  fputc ('\n', stderr);
+  exit (1);
+}
+
+static bool parse_dimacs (const char *path, Formula &formula) {
+  FILE *file = fopen (path, "r");
+  if (!file)
+    return false;
+  int ch, clauses = -1;
+  while ((ch = getc (file)) == 'c' || ch == 'p') {
+    if (ch == 'p' && fscanf (file, " cnf %d %d", &formula.max_var, &clauses) != 2)
+      break;
+    while ((ch = getc (file)) != '\n' && ch != EOF)
+      ;
+  }
+  if (ch != EOF)
+    ungetc (ch, file);
+  int lit;
+  while (fscanf (file, "%d", &lit) == 1) {
+    formula.lits.push_back (lit);
+    if (abs (lit) > formula.max_var)
+      formula.max_var = abs (lit);
+  }
+  fclose (file);
+  return clauses >= 0 && (formula.lits.empty () || !formula.lits.back ());
+}
+
+static void usage () {
+  printf (
+      "usage: cnc [order] <file> -m <int> [<option> ...]\n"
+      "   or: cnc --connect <host>:<port>\n"
+      "\n"
+      "Cube-and-conquer in one process, see 'parallel-solve.py' for the\n"
+      "pipeline.  The file is a CNF, or a list of CNF files to solve.\n"
+      "\n"
+      "  -m <int>                      variables to consider for cubing\n"
+      "  --solving-mode <mode>         satcas, exhaustive-no-cas or other\n"
+      "  --cubing-mode <mode>          march or ams-native\n"
+      "  --numMCTS <int>               MCTS simulations of ams-native [2]\n"
+      "  --cutoff <d|v>                depth or removed variables [d]\n"
+      "  --cutoffv <int>               cutoff value [5]\n"
+      "  --solveaftercube <True|False> solve the leaves [True]\n"
+      "  --timeout <int>               seconds per solve [3600]\n"
+      "  --conflicts <int>             simplification conflicts [10000]\n"
+      "  --threads <int>               workers [hardware threads]\n"
+      "  --serve <port>                let worker processes run the tasks\n"
+      "\n"
+      "With '--connect' this process is a worker of the coordinator\n"
+      "serving on the port, and takes its options from there.  There is\n"
+      "no authentication, so only serve on trusted networks.\n");
+}
+
+static int parse_int (const char *arg, const char *option) {
+  char *end;
+  long val = arg ? strtol (arg, &end, 10) : 0;
+  if (!arg || !*arg || *end || val < 0 || val > INT32_MAX)
+    error ("invalid argument to '%s'", option);
+  return val;
+}
+
+/*------------------------------------------------------------------------*/
+
+// Distributed mode.  The coordinator ('--serve') keeps the tasks, and has
+// a thread per connected worker process ('--connect') which sends the
+// worker one task at a time and queues the tasks the worker sends back,
+// together with its messages and statistics.  Base formulas are sent to
+// each worker once and referred to by an identifier afterwards.  If the
+// connection to a worker fails, its task is queued again for the others
+// (sockets use TCP keep-alive to notice hosts which went down).
+//
+// Messages are sequences of 32-bit words in network byte order, preceded
+// by their number of words.
+
+enum { HELLO = 1, TASK, RESULT, DONE };
+
+class Message {
+  vector<uint32_t> words;
+  size_t pos = 0;
+
+public:
+  bool ok = true; // no read past the end or invalid data
+
+  void put (int val) { words.push_back (val); }
+  void put64 (uint64_t val) { put (val >> 32), put ((uint32_t) val); }
+  int get () {
+    if (pos < words.size ())
+      return words[pos++];
+    ok = false;
+    return 0;
+  }
+  uint64_t get64 () {
+    const uint64_t hi = (uint32_t) get ();
+    return hi << 32 | (uint32_t) get ();
+  }
+
+  // Size of a sequence of elements of 'width' words each.
+  //
+  int size (int width = 1) {
+    const int res = get ();
+    if (res < 0 || (size_t) res * width > words.size () - pos)
+      ok = false;
+    return ok ? res : 0;
+  }
+
+  bool send (int fd) const;
+  bool receive (int fd);
+};
+
+static bool write_all (int fd, const char *data, size_t bytes) {
+  while (bytes) {
+    const ssize_t n = ::send (fd, data, bytes, MSG_NOSIGNAL);
+    if (n <= 0)
+      return false;
+    data += n, bytes -= n;
+  }
+  return true;
+}
+
+static bool read_all (int fd, char *data, size_t bytes) {
+  while (bytes) {
+    const ssize_t n = recv (fd, data, bytes, 0);
+    if (n <= 0)
+      return false;
+    data += n, bytes -= n;
+  }
+  return true;
+}
+
+bool Message::send (int fd) const {
+  vector<uint32_t> buffer (words.size () + 1);
+  buffer[0] = htonl (words.size ());
+  for (size_t i = 0; i < words.size (); i++)
+    buffer[i + 1] = htonl (words[i]);
+  return write_all (fd, (const char *) buffer.data (),
+                    buffer.size () * sizeof (uint32_t));
+}
+
+bool Message::receive (int fd) {
+  uint32_t header;
+  if (!read_all (fd, (char *) &header, sizeof header))
+    return false;
+  const uint32_t n = ntohl (header);
+  if (n > (1u << 30))
+    return false;
+  words.resize (n);
+  pos = 0;
+  ok = true;
+  if (!read_all (fd, (char *) words.data (), n * sizeof (uint32_t)))
+    return false;
+  for (auto &word : words)
+    word = ntohl (word);
+  return true;
+}
+
+template <class T> static void put (Message &msg, const vector<T> &vals) {
+  msg.put (vals.size ());
+  for (const auto &val : vals)
+    msg.put (val);
+}
+
+template <class T> static void get (Message &msg, vector<T> &vals) {
+  vals.resize (msg.size ());
+  for (auto &val : vals)
+    val = msg.get ();
+}
+
+static void put (Message &msg, const string &str) {
+  put (msg, vector<char> (str.begin (), str.end ()));
+}
+
+static string get_string (Message &msg) {
+  vector<char> chars;
+  get (msg, chars);
+  return string (chars.begin (), chars.end ());
+}
+
+// The formulas both ends know by identifier.
+
+typedef map<uint64_t, FormulaPtr> Formulas;
+
+// A formula not known yet is sent in full, and becomes known under 'id'
+// unless that is zero.
+
+static void put (Message &msg, const FormulaPtr &formula, Formulas &known,
+                 uint64_t id) {
+  if (!formula) {
+    msg.put (0);
+    return;
+  }
+  for (const auto &entry : known)
+    if (entry.second == formula) {
+      msg.put (1);
+      msg.put64 (entry.first);
+      return;
+    }
+  msg.put (2);
+  msg.put64 (id);
+  msg.put (formula->max_var);
+  put (msg, formula->lits);
+  if (id)
+    known[id] = formula;
+}
+
+static FormulaPtr get_formula (Message &msg, Formulas &known) {
+  const int tag = msg.get ();
+  if (tag == 1) {
+    auto it = known.find (msg.get64 ());
+    if (it != known.end ())
+      return it->second;
+  } else if (tag == 2) {
+    const uint64_t id = msg.get64 ();
+    shared_ptr<Formula> formula (new Formula);
+    formula->max_var = msg.get ();
+    get (msg, formula->lits);
+    if (id && msg.ok)
+      known[id] = formula;
+    return formula;
+  } else if (!tag)
+    return 0;
+  msg.ok = false;
+  return 0;
+}
+
+static void put (Message &msg, const CheckpointPtr &checkpoint) {
+  msg.put (checkpoint != 0);
+  if (!checkpoint)
+    return;
+  msg.put (checkpoint->max_var);
+  put (msg, checkpoint->units);
+  put (msg, checkpoint->learned);
+  put (msg, checkpoint->phases);
+  msg.put (checkpoint->hashes.size ());
+  for (const auto &set : checkpoint->hashes) {
+    msg.put (set.size ());
+    for (auto hash : set)
+      msg.put64 (hash);
+  }
+}
+
+static CheckpointPtr get_checkpoint (Message &msg) {
+  if (!msg.get ())
+    return 0;
+  shared_ptr<CaDiCaL::Checkpoint> checkpoint (new CaDiCaL::Checkpoint);
+  checkpoint->max_var = msg.get ();
+  get (msg, checkpoint->units);
+  get (msg, checkpoint->learned);
+  get (msg, checkpoint->phases);
+  checkpoint->hashes.resize (msg.size ());
+  for (auto &set : checkpoint->hashes) {
+    set.resize (msg.size (2));
+    for (auto &hash : set)
+      hash = msg.get64 ();
+  }
+  if (checkpoint->phases.size () != (size_t) checkpoint->max_var + 1)
+    msg.ok = false;
+  return checkpoint;
+}
+
+// The coordinator makes the base formulas of the tasks it sends known.
+
+static void put (Message &msg, const Task &task, Formulas &known,
+                 bool coordinating) {
+  msg.put (task.kind);
+  msg.put (task.depth);
+  msg.put (task.cutoffv);
+  msg.put (task.extension);
+  put (msg, task.cube);
+  put (msg, task.base, known,
+       coordinating ? (uint64_t) (uintptr_t) task.base.get () : 0);
+  put (msg, task.formula, known, 0);
+  put (msg, task.warm);
+}
+
+static bool get (Message &msg, Task &task, Formulas &known) {
+  const int kind = msg.get ();
+  task.kind = (Task::Kind) kind;
+  task.depth = msg.get ();
+  task.cutoffv = msg.get ();
+  task.extension = msg.get ();
+  get (msg, task.cube);
+  task.base = get_formula (msg, known);
+  task.formula = get_formula (msg, known);
+  task.warm = get_checkpoint (msg);
+  if (kind < Task::SIMPLIFY || kind > Task::SOLVE)
+    return false;
+  if (kind == Task::SIMPLIFY ? !task.base : !task.formula)
+    return false;
+  return msg.ok;
+}
+
+static void put_options (Message &msg) {
+  msg.put (opts.order);
+  msg.put (opts.m);
+  put (msg, opts.solving_mode);
+  put (msg, opts.cubing_mode);
+  msg.put (opts.mcts);
+  msg.put (opts.cutoff);
+  msg.put (opts.cutoffv);
+  msg.put (opts.solve_after_cube);
+  msg.put (opts.timeout);
+  msg.put (opts.conflicts);
+}
+
+static void get_options (Message &msg) {
+  opts.order = msg.get ();
+  opts.m = msg.get ();
+  opts.solving_mode = get_string (msg);
+  opts.cubing_mode = get_string (msg);
+  opts.mcts = msg.get ();
+  opts.cutoff = msg.get ();
+  opts.cutoffv = msg.get ();
+  opts.solve_after_cube = msg.get ();
+  opts.timeout = msg.get ();
+  opts.conflicts = msg.get ();
+}
+
+static atomic<long> *const counters[] = {
+    &stats.simplified,    &stats.refuted,        &stats.cubed,
+    &stats.leaves,        &stats.satisfiable,    &stats.unsatisfiable,
+    &stats.recubed,       &stats.solutions};
+
+static const int num_counters = sizeof counters / sizeof *counters;
+
+/*------------------------------------------------------------------------*/
+
+// The queue of the coordinator, newest task first as in 'Pool'.
+
+class Coordinator {
+  mutex lock;
+  condition_variable wakeup;
+  deque<Task> tasks;
+  size_t running = 0;
+  bool all_done = false;
+
+public:
+  void push (Task task) {
+    {
+      lock_guard<mutex> guard (lock);
+      tasks.push_back (move (task));
+    }
+    wakeup.notify_one ();
+  }
+
+  // Waits for a task, and returns false once there are none left.
+  //
+  bool pop (Task &task) {
+    unique_lock<mutex> guard (lock);
+    wakeup.wait (guard, [this] { return !tasks.empty () || !running; });
+    if (tasks.empty ()) {
+      all_done = true;
+      wakeup.notify_all ();
+      return false;
+    }
+    task = move (tasks.back ());
+    tasks.pop_back ();
+    running++;
+    return true;
+  }
+
+  // Called after the tasks sent back for a popped task are pushed.
+  //
+  void done () {
+    lock_guard<mutex> guard (lock);
+    if (!--running && tasks.empty ())
+      wakeup.notify_all ();
+  }
+
+  void wait () {
+    unique_lock<mutex> guard (lock);
+    wakeup.wait (guard, [this] { return tasks.empty () && !running; });
+    all_done = true;
+    wakeup.notify_all ();
+  }
+
+  bool finished () {
+    lock_guard<mutex> guard (lock);
+    return all_done;
+  }
+};
+
+static void push (int worker, Task task) {
+  if (outbox)
+    outbox->push_back (move (task));
+  else if (coordinator)
+    coordinator->push (move (task));
+  else
+    pool->push (worker, move (task));
+}
+
+static void serve_worker (int fd, int id) {
+  Formulas known;
+  Message hello;
+  hello.put (HELLO);
+  put_options (hello);
+  if (!hello.send (fd)) {
+    close (fd);
+    return;
+  }
+  message ("c worker %d connected", id);
+
+  Task task;
+  while (coordinator->pop (task)) {
+    Message request, reply;
+    request.put (TASK);
+    put (request, task, known, true);
+    bool ok = request.send (fd) && reply.receive (fd) &&
+              reply.get () == RESULT;
+
+    long deltas[num_counters];
+    for (auto &delta : deltas)
+      delta = reply.get64 ();
+    vector<string> lines (reply.size ());
+    for (auto &line : lines)
+      line = get_string (reply);
+    vector<Task> tasks (reply.size ());
+    for (auto &t : tasks)
+      ok = ok && get (reply, t, known);
+
+    if (!ok || !reply.ok) {
+      message ("c worker %d lost, queuing cube %s again", id,
+               cube_string (task.cube).c_str ());
+      coordinator->push (move (task));
+      coordinator->done ();
+      close (fd);
+      return;
+    }
+    for (const auto &line : lines)
+      message ("%s", line.c_str ());
+    for (int i = 0; i < num_counters; i++)
+      *counters[i] += deltas[i];
+    for (auto &t : tasks)
+      coordinator->push (move (t));
+    coordinator->done ();
+  }
+
+  Message done;
+  done.put (DONE);
+  done.send (fd);
+  close (fd);
+}
+
+static void serve (int port) {
+  addrinfo hints, *addresses;
+  memset (&hints, 0, sizeof hints);
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = AI_PASSIVE;
+  if (getaddrinfo (0, to_string (port).c_str (), &hints, &addresses))
+    error ("can not resolve port %d", port);
+  const int listener = socket (AF_INET, SOCK_STREAM, 0);
+  const int yes = 1;
+  setsockopt (listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof yes);
+  if (listener < 0 ||
+      bind (listener, addresses->ai_addr, addresses->ai_addrlen) ||
+      listen (listener, 64))
+    error ("can not listen on port %d: %s", port, strerror (errno));
+  freeaddrinfo (addresses);
+  message ("c serving on port %d", port);
+
+  vector<thread> workers;
+  thread acceptor ([&] {
+    pollfd pfd = {listener, POLLIN, 0};
+    while (!coordinator->finished ()) {
+      if (poll (&pfd, 1, 200) <= 0)
+        continue;
+      const int fd = accept (listener, 0, 0);
+      if (fd < 0)
+        continue;
+      setsockopt (fd, SOL_SOCKET, SO_KEEPALIVE, &yes, sizeof yes);
+      workers.emplace_back (serve_worker, fd, (int) workers.size ());
+    }
+  });
+
+  coordinator->wait ();
+  acceptor.join ();
+  for (auto &t : workers)
+    t.join ();
+  close (listener);
+}
+
+// A worker keeps trying to connect for a minute, so it can be started
+// before the coordinator.
+
+static int connect_to (const char *address) {
+  const char *colon = strrchr (address, ':');
+  if (!colon || colon == address)
+    error ("expected '<host>:<port>' but got '%s'", address);
+  const string host (address, colon);
+  addrinfo hints, *addresses;
+  memset (&hints, 0, sizeof hints);
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  for (int attempt = 0; attempt < 60; attempt++) {
+    if (attempt)
+      this_thread::sleep_for (chrono::seconds (1));
+    if (getaddrinfo (host.c_str (), colon + 1, &hints, &addresses))
+      continue;
+    for (addrinfo *a = addresses; a; a = a->ai_next) {
+      const int fd = socket (a->ai_family, a->ai_socktype, a->ai_protocol);
+      if (fd < 0)
+        continue;
+      if (!connect (fd, a->ai_addr, a->ai_addrlen)) {
+        freeaddrinfo (addresses);
+        const int yes = 1;
+        setsockopt (fd, SOL_SOCKET, SO_KEEPALIVE, &yes, sizeof yes);
+        return fd;
+      }
+      close (fd);
+    }
+    freeaddrinfo (addresses);
+  }
+  error ("can not connect to '%s'", address);
+  return -1;
+}
+
+static int work_remotely (const char *address) {
+  const int fd = connect_to (address);
+  Message hello;
+  if (!hello.receive (fd) || hello.get () != HELLO)
+    error ("no greeting from '%s'", address);
+  get_options (hello);
+  if (!hello.ok)
+    error ("invalid options from '%s'", address);
+  printf ("c connected to '%s'\n", address);
+  fflush (stdout);
+
+  Formulas known;
+  long executed = 0;
+  for (;;) {
+    Message request;
+    if (!request.receive (fd))
+      error ("lost connection to '%s'", address);
+    const int kind = request.get ();
+    if (kind == DONE)
+      break;
+    Task task;
+    if (kind != TASK || !get (request, task, known))
+      error ("invalid task from '%s'", address);
+
+    long before[num_counters];
+    for (int i = 0; i < num_counters; i++)
+      before[i] = *counters[i];
+    vector<string> lines;
+    vector<Task> tasks;
+    outlines = &lines;
+    outbox = &tasks;
+    execute (0, task);
+    outlines = 0;
+    outbox = 0;
+    executed++;
+
+    Message reply;
+    reply.put (RESULT);
+    for (int i = 0; i < num_counters; i++)
+      reply.put64 (*counters[i] - before[i]);
+    reply.put (lines.size ());
+    for (const auto &line : lines)
+      put (reply, line);
+    reply.put (tasks.size ());
+    for (const auto &t : tasks)
+      put (reply, t, known, false);
+    if (!reply.send (fd))
+      error ("lost connection to '%s'", address);
+  }
+  close (fd);
+  printf ("c executed %ld tasks\n", executed);
+  return 0;
+}
+
+int main (int argc, char **argv) {
+  vector<const char *> positional;
+  bool m_specified = false;
+  const char *address = 0;
+  int port = 0;
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *val = i + 1 < argc ? argv[i + 1] : 0;
+    if (!strcmp (arg, "-h") || !strcmp (arg, "--help")) {
+      usage ();
+      return 0;
+    } else if (!strcmp (arg, "-m"))
+      opts.m = parse_int (val, arg), m_specified = true, i++;
+    else if (!strcmp (arg, "--solving-mode") && val)
+      opts.solving_mode = val, i++;
+    else if (!strcmp (arg, "--cubing-mode") && val)
+      opts.cubing_mode = val, i++;
+    else if (!strcmp (arg, "--numMCTS"))
+      opts.mcts = parse_int (val, arg), i++;
+    else if (!strcmp (arg, "--cutoff") && val && (!strcmp (val, "d") || !strcmp (val, "v")))
+      opts.cutoff = *val, i++;
+    else if (!strcmp (arg, "--cutoffv"))
+      opts.cutoffv = parse_int (val, arg), i++;
+    else if (!strcmp (arg, "--solveaftercube") && val && (!strcmp (val, "True") || !strcmp (val, "False")))
+      opts.solve_after_cube = !strcmp (val, "True"), i++;
+    else if (!strcmp (arg, "--timeout"))
+      opts.timeout = parse_int (val, arg), i++;
+    else if (!strcmp (arg, "--conflicts"))
+      opts.conflicts = parse_int (val, arg), i++;
+    else if (!strcmp (arg, "--threads"))
+      opts.threads = parse_int (val, arg), i++;
+    else if (!strcmp (arg, "--serve")) {
+      port = parse_int (val, arg), i++;
+      if (!port || port > 65535)
+        error ("invalid port %d", port);
+    } else if (!strcmp (arg, "--connect") && val)
+      address = val, i++;
+    else if (arg[0] == '-')
+      error ("invalid option '%s' (try '-h')", arg);
+    else
+      positional.push_back (arg);
+  }
+
+  if (address) {
+    if (argc != 3)
+      error ("a worker takes its options from the coordinator");
+    return work_remotely (address);
+  }
+
+  if (positional.size () == 2)
+    opts.order = parse_int (positional[0], "order");
+  else if (positional.size () != 1)
+    error ("expected '[order] <file>' (try '-h')");
+  const char *path = positional.back ();
+
+  if (!m_specified)
+    error ("the -m option is required");
+  if (opts.solving_mode == "sms" || opts.solving_mode == "smsd2")
+    error ("solving mode '%s' runs 'smsg', use 'parallel-solve.py'",
+           opts.solving_mode.c_str ());
+  if (opts.solving_mode != "satcas" &&
+      opts.solving_mode != "exhaustive-no-cas" &&
+      opts.solving_mode != "other")
+    error ("invalid solving mode '%s'", opts.solving_mode.c_str ());
+  if (opts.cubing_mode != "march" && opts.cubing_mode != "ams-native")
+    error ("invalid cubing mode '%s'", opts.cubing_mode.c_str ());
+  if (opts.solving_mode != "other" && !opts.order)
+    error ("order is required with solving mode '%s'",
+           opts.solving_mode.c_str ());
+  if (!opts.threads)
+    opts.threads = max (1u, thread::hardware_concurrency ());
+
+  if (port)
+    coordinator = new Coordinator;
+  else
+    pool = new Pool (opts.threads);
+
+  // A list of files is solved right away, a CNF is cubed from the root.
+
+  FILE *file = fopen (path, "r");
+  if (!file)
+    error ("can not read '%s'", path);
+  char first[4096] = "";
+  if (!fgets (first, sizeof first, file))
+    error ("'%s' is empty", path);
+  const bool cnf = !strncmp (first, "p cnf", 5);
+  fclose (file);
+
+  if (cnf) {
+    shared_ptr<Formula> formula (new Formula);
+    if (!parse_dimacs (path, *formula))
+      error ("can not parse '%s'", path);
+    Task root;
+    root.kind = Task::SIMPLIFY;
+    root.base = formula;
+    root.cutoffv = opts.cutoffv;
+    push (0, move (root));
+  } else {
+    ifstream list (path);
+    string name;
+    int worker = 0;
+    while (list >> name) {
+      shared_ptr<Formula> formula (new Formula);
+      if (!parse_dimacs (name.c_str (), *formula))
+        error ("can not parse '%s'", name.c_str ());
+      Task solve;
+      solve.kind = Task::SOLVE;
+      solve.formula = formula;
+      push (worker++ % opts.threads, move (solve));
+    }
+  }
+
+  if (port) {
+    serve (port);
+    delete coordinator;
+  } else {
+    pool->run (execute);
+    delete pool;
+  }
+
+  printf ("c %ld simplified, %ld refuted, %ld cubed, %ld leaves, %ld "
+          "re-cubed\n",
+          stats.simplified.load (), stats.refuted.load (),
+          stats.cubed.load (), stats.leaves.load (), stats.recubed.load ());
+  printf ("c %ld solved SAT, %ld solved UNSAT, %ld solutions\n",
+          stats.satisfiable.load (), stats.unsatisfiable.load (),
+          stats.solutions.load ());
+
+  int res = 0;
+  if (stats.satisfiable)
+    res = 10, printf ("s SATISFIABLE\n");
+  else if (opts.solve_after_cube || !stats.leaves)
+    res = 20, printf ("s UNSATISFIABLE\n");
+  else
+    printf ("c UNKNOWN\n");
+  return res;
+}
@@ -49,6 +49,16 @@ else
     cd -
 fi
 
+# Check if the cube-and-conquer driver is present
+if [ -f cnc/cnc ]
+then
+    echo "cnc installed and binary file compiled"
+else
+    cd cnc
+    make
+    cd -
+fi
+
 # Install maplesat-ks
 if [ -d maplesat-ks ] && [ -f maplesat-ks/simp/maplesat_static ]
 then
@@ -25,6 +25,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "simp/SimpSolver.h"
 #include "core/Dimacs.h"
 #include "utils/System.h"
+#include "utils/Sampler.h"
 
 #define MAXORDER 39
 
@@ -431,6 +432,7 @@ void Solver::removeClause(CRef cr) {
     Clause& c = ca[cr];
 
     if (output != NULL) {
+      SamplerFrame frame(Sampler::proof);
       fprintf(output, "d ");
       for (int i = 0; i < c.size(); i++)
         fprintf(output, "%i ", (var(c[i]) + 1) * (-2 * sign(c[i]) + 1));
@@ -827,7 +829,9 @@ void Solver::callbackFunction(bool complete, vec<vec<Lit> >& out_learnts) {
             int p[i+1]; // Permutation on i+1 vertices
             int x, y;   // These will be the indices of first adjacency matrix entry that demonstrates noncanonicity (when such indices exist)
             int mi;     // This will be the index of the maximum defined entry of p
+            Sampler::enter(Sampler::canonical(i+1));
             bool ret = (hash == 0) ? true : is_canonical(i+1, p, x, y, mi);
+            Sampler::leave();
 #ifdef VERBOSE
             if(!ret) {
                 printf("x: %d y: %d, mi: %d, ", x, y, mi);
@@ -985,7 +989,9 @@ void Solver::callbackFunction(bool complete, vec<vec<Lit> >& out_learnts) {
         for(int j=0; j<n; j++) P[j] = -1;
 
         const double before = cpuTime();
+        Sampler::enter(Sampler::mus(g));
         bool ret = has_gub_subgraph(n, P, p, g);
+        Sampler::leave();
         const double after = cpuTime();
         gubtime += (after-before);
 
@@ -1735,6 +1741,7 @@ void Solver::rebuildOrderHeap()
 |________________________________________________________________________________________________@*/
 bool Solver::simplify()
 {
+    SamplerFrame frame(Sampler::simplify);
     assert(decisionLevel() == 0);
 
     if (!ok || propagate() != CRef_Undef)
@@ -1771,6 +1778,7 @@ bool Solver::simplify()
 |________________________________________________________________________________________________@*/
 lbool Solver::search(int nof_conflicts)
 {
+    SamplerFrame frame(Sampler::search);
     assert(ok);
     int         backtrack_level;
     int         conflictC = 0;
@@ -1834,6 +1842,7 @@ lbool Solver::search(int nof_conflicts)
                 uncheckedEnqueue(learnt_clause[0], cr);
             }
             if (output != NULL) {
+              SamplerFrame frame(Sampler::proof);
               for (int i = 0; i < learnt_clause.size(); i++)
                 fprintf(output, "%i " , (var(learnt_clause[i]) + 1) *
                                   (-2 * sign(learnt_clause[i]) + 1) );
@@ -1948,6 +1957,7 @@ lbool Solver::search(int nof_conflicts)
                         int curlevel;
                         learnt_clause.clear();
                         if (output != NULL /*&& opt_trust_blocking*/) {
+                          SamplerFrame frame(Sampler::proof);
                           fprintf(output, "t ");
                           for (int j = 0; j < callbackLearntClauses[i].size(); j++)
                             fprintf(output, "%i " , (var(callbackLearntClauses[i][j]) + 1) *
@@ -1957,6 +1967,7 @@ lbool Solver::search(int nof_conflicts)
                         proofsize += 2+clausestrlen(callbackLearntClauses[i]);
                         analyze(callbackLearntClauses[i], learnt_clause, curlevel);
                         if (output != NULL) {
+                          SamplerFrame frame(Sampler::proof);
                           for (int j = 0; j < learnt_clause.size(); j++)
                             fprintf(output, "%i " , (var(learnt_clause[j]) + 1) *
                                               (-2 * sign(learnt_clause[j]) + 1) );
@@ -1964,6 +1975,7 @@ lbool Solver::search(int nof_conflicts)
                         }
                         proofsize += clausestrlen(learnt_clause);
                         if (output != NULL && opt_keep_blocking < 2) {
+                          SamplerFrame frame(Sampler::proof);
                           fprintf(output, "d ");
                           for (int j = 0; j < callbackLearntClauses[i].size(); j++)
                             fprintf(output, "%i " , (var(callbackLearntClauses[i][j]) + 1) *
@@ -2284,6 +2296,32 @@ void Solver::toDimacs(FILE* f, const vec<Lit>& assumps)
 }
 
 
+//=================================================================================================
+// JSON statistics (see '-stats-json' in 'simp/Main.cc'):
+
+
+// Entry i of the arrays is order i+1 and graph i respectively.
+void Solver::statsJson(FILE* f)
+{
+    fprintf(f, "  \"conflicts\": %" PRIu64 ",\n", conflicts);
+    fprintf(f, "  \"decisions\": %" PRIu64 ",\n", decisions);
+    fprintf(f, "  \"propagations\": %" PRIu64 ",\n", propagations);
+    fprintf(f, "  \"proof_size\": %ld", proofsize);
+    if (n == 0)
+        return;
+    fprintf(f, ",\n  \"order\": %d,\n  \"solutions\": %ld,\n  \"canonical\": [", n, numsols);
+    for (int i = 0; i < n; i++)
+        fprintf(f, "%s%ld", i ? ", " : "", canonarr[i]);
+    fprintf(f, "],\n  \"noncanonical\": [");
+    for (int i = 0; i < n; i++)
+        fprintf(f, "%s%ld", i ? ", " : "", noncanonarr[i]);
+    fprintf(f, "],\n  \"canonicity_time\": %g,\n  \"mus\": [", canontime + noncanontime);
+    for (int g = 0; g < opt_check_gub; g++)
+        fprintf(f, "%s%ld", g ? ", " : "", gubcounts[g]);
+    fprintf(f, "],\n  \"mus_time\": %g", gubtime);
+}
+
+
 //=================================================================================================
 // Garbage Collection methods:
 
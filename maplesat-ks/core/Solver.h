@@ -76,6 +76,8 @@ public:
     void    toDimacs     (const char* file, Lit p);
     void    toDimacs     (const char* file, Lit p, Lit q);
     void    toDimacs     (const char* file, Lit p, Lit q, Lit r);
+
+    void    statsJson    (FILE* f);                 // Write the search and orderly generation statistics as JSON members.
     
     // Variable mode:
     // 
@@ -29,6 +29,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "utils/Options.h"
 #include "core/Dimacs.h"
 #include "simp/SimpSolver.h"
+#include "utils/Sampler.h"
 
 using namespace Minisat;
 
@@ -57,6 +58,32 @@ void printStats(Solver& solver)
 }
 
 
+// A summary of the run for scripts, instead of scraping the log.
+static void writeStatsJson(const char* path, const char* input, SimpSolver& S, lbool ret)
+{
+    FILE* f = fopen(path, "w");
+    if (f == NULL){
+        printf("WARNING! Could not write statistics to: %s\n", path);
+        return; }
+    fprintf(f, "{\n  \"solver\": \"maplesat-ks\",\n  \"input\": \"");
+    for (const char* p = input; *p; p++)
+        fprintf(f, *p == '"' || *p == '\\' ? "\\%c" : "%c", *p);
+    fprintf(f, "\",\n  \"result\": \"%s\",\n", ret == l_True ? "SATISFIABLE" : ret == l_False ? "UNSATISFIABLE" : "UNKNOWN");
+    fprintf(f, "  \"exit\": %d,\n", ret == l_True ? 10 : ret == l_False ? 20 : 0);
+    fprintf(f, "  \"process_time\": %.3f,\n", cpuTime());
+    fprintf(f, "  \"variables\": %d,\n", S.nVars());
+    fprintf(f, "  \"eliminated_variables\": %d,\n", S.eliminated_vars);
+    if (S.n > 0){
+        int edges = 0;
+        for (Var v = 0; v < S.n*(S.n-1)/2 && v < S.nVars(); v++)
+            edges += S.isEliminated(v);
+        fprintf(f, "  \"eliminated_edge_variables\": %d,\n", edges); }
+    S.statsJson(f);
+    fprintf(f, "\n}\n");
+    fclose(f);
+}
+
+
 static Solver* solver;
 // Terminate by notifying the solver and back out gracefully. This is mainly to have a test-case
 // for this feature of the Solver as it may take longer than an immediate call to '_exit()'.
@@ -70,6 +97,7 @@ static void SIGINT_exit(int signum) {
     if (solver->verbosity > 0){
         printStats(*solver);
         printf("\n"); printf("*** INTERRUPTED ***\n"); }
+    Sampler::write();
     _exit(1); }
 
 
@@ -89,6 +117,9 @@ int main(int argc, char** argv)
         BoolOption   block_cubes    ("MAIN", "block-cubes",    "Add a conflict clause to block any skipped assumptions", true);
         StringOption dimacs ("MAIN", "dimacs", "If given, stop after preprocessing and write the result to this file.");
         StringOption assumptions ("MAIN", "assumptions", "If given, use the assumptions in the file.");
+        StringOption stats_json ("MAIN", "stats-json", "If given, write a JSON summary of the run to this file.");
+        StringOption sample ("MAIN", "sample", "If given, write samples of the solver phases as folded stacks to this file (also on SIGUSR1).");
+        IntOption    sample_freq("MAIN", "sample-frequency", "Samples per second of CPU time.\n", 100, IntRange(1, 100000));
         IntOption    cpu_lim("MAIN", "cpu-lim","Limit on CPU time allowed in seconds.\n", INT32_MAX, IntRange(0, INT32_MAX));
         IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", INT32_MAX, IntRange(0, INT32_MAX));
         IntOption    add_zeros("MAIN", "add-zeros","Number of initial variables to set to false.\n", 0, IntRange(0, INT32_MAX));
@@ -182,6 +213,9 @@ int main(int argc, char** argv)
         signal(SIGINT, SIGINT_interrupt);
         signal(SIGXCPU,SIGINT_interrupt);
 
+        if (sample && !Sampler::start(sample, sample_freq))
+            printf("ERROR! Could not open file: %s\n", (const char*)sample), exit(1);
+
         S.parsing = 0;
         S.eliminate(true);
         double simplified_time = cpuTime();
@@ -190,6 +224,7 @@ int main(int argc, char** argv)
             printf("|                                                                             |\n"); }
 
         if (!S.okay()){
+            Sampler::stop();
             if (S.output != NULL) fprintf(S.output, "0\n"), fclose(S.output);
             if (S.verbosity > 0){
                 printf("===============================================================================\n");
@@ -197,6 +232,8 @@ int main(int argc, char** argv)
                 printStats(S);
                 printf("\n"); }
             printf("UNSATISFIABLE\n");
+            if (stats_json)
+                writeStatsJson(stats_json, argc == 1 ? "<stdin>" : argv[1], S, l_False);
             exit(20);
         }
 
@@ -294,6 +331,7 @@ int main(int argc, char** argv)
         }
         else
             ret = S.solveLimited(dummy);
+        Sampler::stop();
         
         if (S.verbosity > 0){
             if(assumptions)
@@ -320,6 +358,8 @@ int main(int argc, char** argv)
             }*/
             fclose(S.output);
         }
+        if (stats_json)
+            writeStatsJson(stats_json, argc == 1 ? "<stdin>" : argv[1], S, numsat > 0 ? l_True : ret);
 
 #ifdef NDEBUG
         exit(ret == l_True ? 10 : ret == l_False ? 20 : 0);     // (faster than "return", which will invoke the destructor for 'Solver')
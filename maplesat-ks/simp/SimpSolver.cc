@@ -21,6 +21,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "mtl/Sort.h"
 #include "simp/SimpSolver.h"
 #include "utils/System.h"
+#include "utils/Sampler.h"
 
 using namespace Minisat;
 
@@ -598,6 +599,7 @@ void SimpSolver::extendModel()
 
 bool SimpSolver::eliminate(bool turn_off_elim)
 {
+    SamplerFrame frame(Sampler::elim);
     if (!simplify())
         return false;
     else if (!use_simplification)
@@ -0,0 +1,145 @@
+/*************************************************************************************[Sampler.cc]
+Sampling profiler that writes the phases of the solver as folded stacks.
+**************************************************************************************************/
+
+#include "utils/Sampler.h"
+
+using namespace Minisat;
+
+volatile bool Sampler::active = false;
+volatile int  Sampler::depth  = 0;
+volatile int  Sampler::frames[Sampler::max_frames];
+
+#if defined(__linux__) || defined(__APPLE__)
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+// A sample is its stack of up to four 12 bit frames. The counts are kept in a fixed open
+// addressing table, since the signal handler can not allocate. Samples which do not fit are
+// only counted.
+
+static const int      frame_bits = 12;
+static const uint64_t used       = (uint64_t)1 << 63;
+static const unsigned table_size = 1 << 12;
+
+static struct { uint64_t key, count; } table[table_size];
+static uint64_t         dropped;
+static const char*      sample_path;
+static struct sigaction old_prof, old_usr1;
+
+static void tick(int)
+{
+    uint64_t key = used;
+    const int d  = Sampler::depth;
+    for (int i = 0; i < d && i < Sampler::max_frames; i++)
+        key |= (uint64_t)Sampler::frames[i] << (i * frame_bits);
+    unsigned pos = (key * 0x9E3779B97F4A7C15ull) >> 52;
+    for (unsigned probes = 0; probes < table_size; probes++){
+        if (table[pos].key == key){ table[pos].count++; return; }
+        if (!table[pos].key){ table[pos].key = key; table[pos].count = 1; return; }
+        pos = (pos + 1) & (table_size - 1); }
+    dropped++;
+}
+
+static void dump(int) { Sampler::write(); }
+
+// Output without 'stdio', which is not async-signal-safe.
+struct Line {
+    char buffer[256];
+    int  size;
+    Line() : size(0) {}
+    void put(const char* s) { while (*s && size < (int)sizeof(buffer) - 1) buffer[size++] = *s++; }
+    void put(uint64_t n) {
+        char digits[24]; int i = 0;
+        do digits[i++] = '0' + n % 10; while (n /= 10);
+        while (i && size < (int)sizeof(buffer) - 1) buffer[size++] = digits[--i]; }
+};
+
+static void putFrame(Line& line, int frame)
+{
+    switch (frame){
+    case Sampler::search:   line.put(";search");   break;
+    case Sampler::simplify: line.put(";simplify"); break;
+    case Sampler::elim:     line.put(";elim");     break;
+    case Sampler::proof:    line.put(";proof");    break;
+    default:
+        if      (frame & 0x100) line.put(";canonical_"), line.put((uint64_t)(frame & 0xff));
+        else if (frame & 0x200) line.put(";mus_"),       line.put((uint64_t)(frame & 0xff));
+        else                    line.put(";frame_"),     line.put((uint64_t)frame); }
+}
+
+void Sampler::write()
+{
+    if (!sample_path) return;
+    const int fd = open(sample_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return;
+    for (unsigned i = 0; i < table_size; i++){
+        const uint64_t key = table[i].key;
+        if (!key) continue;
+        Line line;
+        line.put("maplesat");
+        if (key == used) line.put(";other");
+        for (int f = 0; f < max_frames; f++){
+            const int frame = (key >> (f * frame_bits)) & ((1 << frame_bits) - 1);
+            if (frame) putFrame(line, frame); }
+        line.put(" "), line.put(table[i].count), line.put("\n");
+        if (::write(fd, line.buffer, line.size) != line.size) break; }
+    if (dropped){
+        Line line;
+        line.put("maplesat;dropped "), line.put(dropped), line.put("\n");
+        const ssize_t written = ::write(fd, line.buffer, line.size);
+        (void)written; }
+    close(fd);
+}
+
+bool Sampler::start(const char* path, int frequency)
+{
+    const int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    close(fd);
+    sample_path = path;
+    depth       = 0;
+    active      = true;
+
+    // Neither handler interrupts the other:
+    struct sigaction action;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaddset(&action.sa_mask, SIGPROF);
+    sigaddset(&action.sa_mask, SIGUSR1);
+    action.sa_handler = tick;
+    sigaction(SIGPROF, &action, &old_prof);
+    action.sa_handler = dump;
+    sigaction(SIGUSR1, &action, &old_usr1);
+
+    struct itimerval timer;
+    timer.it_interval.tv_sec  = 0;
+    timer.it_interval.tv_usec = 1000000 / frequency;
+    timer.it_value            = timer.it_interval;
+    setitimer(ITIMER_PROF, &timer, 0);
+    return true;
+}
+
+void Sampler::stop()
+{
+    if (!active) return;
+    struct itimerval timer = {};
+    setitimer(ITIMER_PROF, &timer, 0);
+    sigaction(SIGPROF, &old_prof, 0);
+    sigaction(SIGUSR1, &old_usr1, 0);
+    write();
+    active      = false;
+    sample_path = 0;
+}
+
+#else
+
+bool Sampler::start(const char*, int) { return false; }
+void Sampler::stop () {}
+void Sampler::write() {}
+
+#endif
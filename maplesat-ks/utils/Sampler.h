@@ -0,0 +1,46 @@
+/**************************************************************************************[Sampler.h]
+Sampling profiler that writes the phases of the solver as folded stacks.
+**************************************************************************************************/
+
+#ifndef Minisat_Sampler_h
+#define Minisat_Sampler_h
+
+namespace Minisat {
+
+//=================================================================================================
+// A 'SIGPROF' timer samples the stack of frames the solver entered (search, simplification,
+// variable elimination, the canonicity check of each order, the unembeddable subgraph checks,
+// proof writing). The counts are written in the folded stack format of 'flamegraph.pl'
+// ('maplesat;search;canonical_17 42') at the end and whenever the process receives 'SIGUSR1'.
+// Frames only test a global flag unless sampling was started.
+
+class Sampler {
+public:
+    enum { max_frames = 4 };
+    enum { search = 1, simplify = 2, elim = 3, proof = 4 };
+    static int canonical (int order) { return 0x100 + order; }
+    static int mus       (int graph) { return 0x200 + graph; }
+
+    static volatile bool active;
+    static volatile int  depth;
+    static volatile int  frames[max_frames];
+
+    static void enter(int frame) { if (!active) return; if (depth < max_frames) frames[depth] = frame; depth = depth + 1; }
+    static void leave()          { if (active && depth > 0) depth = depth - 1; }
+
+    // Samples 'frequency' times per second of process time and writes the folded stacks to
+    // 'path'. Returns false if the file can not be opened or there are no timers.
+    static bool start(const char* path, int frequency);
+    static void stop ();
+    static void write();        // Only uses 'open' and 'write', thus safe in signal handlers.
+};
+
+// Enters a frame for the life time of the object.
+struct SamplerFrame {
+    SamplerFrame (int frame) { Sampler::enter(frame); }
+    ~SamplerFrame()          { Sampler::leave(); }
+};
+
+}
+
+#endif
@@ -92,6 +92,9 @@
 #define CUBE_MODE		  1
 #define PLAIN_MODE		  2
 
+#define QUIET_MODE		  1  // quiet_mode: print the cnf and the cubes to stdout
+#define LIBRARY_MODE		  2  // quiet_mode: print nothing, cubes are written to cubesStream (see marchlib.h)
+
 /* parameters */
 #define DL_DECREASE		0.85
 //#define DL_VARMULT		15
@@ -400,6 +403,8 @@ int subtree_size;
 #endif
 
 unsigned int sl_iter, dl_iter;
+int look_threads;
+int graph_order, graph_row_wise;
 float h_min, h_max, h_bin, h_dec;
 
 float *hiRank, *clause_weight, *hiSum;
@@ -407,7 +412,7 @@ int kSAT_flag;
 int dist_acc_flag;
 
 // used for big clauses and resolvent_look
-int *literal_list, **clause_list, *clause_length, **clause_set, *clause_database, *big_occ;
+int *literal_list, **clause_list, **clause_set, *clause_database, *big_occ;
 int nrofbigclauses;
 
 int target_rights, current_rights;
@@ -430,7 +435,7 @@ double percentage_forced;
   int count_sat;
 #endif
 
-int *dpll_fixstackp, *end_fixstackp;
+int *dpll_fixstackp;
 
 long long dl_possibility_counter, dl_actual_counter;
 
@@ -439,8 +444,7 @@ int *TernaryImpReduction;
 int tree_elements;
 
 /* doublelook statistics */
-float DL_trigger, DL_trigger_sum;
-long long doublelook_count, doublelook_failed;
+float DL_trigger;
 
 int bin_sat, bin_unsat;
 int non_tautological_equivalences;
@@ -469,24 +473,33 @@ int *eq_found;
 
 /* data structure */
 tstamp current_node_stamp;
-tstamp *timeAssignments, *node_stamps;
+tstamp *node_stamps;
 int **Cv, *Clength, **BinaryImp, *BinaryImpLength;
 
 /* various stacks */
-int *rstack, *rstackp, rstackSize;
-int *look_fixstack, *look_fixstackp, look_fixstackSize;
-int *look_resstack, *look_resstackp, look_resstackSize;
+int *rstack, rstackSize;
+int *look_fixstack, look_fixstackSize;
+int look_resstackSize;
 int *subsumestack,  *subsumestackp,  subsumestackSize;
 int *bieqstack,  *bieqstackp,  bieqstackSize;
 int *impstack,   *impstackp,   impstackSize;
 
 /* lookahead */
 int *forced_literal_array, forced_literals;
-tstamp currentTimeStamp;
 int iterCounter;
 
 struct treeNode *treeArray;
 
+/* state of a lookahead, private to each thread of the parallel lookahead
+   (see parlook.c, where it is defined) */
+extern __thread tstamp *timeAssignments, currentTimeStamp;
+extern __thread int *clause_length;
+extern __thread int *rstackp, *end_fixstackp, *look_fixstackp;
+extern __thread int *look_resstack, *look_resstackp;
+extern __thread float DL_trigger_sum;
+extern __thread long long doublelook_count, doublelook_failed;
+extern __thread int look_worker;
+
 /* accounting */
 int nodeCount;
 long long lookAheadCount;
@@ -13,6 +13,12 @@
 #include "common.h"
 
 FILE *cubes;
+FILE *cubesStream = NULL;
+int *cubePrefix = NULL;
+int cubePrefixSize = 0;
+int cubeRefuted = 0;
+int *rootForced = NULL;
+int nrofRootForced = 0;
 
 int *cubeTrail;
 int nrofDnodes;
@@ -81,6 +87,24 @@ void init_assumptions () {
     Dnodes[i].decision = 0;
     Dnodes[i].type     = 0; } }
 
+void dispose_assumptions () {
+  free (Dnodes);
+  Dnodes = NULL; }
+
+void openCubes () {
+  if      (cubesStream)               cubes = cubesStream;
+  else if (quiet_mode == QUIET_MODE)  cubes = stdout;
+  else                                cubes = fopen (cubesFile, "w"); }
+
+void closeCubes () {
+  if (cubes != cubesStream && cubes != stdout)
+    fclose (cubes); }
+
+void printCubePrefix () {
+  fprintf (cubes, "a ");
+  int i; for (i = 0; i < cubePrefixSize; i++)
+    fprintf (cubes, "%d ", cubePrefix[ i ] ); }
+
 void printWeights (struct Dnode Dnode) {
   if (Dnode.type == REFUTED_DNODE) {
     num_refuted++;
@@ -96,7 +120,7 @@ void printDecisionNode (struct Dnode Dnode, int depth, int discrepancies, int ta
   if (Dnode.type != INTERNAL_DNODE) {
     if ((target == -1) || (discrepancies == target)) {
       _nr_cubes++;
-      fprintf (cubes, "a ");
+      printCubePrefix ();
       int i; for (i = 0; i < depth; i++)
 	fprintf (cubes, "%d ", cubeTrail[ i ] );
       fprintf (cubes, "0\n" ); }
@@ -115,13 +139,13 @@ void printDecisionNode (struct Dnode Dnode, int depth, int discrepancies, int ta
 }
 
 void printUNSAT () {
-  if (quiet_mode) cubes = stdout;
-  else            cubes = fopen (cubesFile, "w");
+  cubeRefuted = 1;
+  openCubes ();
   if (quiet_mode == 0)
     printf  ("c number of cubes 1, including 1 refuted leaf\n");
-  fprintf (cubes, "a 0\n");
-  if (quiet_mode == 0)
-    fclose (cubes); }
+  printCubePrefix ();
+  fprintf (cubes, "0\n");
+  closeCubes (); }
 
 void filterTree (int limit) {
   int i;
@@ -153,8 +177,7 @@ void printDecisionTree () {
   cubeTrail = (int*) malloc(sizeof(int) * nrofvars);
   for (i = 0; i < nrofvars; i++) cubeTrail[i] = 0;
 
-  if (quiet_mode) cubes = stdout;
-  else            cubes = fopen (cubesFile, "w");
+  openCubes ();
 
   if (quiet_mode == 0)
     printf("c print learnt clauses and cubes\n");
@@ -179,7 +202,6 @@ void printDecisionTree () {
       printDecisionNode (Dnodes[1], 0, 0, target++); }
     while (_nr_cubes != nr_cubes); }
     else printDecisionNode (Dnodes[1], 0, 0, -1);
-  if (quiet_mode == 0)
-    fclose (cubes);
+  closeCubes ();
   free (cubeTrail);
 }
@@ -4,6 +4,8 @@
    Copyright (C) 2005-2017 M.J.H. Heule. [marijn@heule.nl]
 */
 
+#include <stdio.h>
+
 #define INTERNAL_DNODE	3
 #define	REFUTED_DNODE	4
 #define CUBE_DNODE	5
@@ -18,7 +20,15 @@ struct Dnode {
   int weight;
 };
 
+extern FILE *cubesStream;  // if set, the cubes are written to this stream instead of the cubes file
+extern int *cubePrefix;    // literals added in front of every cube, e.g., the assumptions of the cubed subproblem
+extern int cubePrefixSize;
+extern int cubeRefuted;    // set if the whole cubed problem was refuted
+extern int *rootForced;    // if set, the literals forced at the root after its lookahead are stored here
+extern int nrofRootForced;
+
 void init_assumptions ();
+void dispose_assumptions ();
 
 void Dnode_setDecision (int index, int decision);
 void Dnode_setType     (int index, int type    );
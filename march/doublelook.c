@@ -12,11 +12,11 @@
 #include "doublelook.h"
 #include "lookahead.h"
 
-int *doublelook_fixstackp;
-int *doublelook_resstackp;
+__thread int *doublelook_fixstackp;
+__thread int *doublelook_resstackp;
 
-int DL_MAX_Stamp;
-int DL_lastChanged;
+__thread int DL_MAX_Stamp;
+__thread int DL_lastChanged;
 
 int (*DL_IUP        ) (int *local_fixstackp);
 int DL_IUP_w_eq_3SAT  (int *local_fixstackp);
@@ -94,7 +94,7 @@ int perform_doublelook (const int nrval, const int offset) {
 
   look_resstackp = doublelook_resstackp;
 
-  if (look_resstackp > look_resstack) add_resolvents (nrval);
+  if (look_resstackp > look_resstack && !look_worker) add_resolvents (nrval);
 
   return SAT; }
 
@@ -78,7 +78,7 @@ void dispose_equivalence()
 	if( Ceq != NULL )
 	{
 	    for( i = 0; i < nrofceq; i++ ) free( Ceq[ i ] );
-	    free( Ceq );
+	    FREE( Ceq );
 	}
 
         FREE( CeqSizes   );
@@ -86,6 +86,15 @@ void dispose_equivalence()
         FREE( CeqValues  );
         FREE( CeqDepends );
         FREE( VeqLength  );
+
+	if( Veq != NULL )
+	{
+	    for( i = 0; i <= nrofvars; i++ ) { free( Veq[ i ] ); free( VeqLUT[ i ] ); }
+	    FREE( Veq    );
+	    FREE( VeqLUT );
+	}
+
+	FREE( eq_found );
 }
 
 void dispose_preprocessor_eq()
@@ -908,7 +917,7 @@ void printNrofEq()
 
 	//printCeq();
 
-	free( eq_found );
+	FREE( eq_found );
 }
 
 void check_integrety()
@@ -17,14 +17,18 @@
 #include "common.h"
 #include "lookahead.h"
 #include "doublelook.h"
+#include "symmetry.h"
 #include "equivalence.h"
+#include "parlook.h"
 #include "tree.h"
 #include "solver.h"
 
 
 /* global look-ahead variables */
-int new_binaries, *NBCounter, *failed_DL_stamp;
-float weighted_new_binaries, *WNBCounter;
+__thread int new_binaries;
+__thread float weighted_new_binaries;
+int *NBCounter, *failed_DL_stamp;
+float *WNBCounter;
 
 #ifdef DL_DECREASE
 double DL_decrease;
@@ -47,7 +51,10 @@ int lookahead () {
 
   int _result;
 #ifdef INTELLOOK
-  _result = tree_lookahead();
+  if (look_threads)
+    _result = parallel_lookahead();
+  else
+    _result = tree_lookahead();
 #else
   _result = serial_lookahead();
 #endif
@@ -136,9 +143,15 @@ void init_lookahead () {
   else             look_IUP = &look_IUP_wo_eq_3SAT;
 
   if (dl_iter != 0) init_doublelook();
+
+  if (look_threads) init_parallel_lookahead();
+
+  if (graph_order) init_symmetry();
 }
 
 void dispose_lookahead () {
+  if (look_threads) dispose_parallel_lookahead();
+  if (graph_order) dispose_symmetry();
   dispose_tree();
   FREE (treeArray);
   FREE (size_diff);
@@ -146,8 +159,11 @@ void dispose_lookahead () {
   FREE (lengthWeight);
 #endif
   FREE_OFFSET( EqDiff          );
-//  FREE_OFFSET( diff            );
-//  FREE_OFFSET( diff_tmp        );
+  /* diff and diff_tmp are swapped by the lookahead, and may end up the
+     same array, so free the arrays of init_lookahead */
+  FREE_OFFSET( _diff           );
+  FREE_OFFSET( _diff_tmp       );
+  diff = diff_tmp = NULL;
   FREE_OFFSET( NBCounter       );
   FREE_OFFSET( WNBCounter      );
   FREE_OFFSET( failed_DL_stamp );
@@ -160,7 +176,7 @@ void dispose_lookahead () {
   FREE( forced_literal_array ); }
 
 void look_IUP_end (const int nrval) {
-  if (look_resstackp > look_resstack)
+  if (look_resstackp > look_resstack && !look_worker)
     add_resolvents (nrval);
 #ifdef LOOK_SUBSUME
   if (currentTimeStamp != LOOK_MAX)
@@ -545,6 +561,30 @@ int long_fix_forced_literals () {
   currentTimeStamp = _currentTimeStamp;
   return SAT; }
 
+/* look ahead on a node of the tree: returns UNSAT, SAT, or LOOK_STOP if the
+   lookahead ends before the node */
+int tree_lookahead_node (const struct treeNode node, int *_forced_literals, int *lastChanged) {
+  if (node.literal == *lastChanged)
+    return LOOK_STOP;
+
+  currentTimeStamp += node.gap;
+  if (currentTimeStamp >= LOOK_MAX) {
+    currentTimeStamp -= node.gap;
+    return LOOK_STOP; }
+
+  if (treelookvar (node.literal) == UNSAT)
+    return UNSAT;
+  currentTimeStamp -= node.gap;
+
+  if (forced_literals > *_forced_literals) {
+    if (IS_FIXED(node.literal) && (Rank[NR(node.literal)] < Rank_trigger)) { // obsolete ?
+      Rank_trigger = Rank[NR(node.literal)];
+      printf ("c forced var with Rank %i\n", Rank_trigger); }
+    *_forced_literals = forced_literals;
+    *lastChanged = node.literal; }
+
+  return SAT; }
+
 int tree_lookahead () {
   int iterCount   = 0;
   int lastChanged = 0;
@@ -554,27 +594,9 @@ int tree_lookahead () {
   do {
     iterCount++;
     int _forced_literals  = forced_literals;
-    struct treeNode* _treeArray = treeArray;
-    int i; for (i = tree_elements-1; i >= 0; i--) {
-      struct treeNode node = *(_treeArray++);
-      if (node.literal == lastChanged)
-        return SAT;
-
-      currentTimeStamp += node.gap;
-      if (currentTimeStamp >= LOOK_MAX) {
-        currentTimeStamp -= node.gap;
-        return SAT; }
-
-      if (treelookvar (node.literal) == UNSAT)
-        return UNSAT;
-      currentTimeStamp -= node.gap;
-
-      if (forced_literals > _forced_literals) {
-        if (IS_FIXED(node.literal) && (Rank[NR(node.literal)] < Rank_trigger)) { // obsolete ?
-	  Rank_trigger = Rank[NR(node.literal)];
-          printf ("c forced var with Rank %i\n", Rank_trigger); }
-	_forced_literals = forced_literals;
-	lastChanged = node.literal; } }
+    int i; for (i = 0; i < tree_elements; i++) {
+      int _result = tree_lookahead_node (treeArray[ i ], &_forced_literals, &lastChanged);
+      if (_result != SAT) return _result == UNSAT ? UNSAT : SAT; }
     currentTimeStamp += 2 * tree_elements;
   } while (lastChanged != 0 && iterCount <= sl_iter);
 
@@ -738,6 +760,8 @@ int get_signedBranchVariable () {
   int only_reduced_variables_flag = 0;
   if (gah) only_reduced_variables_flag = 1;
 
+  if (graph_order) compute_vertex_cells ();
+
   do {
     for (i = 0; i < lookaheadArrayLength; i++) {
       int varnr = lookaheadArray[ i ];
@@ -760,6 +784,7 @@ int get_signedBranchVariable () {
          right = 1024 * WNBCounter[-varnr] + 0.0;
 #endif
          diffScore = left * right + left + right;
+         if (graph_order) diffScore *= symmetry_weight (varnr);
 
          if (diffScore > maxDiffScore) {
            maxDiffScore = diffScore;
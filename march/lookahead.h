@@ -12,6 +12,12 @@ void init_lookahead   ();
 void dispose_lookahead();
 
 int lookahead();
+int init_lookahead_procedure();
+
+/* the result of tree_lookahead_node if the lookahead ends before the node */
+#define LOOK_STOP 2
+
+int tree_lookahead_node( const struct treeNode node, int *_forced_literals, int *lastChanged );
 
        int treelookvar			( const int nrval );
        int look_IFIUP			( const int nrval );
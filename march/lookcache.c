@@ -0,0 +1,144 @@
+/*
+   MARCH Satisfiability Solver
+
+   Lookahead cache, see lookcache.h
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "lookcache.h"
+
+struct look_cache {
+  int *pool, poolSize, poolUsed;  // the records, as in the file
+  int *table, tableSize, entries; // offsets of the records + 1, 0 is empty
+  FILE *file; };
+
+int compare_literals (const void *a, const void *b) {
+  return *(const int*) a - *(const int*) b; }
+
+void sort_cube (int *cube, int size) {
+  qsort (cube, size, sizeof (int), compare_literals); }
+
+unsigned int hash_cube (int kind, const int *cube, int size) {
+  unsigned int hash = 2166136261u ^ kind;
+  int i; for (i = 0; i < size; i++) {
+    hash ^= (unsigned int) cube[ i ];
+    hash *= 16777619u; }
+  return hash; }
+
+int *find_slot (struct look_cache *cache, int kind, const int *cube, int size) {
+  unsigned int mask = cache->tableSize - 1;
+  unsigned int slot = hash_cube (kind, cube, size) & mask;
+
+  while (cache->table[ slot ]) {
+    int *record = cache->pool + cache->table[ slot ] - 1;
+    if (record[ 0 ] == kind && record[ 1 ] == size && !memcmp (record + 3, cube, sizeof (int) * size))
+      break;
+    slot = (slot + 1) & mask; }
+
+  return &cache->table[ slot ]; }
+
+void grow_table (struct look_cache *cache) {
+  int *old = cache->table, oldSize = cache->tableSize;
+
+  cache->tableSize = oldSize ? 2 * oldSize : 1024;
+  cache->table = (int*) calloc (cache->tableSize, sizeof (int));
+
+  int i; for (i = 0; i < oldSize; i++)
+    if (old[ i ]) {
+      int *record = cache->pool + old[ i ] - 1;
+      *find_slot (cache, record[ 0 ], record + 3, record[ 1 ]) = old[ i ]; }
+  free (old); }
+
+/* add a record to the table, a later record for the same cube wins */
+void add_record (struct look_cache *cache, const int *record) {
+  int length = 3 + record[ 1 ] + record[ 2 ];
+
+  if (cache->poolUsed + length > cache->poolSize) {
+    cache->poolSize = 2 * (cache->poolUsed + length);
+    cache->pool = (int*) realloc (cache->pool, sizeof (int) * cache->poolSize); }
+  memcpy (cache->pool + cache->poolUsed, record, sizeof (int) * length);
+
+  if (2 * (cache->entries + 1) > cache->tableSize) grow_table (cache);
+
+  int *slot = find_slot (cache, record[ 0 ], record + 3, record[ 1 ]);
+  if (*slot == 0) cache->entries++;
+  *slot = cache->poolUsed + 1;
+  cache->poolUsed += length; }
+
+void read_records (struct look_cache *cache, const char *path) {
+  int fd = open (path, O_RDONLY);
+  if (fd < 0) return;
+
+  struct stat st;
+  if (fstat (fd, &st) == 0 && st.st_size >= (off_t) sizeof (int)) {
+    int *data = (int*) mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      int n = st.st_size / sizeof (int), i = 0;
+      while (i + 3 <= n) {
+        if (data[ i + 1 ] < 0 || data[ i + 2 ] < 0) break; // not a cache file
+        int length = 3 + data[ i + 1 ] + data[ i + 2 ];
+        if (i + length > n) break; // truncated record
+        add_record (cache, data + i);
+        i += length; }
+      munmap (data, st.st_size); } }
+  close (fd); }
+
+struct look_cache *look_cache_open (const char *path) {
+  struct look_cache *cache = (struct look_cache*) malloc (sizeof (struct look_cache));
+
+  cache->pool      = NULL;
+  cache->poolSize  = 0;
+  cache->poolUsed  = 0;
+  cache->table     = NULL;
+  cache->tableSize = 0;
+  cache->entries   = 0;
+  cache->file      = NULL;
+  grow_table (cache);
+
+  if (path) {
+    read_records (cache, path);
+    cache->file = fopen (path, "ab");
+    if (cache->file == NULL) {
+      look_cache_close (cache);
+      return NULL; } }
+
+  return cache; }
+
+void look_cache_close (struct look_cache *cache) {
+  if (cache->file) fclose (cache->file);
+  free (cache->pool);
+  free (cache->table);
+  free (cache); }
+
+int look_cache_find (struct look_cache *cache, int kind, const int *cube, int size, const int **data, int *count) {
+  int offset = *find_slot (cache, kind, cube, size);
+  if (offset == 0) return 0;
+
+  int *record = cache->pool + offset - 1;
+  *data  = record + 3 + size;
+  *count = record[ 2 ];
+  return 1; }
+
+void look_cache_insert (struct look_cache *cache, int kind, const int *cube, int size, const int *data, int count) {
+  int length = 3 + size + count;
+  int *record = (int*) malloc (sizeof (int) * length);
+
+  record[ 0 ] = kind;
+  record[ 1 ] = size;
+  record[ 2 ] = count;
+  memcpy (record + 3, cube, sizeof (int) * size);
+  if (count) memcpy (record + 3 + size, data, sizeof (int) * count);
+
+  add_record (cache, record);
+  if (cache->file) {
+    fwrite (record, sizeof (int), length, cache->file);
+    fflush (cache->file); }
+
+  free (record); }
@@ -0,0 +1,37 @@
+/*
+   MARCH Satisfiability Solver
+
+   Lookahead cache (see march_cache_open): maps a cube, as a sorted set of
+   literals, to what the lookahead found under it. A FORCED entry holds the
+   literals forced at the root and a REFUTED entry marks a refuted cube;
+   unit propagation and failed literal detection are monotone, so both stay
+   valid for every cube that extends the key. A NODE entry holds the result
+   of cubing the cube one level deep (see march_cube_deep), and a REWARDS
+   entry the lookahead of a node of march_mcts.
+
+   With a file, the entries are appended to it as they are inserted, and
+   a later look_cache_open reads them back through mmap. The file is a
+   sequence of records (kind, size, count, size key literals, count data).
+*/
+
+#ifndef __LOOKCACHE_H__
+#define __LOOKCACHE_H__
+
+#define LOOK_CACHE_FORCED	1
+#define LOOK_CACHE_REFUTED	2
+#define LOOK_CACHE_NODE		3
+#define LOOK_CACHE_REWARDS	4
+
+struct look_cache;
+
+struct look_cache *look_cache_open (const char *path);
+void look_cache_close (struct look_cache *cache);
+
+/* returns 1 and points data to the count entries of the given kind for the
+   sorted cube, or returns 0 if there is no such entry */
+int look_cache_find (struct look_cache *cache, int kind, const int *cube, int size, const int **data, int *count);
+void look_cache_insert (struct look_cache *cache, int kind, const int *cube, int size, const int *data, int count);
+
+void sort_cube (int *cube, int size);
+
+#endif
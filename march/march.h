@@ -23,7 +23,9 @@
 #ifndef __MARCHII_H__
 #define __MARCHII_H__
 
+#include "marchlib.h"
+
 int main( int argc, char** argv );
-void runParser( char* fname );
+void runParser( march_ctx *ctx, char* fname );
 
 #endif
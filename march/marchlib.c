@@ -0,0 +1,538 @@
+/*
+   MARCH Satisfiability Solver
+   Copyright (C) 2001-2005 M.J.H. Heule, J.E. van Zwieten, and M. Dufour.
+   Copyright (C) 2005-2017 M.J.H. Heule. [marijn@heule.nl]
+
+   This file contains the library interface (see marchlib.h)
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "marchlib.h"
+#include "cube.h"
+#include "common.h"
+#include "equivalence.h"
+#include "lookahead.h"
+#include "parser.h"
+#include "preselect.h"
+#include "progressBar.h"
+#include "resolvent.h"
+#include "solver.h"
+#include "memory.h"
+#include "lookcache.h"
+#include "rewards.h"
+
+march_ctx *march_ctx_new () {
+  march_ctx *ctx = (march_ctx*) malloc (sizeof (march_ctx));
+
+  ctx->lits         = NULL;
+  ctx->nrofliterals = 0;
+  ctx->litsSize     = 0;
+  ctx->nrofvars     = 0;
+  ctx->nrofclauses  = 0;
+
+  ctx->mode       = CUBE_MODE;
+  ctx->sharp_mode = 0;
+  ctx->quiet_mode = LIBRARY_MODE;
+  ctx->seed       = 0; // no initial seed
+  ctx->hardLimit  = 0; // no hard limit
+  ctx->cut_var    = 0;
+  ctx->cubeLimit  = 0;
+
+  ctx->gah        = GAH;
+  ctx->addWFR     = WFR;
+  ctx->addIMP     = IMP;
+
+  ctx->h_min      = H_MIN;
+  ctx->h_max      = H_MAX;
+  ctx->h_bin      = H_BIN;
+  ctx->h_dec      = H_DEC;
+  ctx->sl_iter    = SL_ITER;
+  ctx->dl_iter    = DL_ITER;
+#ifdef SCHUR
+  ctx->dl_iter    = 0;
+#endif
+  ctx->threads    = 0;
+  ctx->order      = 0;
+  ctx->row_wise   = 0;
+  ctx->cache      = NULL;
+  ctx->rewards    = NULL;
+
+  ctx->cweight    = 8200;
+  ctx->downexp    = 0.3;
+  ctx->fraction   = 0.02;
+
+  ctx->cpuct      = 10;
+  ctx->varpen     = 0;
+  ctx->mcts_depth = 20;
+
+  return ctx; }
+
+void march_ctx_free (march_ctx *ctx) {
+  if (ctx->cache) look_cache_close (ctx->cache);
+  if (ctx->rewards) free_reward_engine (ctx->rewards);
+  free (ctx->lits);
+  free (ctx); }
+
+int march_load_clauses (march_ctx *ctx, const int *lits, int n) {
+  if (ctx->nrofliterals + n > ctx->litsSize) {
+    ctx->litsSize = 2 * (ctx->nrofliterals + n);
+    ctx->lits = (int*) realloc (ctx->lits, sizeof (int) * ctx->litsSize); }
+
+  int i; for (i = 0; i < n; i++) {
+    ctx->lits[ ctx->nrofliterals++ ] = lits[ i ];
+    if (lits[ i ] == 0) ctx->nrofclauses++;
+    else if (abs (lits[ i ]) > ctx->nrofvars) ctx->nrofvars = abs (lits[ i ]); }
+
+  return 1; }
+
+int march_load_dimacs (march_ctx *ctx, FILE *in) {
+  int result, _nrofvars = 0, _nrofclauses = 0;
+
+  do {
+    result = fscanf (in, " p cnf %i %i \n", &_nrofvars, &_nrofclauses);
+    if (result > 0 && result != EOF) break;
+    result = fscanf (in, "%*s\n"); }
+  while (result != 2 && result != EOF);
+
+  if (result == EOF || result != 2) return 0;
+
+  if (_nrofvars > ctx->nrofvars) ctx->nrofvars = _nrofvars;
+
+  int _lit, _clauses = 0;
+  while (_clauses < _nrofclauses) {
+    if (fscanf (in, " %i ", &_lit) != 1) return 0;
+    if (abs (_lit) > _nrofvars) return 0;
+    march_load_clauses (ctx, &_lit, 1);
+    if (_lit == 0) _clauses++; }
+
+  return 1; }
+
+int handleUNSAT () {
+  if (quiet_mode == 0) {
+    printf ("c main():: nodeCount: %i\n", nodeCount);
+    printf ("c main():: time=%f\n", ((float)(clock()))/CLOCKS_PER_SEC); }
+  if (mode == PLAIN_MODE) {
+    printf( "s UNSATISFIABLE\n" ); }
+  else { printUNSAT (); }
+  disposeFormula();
+  return EXIT_CODE_UNSAT; }
+
+/* solve or cube the loaded and simplified formula */
+int march_run () {
+  int i;
+  int result   = UNKNOWN;
+  int exitcode = EXIT_CODE_UNKNOWN;
+
+#ifdef SIMPLE_EQ
+	if (equivalence_reasoning() == UNSAT) return handleUNSAT();
+#endif
+        kSAT_flag = 0;
+        for (i = 0; i < nrofclauses; i++)
+          if (Clength[i] > 3) {
+            kSAT_flag = 1; break; }
+
+#ifndef TERNARYLOOK
+#ifdef RESOLVENTLOOK
+	if (resolvent_look() == UNSAT) return handleUNSAT();
+#endif
+#endif
+        if (kSAT_flag)         allocate_big_clauses_datastructures();
+
+	depth                 = 0;   // to solver.c ?
+        nodeCount             = 0;
+        lookAheadCount        = 0;
+        unitResolveCount      = 0;
+	necessary_assignments = 0;
+
+     if (sharp_mode == 1) {
+        int* status;
+        status = (int*) malloc (sizeof (int) * (2 * nrofvars + 1));
+        for (i = 0; i <= 2* nrofvars; i++) status[i] = 0;
+        status += nrofvars;
+
+        for (i = 0; i < nrofclauses; i++) {
+          if (Clength[i] == 2) {
+            if (!status[Cv[i][0]]) { status[Cv[i][0]] = Cv[i][1]; }
+            else                   { status[Cv[i][0]] = nrofvars + 1;     }
+            if (!status[Cv[i][1]]) { status[Cv[i][1]] = Cv[i][0]; }
+            else                   { status[Cv[i][1]] = nrofvars + 1;     } }
+          if (Clength[i] > 2) {
+            int j;
+            for (j = 0; j < Clength[i]; j++)
+              status[Cv[i][j]] = nrofvars + 1; } }
+
+        int count = 0, out = 0;
+        for (i = 1; i <= nrofvars; i++) {
+          if (status[i] && status[i] == -status[-i]) {
+            status[status[ i]] = nrofvars + 1;
+            status[status[-i]] = nrofvars + 1;
+            if (count == 0) printf("c free #SAT variables:");
+            count++; out += 2;
+            printf(" %i", i);
+          }
+          if (!status[i] && !status[-i] && !timeAssignments[i]) {
+            if (count == 0) printf("c free #SAT variables:");
+            count++; out += 1;
+            printf(" %i", i);
+          }
+        }
+        if (count) printf("\nc number free #SAT variables: %i\n", count);
+        if (out == freevars) printf("c all remaing variables are free #SAT: 2^%i solutions\n", count);
+        free (status - nrofvars);
+     }
+
+
+	if (initSolver ())
+	{
+#ifdef TIMEOUT
+		printf ("c timeout = %i seconds\n", TIMEOUT);
+#endif
+#ifdef PROGRESS_BAR
+		pb_init (6);
+#endif
+#ifdef DISTRIBUTION
+		result = distribution_branching();
+#else
+#ifdef SUPER_LINEAR
+		result = super_linear_branching();
+#else
+		result = march_solve_rec();
+#endif
+#endif
+
+#ifdef PROGRESS_BAR
+		pb_dispose();
+#endif
+	}
+	else
+	{
+		if (quiet_mode != LIBRARY_MODE)
+		  printf( "c main():: conflict caused by unary equivalence clause found.\n" );
+		result = UNSAT;
+	}
+        if (quiet_mode == 0) {
+#ifdef CUBE
+          nodeCount = getNodes ();
+#endif
+          printf ("c main():: nodeCount: %i\n", nodeCount);
+          printf ("c main():: dead ends in main: %i\n", mainDead);
+          printf ("c main():: lookAheadCount: %lli\n", lookAheadCount);
+          printf ("c main():: unitResolveCount: %i\n", unitResolveCount);
+          printf ("c time = %.2f seconds\n", ((float)(clock()))/CLOCKS_PER_SEC);
+          printf ("c main():: necessary_assignments: %i\n", necessary_assignments); }
+
+#ifdef COUNT_SAT
+	printf ("c main():: found %i solutions\n", count_sat);
+	if (count_sat > 0) result = SAT;
+#endif
+
+	switch (result)
+	{
+	    case SAT:
+		if (quiet_mode != LIBRARY_MODE)
+		  printf( "s SATISFIABLE\n" );
+#ifndef COUNT_SAT
+                if (quiet_mode == 0)
+		  printSolution (original_nrofvars);
+#endif
+		exitcode = EXIT_CODE_SAT;
+		break;
+
+	    case UNSAT:
+               if (mode == PLAIN_MODE) {
+                 printf ("s UNSATISFIABLE\n");
+  	         exitcode = EXIT_CODE_UNSAT; }
+               else {
+
+            printDecisionTree (); }
+	       break;
+
+	    default:
+		if (quiet_mode != LIBRARY_MODE)
+		  printf( "s UNKNOWN\n" );
+		exitcode = EXIT_CODE_UNKNOWN;
+            printDecisionTree ();
+        }
+
+	disposeSolver();
+
+	disposeFormula();
+
+        return exitcode;
+}
+
+int march_cache_open (march_ctx *ctx, const char *path) {
+  if (ctx->cache) look_cache_close (ctx->cache);
+  ctx->cache = look_cache_open (path);
+  return ctx->cache != NULL; }
+
+/* append the cached literals of the sorted cube and of the cubes that it
+   extends by one literal to units; returns 1 if one of them is refuted */
+int find_cached_units (struct look_cache *cache, const int *key, int size, int *units, int *nrofunits) {
+  int *subset = (int*) malloc (sizeof (int) * (size + 1));
+  int refuted = 0;
+
+  int skip; for (skip = size; skip >= 0 && !refuted; skip--) {
+    int i, n = 0;
+    for (i = 0; i < size; i++)
+      if (i != skip) subset[ n++ ] = key[ i ];
+
+    const int *lits;
+    int count;
+    if (look_cache_find (cache, LOOK_CACHE_REFUTED, subset, n, &lits, &count))
+      refuted = 1;
+    else if (look_cache_find (cache, LOOK_CACHE_FORCED, subset, n, &lits, &count))
+      for (i = 0; i < count; i++)
+        units[ (*nrofunits)++ ] = lits[ i ]; }
+
+  free (subset);
+  return refuted; }
+
+int march_cube (march_ctx *ctx, const int *assumptions, int nrofassumptions, int depth, int _maxvar, FILE *out_cubes) {
+  mode       = ctx->mode;
+  sharp_mode = ctx->sharp_mode;
+  quiet_mode = ctx->quiet_mode;
+  seed       = ctx->seed;
+  hardLimit  = ctx->hardLimit;
+  cut_depth  = depth;
+  cut_var    = ctx->cut_var;
+  cubeLimit  = ctx->cubeLimit;
+  maxvar     = _maxvar;
+
+  gah        = ctx->gah;
+  addWFR     = ctx->addWFR;
+  addIMP     = ctx->addIMP;
+  h_min      = ctx->h_min;
+  h_max      = ctx->h_max;
+  h_bin      = ctx->h_bin;
+  h_dec      = ctx->h_dec;
+  sl_iter    = ctx->sl_iter;
+  dl_iter    = ctx->dl_iter;
+  look_threads = ctx->threads;
+  graph_order  = ctx->order;
+  graph_row_wise = ctx->row_wise;
+  cweight    = ctx->cweight;
+  downexp    = ctx->downexp;
+  fraction   = ctx->fraction;
+
+  if (seed) srand (seed);
+
+  dynamic = (!cut_var && !cut_depth);
+
+  cubesStream    = out_cubes;
+  cubePrefix     = (int*) assumptions;
+  cubePrefixSize = nrofassumptions;
+
+  /* the assumptions, and what the cache knows about them, are added as
+     unit clauses */
+  int *units = (int*) malloc (sizeof (int) * (nrofassumptions + (nrofassumptions + 1) * (ctx->nrofvars + 1)));
+  int nrofunits = nrofassumptions;
+  if (nrofassumptions) memcpy (units, assumptions, sizeof (int) * nrofassumptions);
+
+  int *key = NULL;
+  if (ctx->cache) {
+    key = (int*) malloc (sizeof (int) * (nrofassumptions + 1));
+    if (nrofassumptions) memcpy (key, assumptions, sizeof (int) * nrofassumptions);
+    sort_cube (key, nrofassumptions);
+
+    if (find_cached_units (ctx->cache, key, nrofassumptions, units, &nrofunits)) {
+      printUNSAT ();
+      free (units); free (key);
+      return EXIT_CODE_UNSAT; } }
+
+  int *lits = ctx->lits;
+  if (nrofunits) {
+    lits = (int*) malloc (sizeof (int) * (ctx->nrofliterals + 2 * nrofunits));
+    memcpy (lits, ctx->lits, sizeof (int) * ctx->nrofliterals);
+    int i; for (i = 0; i < nrofunits; i++) {
+      lits[ ctx->nrofliterals + 2 * i     ] = units[ i ];
+      lits[ ctx->nrofliterals + 2 * i + 1 ] = 0; } }
+  free (units);
+
+  initFormulaSize (ctx->nrofvars, ctx->nrofclauses + nrofunits);
+  int loaded = loadCNF (lits);
+  if (lits != ctx->lits) free (lits);
+  if (!loaded) { free (key); return EXIT_CODE_ERROR; }
+
+  init_equivalence();
+
+  ctx->removed = 0;
+  cubeRefuted  = 0;
+
+  if (simplify_formula () == UNSAT) {
+    if (key) {
+      look_cache_insert (ctx->cache, LOOK_CACHE_REFUTED, key, nrofassumptions, NULL, 0);
+      free (key); }
+    if (quiet_mode == 0) {
+      printf ("c runParser():: conflicting unary clauses, so instance is unsatisfiable!\n");
+      printf( "c time = %.2f seconds\n", ((float)(clock()))/CLOCKS_PER_SEC ); }
+    printUNSAT ();
+    if (quiet_mode != LIBRARY_MODE)
+      printf ("s UNSATISFIABLE\n");
+    disposeFormula ();
+    return EXIT_CODE_UNSAT; }
+
+  if (key) {
+    rootForced = (int*) malloc (sizeof (int) * (ctx->nrofvars + 1));
+    nrofRootForced = 0; }
+
+  int exitcode = march_run ();
+  ctx->removed = (maxvar ? maxvar : nrofvars) - initial_freeentryvars;
+
+  if (key) {
+    const int *lits;
+    int count = 0;
+    look_cache_find (ctx->cache, LOOK_CACHE_FORCED, key, nrofassumptions, &lits, &count);
+    if (cubeRefuted)
+      look_cache_insert (ctx->cache, LOOK_CACHE_REFUTED, key, nrofassumptions, NULL, 0);
+    else if (nrofRootForced > count)
+      look_cache_insert (ctx->cache, LOOK_CACHE_FORCED, key, nrofassumptions, rootForced, nrofRootForced);
+    FREE( rootForced );
+    free (key); }
+
+  return exitcode; }
+
+struct deep_cubing {
+  march_ctx node;
+  int depthCutoff, removedCutoff, maxvar;
+  FILE *out;
+  int calls, cached, leaves, refuted; };
+
+void emit_leaf (struct deep_cubing *dc, const int *prefix, int size) {
+  fprintf (dc->out, "a ");
+  int i; for (i = 0; i < size; i++)
+    fprintf (dc->out, "%d ", prefix[ i ]);
+  fprintf (dc->out, "0\n");
+  fflush (dc->out);
+  dc->leaves++; }
+
+/* the result of cubing a node one level deep, as stored in the cache */
+struct node_result {
+  int maxvar, exitcode, removed, exhausted, nrofchildren, children[ 2 ]; };
+
+#define NODE_RESULT_SIZE	(sizeof (struct node_result) / sizeof (int))
+
+/* cube the node given by prefix one level deep, or take the result from
+   the cache if the node was cubed before with the same maxvar */
+int expand_node (struct deep_cubing *dc, int *prefix, int size, struct node_result *r) {
+  int *key = NULL;
+  if (dc->node.cache) {
+    key = (int*) malloc (sizeof (int) * (size + 1));
+    memcpy (key, prefix, sizeof (int) * size);
+    sort_cube (key, size);
+
+    const int *data;
+    int count;
+    if (look_cache_find (dc->node.cache, LOOK_CACHE_NODE, key, size, &data, &count) &&
+        count == NODE_RESULT_SIZE && data[ 0 ] == dc->maxvar) {
+      memcpy (r, data, sizeof (struct node_result));
+      free (key);
+      dc->cached++;
+      return r->exitcode; } }
+
+  char *buf = NULL;
+  size_t bufSize = 0;
+  FILE *stream = open_memstream (&buf, &bufSize);
+
+  dc->calls++;
+  int exitcode = march_cube (&dc->node, prefix, size, 1, dc->maxvar, stream);
+  fclose (stream);
+
+  if (exitcode == EXIT_CODE_ERROR) { free (buf); free (key); return EXIT_CODE_ERROR; }
+
+  r->maxvar       = dc->maxvar;
+  r->exitcode     = exitcode;
+  r->removed      = dc->node.removed;
+  r->exhausted    = 0;
+  r->nrofchildren = 0;
+  r->children[ 0 ] = r->children[ 1 ] = 0;
+
+  /* the children are the cubes that extend the prefix by one decision; a
+     refuted node only prints the prefix itself, and a node without free
+     variables up to maxvar prints the decision 0 */
+  char *line = buf;
+  while (line && *line == 'a') {
+    int lit, n, length = 0, decision = 0;
+    char *p = line + 1;
+    while (sscanf (p, "%d%n", &lit, &n) == 1) {
+      if (length++ == size) decision = lit;
+      p += n; }
+    if (length == size + 2 && r->nrofchildren < 2) {
+      if (decision == 0) r->exhausted = 1;
+      else r->children[ r->nrofchildren++ ] = decision; }
+    line = strchr (line, '\n');
+    if (line) line++; }
+  free (buf);
+
+  if (key) {
+    look_cache_insert (dc->node.cache, LOOK_CACHE_NODE, key, size, (int*) r, NODE_RESULT_SIZE);
+    free (key); }
+
+  return exitcode; }
+
+/* cube the node given by prefix one level deep and recurse on its children
+   until a cutoff is reached; refuted nodes are dropped */
+int cube_node (struct deep_cubing *dc, int *prefix, int size, int depth) {
+  struct node_result r;
+  int exitcode = expand_node (dc, prefix, size, &r);
+  if (exitcode == EXIT_CODE_ERROR) return EXIT_CODE_ERROR;
+
+  if (exitcode == EXIT_CODE_SAT) {
+    emit_leaf (dc, prefix, size);
+    return EXIT_CODE_SAT; }
+
+  if (exitcode == EXIT_CODE_UNSAT || (r.nrofchildren == 0 && !r.exhausted)) {
+    dc->refuted++;
+    return EXIT_CODE_UNSAT; }
+
+  if (r.exhausted || (dc->depthCutoff && depth >= dc->depthCutoff) ||
+      (dc->removedCutoff && r.removed >= dc->removedCutoff)) {
+    emit_leaf (dc, prefix, size);
+    return EXIT_CODE_UNKNOWN; }
+
+  int result = EXIT_CODE_UNSAT;
+  int i; for (i = 0; i < r.nrofchildren; i++) {
+    prefix[ size ] = r.children[ i ];
+    int _result = cube_node (dc, prefix, size + 1, depth + 1);
+    if (_result == EXIT_CODE_ERROR) return EXIT_CODE_ERROR;
+    if (_result == EXIT_CODE_SAT || result == EXIT_CODE_SAT) result = EXIT_CODE_SAT;
+    else if (_result == EXIT_CODE_UNKNOWN) result = EXIT_CODE_UNKNOWN; }
+
+  return result; }
+
+int march_cube_deep (march_ctx *ctx, const int *assumptions, int nrofassumptions, int depthCutoff, int removedCutoff, int _maxvar, FILE *out_cubes) {
+  struct deep_cubing dc;
+
+  dc.node            = *ctx;
+  dc.node.quiet_mode = LIBRARY_MODE;
+  dc.node.cut_var    = 0;
+  dc.depthCutoff     = depthCutoff;
+  dc.removedCutoff   = removedCutoff;
+  dc.maxvar          = _maxvar;
+  dc.calls = dc.cached = dc.leaves = dc.refuted = 0;
+
+  if      (out_cubes)                      dc.out = out_cubes;
+  else if (ctx->quiet_mode == QUIET_MODE)  dc.out = stdout;
+  else                                     dc.out = fopen (cubesFile, "w");
+
+  if (ctx->quiet_mode == QUIET_MODE) {
+    printf ("p inccnf\n");
+    int i; for (i = 0; i < ctx->nrofliterals; i++)
+      printf (ctx->lits[ i ] ? "%d " : "%d\n", ctx->lits[ i ]); }
+
+  int *prefix = (int*) malloc (sizeof (int) * (nrofassumptions + ctx->nrofvars + 1));
+  if (nrofassumptions) memcpy (prefix, assumptions, sizeof (int) * nrofassumptions);
+
+  int result = cube_node (&dc, prefix, nrofassumptions, 0);
+
+  free (prefix);
+  if (dc.out != out_cubes && dc.out != stdout) fclose (dc.out);
+
+  if (ctx->quiet_mode == 0)
+    printf ("c march_cube_deep():: %i cubes, %i refuted nodes, %i calls, %i cached nodes\n", dc.leaves, dc.refuted, dc.calls, dc.cached);
+
+  return result; }
@@ -0,0 +1,114 @@
+/*
+   MARCH Satisfiability Solver
+
+   Library interface of march_cu: load a formula once and cube it (or
+   subproblems of it, given by assumptions) as often as needed, without
+   writing and parsing intermediate files.
+
+   The solver state of march is global, so only one march_cube call can
+   run at a time in a process. The loaded formula itself is kept in the
+   context and is not modified by march_cube.
+*/
+
+#ifndef __MARCHLIB_H__
+#define __MARCHLIB_H__
+
+#include <stdio.h>
+
+#ifndef LIBRARY_MODE
+#define LIBRARY_MODE 2 /* quiet_mode of march_ctx_new, as in common.h */
+#endif
+
+struct look_cache;
+struct reward_engine;
+
+typedef struct march_ctx {
+  /* formula: nrofclauses zero-terminated clauses */
+  int *lits;
+  int nrofliterals, litsSize;
+  int nrofvars, nrofclauses;
+
+  /* options, march_ctx_new sets the defaults of the command line */
+  int mode, sharp_mode, quiet_mode;
+  unsigned int seed, hardLimit, cut_var, cubeLimit;
+  int gah, addWFR, addIMP;
+  float h_min, h_max, h_bin, h_dec;
+  unsigned int sl_iter, dl_iter;
+  int threads; /* lookahead threads, 0 for the serial lookahead */
+  int order;   /* vertices of the graph on the first variables, 0 for none */
+  int row_wise; /* their edges are numbered row by row (SMS), not column by column */
+  int cweight;
+  double downexp, fraction;
+  double cpuct, varpen; /* exploration and variance penalty of march_mcts */
+  int mcts_depth;       /* how far its simulations look beyond the cutoff depth */
+
+  /* set by march_cube: the number of variables up to maxvar (all variables
+     if there is no maxvar) that the simplification removed */
+  int removed;
+
+  struct look_cache *cache; /* see march_cache_open */
+  struct reward_engine *rewards; /* see march_rewards */
+} march_ctx;
+
+march_ctx *march_ctx_new ();
+void march_ctx_free (march_ctx *ctx);
+
+/* append n literals forming zero-terminated clauses to the formula */
+int march_load_clauses (march_ctx *ctx, const int *lits, int n);
+
+/* append the clauses of a DIMACS file; returns 0 on a parse error */
+int march_load_dimacs (march_ctx *ctx, FILE *in);
+
+/* cube the formula under the given assumptions with a static cutoff depth
+   (0 for the dynamic cutoff) and the maximum variable to cube with (0 for no
+   limit). Every cube written to out_cubes starts with the assumptions. If
+   out_cubes is NULL, the cubes go to cubesFile or stdout as in the command
+   line tool. Returns one of the EXIT_CODE_* values of common.h. */
+int march_cube (march_ctx *ctx, const int *assumptions, int nrofassumptions, int depth, int maxvar, FILE *out_cubes);
+
+/* keep a lookahead cache in the context: the literals that march_cube finds
+   forced at the root under its assumptions are stored under the sorted
+   assumptions, and are added as units whenever the same assumptions, or
+   assumptions extending them by one literal, are cubed again. Refuted
+   assumptions are stored as well. With a path, the cache is read from and
+   appended to that file, so it can be shared by consecutive processes on
+   the same formula; NULL keeps it in memory. Returns 0 on error. */
+int march_cache_open (march_ctx *ctx, const char *path);
+
+/* iterative deep cubing: build the whole cube tree in-process by cubing one
+   level at a time, so every node starts from a formula that is simplified
+   under its cube. Refuted nodes are dropped. A node becomes a leaf at the
+   given depth, or once removedCutoff variables (see removed) are gone; a
+   cutoff of 0 is no cutoff. Leaf cubes are written to out_cubes (or as in
+   march_cube if it is NULL) as soon as they are found. Returns
+   EXIT_CODE_UNSAT if every node was refuted. */
+int march_cube_deep (march_ctx *ctx, const int *assumptions, int nrofassumptions, int depthCutoff, int removedCutoff, int maxvar, FILE *out_cubes);
+
+/* lookahead rewards for AlphaMapleSAT (see ksgraph/EvalVarCalc.py): unit
+   propagate the formula under the assumptions and under each candidate
+   literal in turn, with failed literal detection until a fixpoint, using
+   the given number of threads. Like pysat's propagate, only variables not
+   fixed by the unit clauses of the formula are counted. counts[i] receives
+   the number of variables up to maxvar that are assigned under
+   candidates[i], or -1 if the candidate failed or its variable is assigned
+   by the assumptions. The negations of the failed candidates are written to
+   learnt (room for nrofcandidates literals) and their number to
+   *nroflearnt; the number of variables up to maxvar assigned by the
+   assumptions alone is written to *assigned. Returns 0 if unit propagation
+   refutes the assumptions, 1 otherwise; if only the failed literals refute
+   them, every count is -1. */
+int march_rewards (march_ctx *ctx, const int *assumptions, int nrofassumptions, const int *candidates, int nrofcandidates, int maxvar, int threads, int *counts, int *learnt, int *nroflearnt, int *assigned);
+
+/* Monte Carlo tree search cubing as in MCTSmode 0 of AlphaMapleSAT (see
+   alpha-zero-general/MCTS.py), with the lookahead of every node done by
+   march_rewards: before each decision, run sims simulations (in
+   ctx->threads threads) from the node, then branch on the variable with the
+   best value found. A node becomes a leaf at the given depth (0 for none),
+   once varsCutoff variables up to maxvar are assigned (0 for none), or if
+   no variable is left to branch on. Every leaf cube, including the refuted
+   ones, is written to out_cubes (or as in march_cube if it is NULL).
+   Returns EXIT_CODE_UNSAT if the assumptions are refuted, and
+   EXIT_CODE_ERROR if there is neither a depth nor a variable cutoff. */
+int march_mcts (march_ctx *ctx, const int *assumptions, int nrofassumptions, int depthCutoff, int varsCutoff, int maxvar, int sims, FILE *out_cubes);
+
+#endif
@@ -0,0 +1,391 @@
+/*
+   MARCH Satisfiability Solver
+
+   Monte Carlo tree search cubing for AlphaMapleSAT, see march_mcts in
+   marchlib.h.
+
+   This follows the search of MCTSmode 0 in alpha-zero-general (MCTS.py,
+   Coach.py and ksgraph/KSLogicMode0.py), with the lookahead of every node
+   done by march_rewards. A node may branch on the three variables with the
+   highest lookahead score; its prior is their normalised score and its
+   value is the normalised score of the decision that led to it. Selecting
+   a variable expands both of its children, and their mean value (minus the
+   variance penalty) is backed up. After the simulations of a node, the cube
+   tree is extended with the variable of the best value found.
+
+   Simulations run in several threads on one shared tree. The tree is
+   protected by a single lock that is only released during the lookahead
+   of new children, which is where the time goes. A selected variable gets
+   a virtual loss until its simulation returns, so that concurrent
+   simulations spread over the tree; with one thread the search is the same
+   as the Python one.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "common.h"
+#include "marchlib.h"
+#include "lookcache.h"
+
+#define MCTS_ACTIONS		3      // LIMIT_TOP_3
+#define MCTS_REFUTED_REWARD	0.1
+#define MCTS_EPS		1e-8
+
+struct mcts_node {
+  int *cube, size;             // the decisions, after the assumptions
+  int *learnt, nroflearnt;     // failed literals under the cube, including those of the parent
+  int conflict;                // the cube is refuted by unit propagation
+  int refuted;                 // no literal left to cube with
+  int assigned;                // variables up to maxvar assigned under the cube
+  double reward;               // value of the node: the score of its last decision
+
+  int nrofactions, vars[ MCTS_ACTIONS ];
+  double score[ MCTS_ACTIONS ], prior[ MCTS_ACTIONS ];
+
+  /* search statistics */
+  int visited, visits;
+  int actionVisits[ MCTS_ACTIONS ], virtualLoss[ MCTS_ACTIONS ], expanding[ MCTS_ACTIONS ];
+  double value[ MCTS_ACTIONS ], best[ MCTS_ACTIONS ];
+  struct mcts_node *children[ MCTS_ACTIONS ][ 2 ]; };
+
+struct mcts {
+  march_ctx *ctx;
+  const int *assumptions;
+  int nrofassumptions, depthCutoff, varsCutoff, maxvar, sims;
+  double maxMetric;
+  int *freeLits, nroffreeLits;   // literals of the variables up to maxvar in binary clauses
+
+  struct look_cache *cache;      // the lookahead of every set of decisions
+  pthread_mutex_t lock, cacheLock;
+  pthread_cond_t expanded;
+  struct mcts_node *root;        // of the running simulations
+  int started;
+
+  FILE *out;
+  int evaluated, leaves, refuted; };
+
+/* the candidates of EvalVarCalc: both literals of every variable up to
+   maxvar that occurs in a binary clause */
+void mcts_free_literals (struct mcts *m) {
+  march_ctx *ctx = m->ctx;
+  char *binary = (char*) calloc (m->maxvar + 1, sizeof (char));
+
+  int i, start = 0;
+  for (i = 0; i < ctx->nrofliterals; i++) {
+    if (ctx->lits[ i ]) continue;
+    if (i - start == 2) {
+      int a = abs (ctx->lits[ start ]), b = abs (ctx->lits[ start + 1 ]);
+      if (a <= m->maxvar) binary[ a ] = 1;
+      if (b <= m->maxvar) binary[ b ] = 1; }
+    start = i + 1; }
+
+  m->freeLits = (int*) malloc (sizeof (int) * (2 * m->maxvar + 1));
+  m->nroffreeLits = 0;
+  for (i = 1; i <= m->maxvar; i++)
+    if (binary[ i ]) {
+      m->freeLits[ m->nroffreeLits++ ] =  i;
+      m->freeLits[ m->nroffreeLits++ ] = -i; }
+  free (binary); }
+
+/* the lookahead of a cube, as stored in the lookahead cache: whether unit
+   propagation refutes it, the number of assigned variables, the variables
+   to cube with and the counts of their literals, and the failed literals */
+#define REWARDS_CONFLICT	0
+#define REWARDS_ASSIGNED	1
+#define REWARDS_ACTIONS		2
+#define REWARDS_VARS		3
+#define REWARDS_POS		(REWARDS_VARS + MCTS_ACTIONS)
+#define REWARDS_NEG		(REWARDS_POS  + MCTS_ACTIONS)
+#define REWARDS_LEARNT		(REWARDS_NEG  + MCTS_ACTIONS)
+
+double mcts_score (int p, int q, int size) {
+  double k = size + 1;
+  return ((double) p * q) / (k * k) + p / k + q / k; }
+
+/* run the lookahead of the cube, assuming the failed literals of its parent
+   (propagate in EvalVarCalc); returns the record and its size */
+int *mcts_lookahead (struct mcts *m, const int *cube, int size, const int *learnt, int nroflearnt, int *count) {
+  int n = m->nroffreeLits;
+  int *record = (int*) calloc (REWARDS_LEARNT + nroflearnt + n + 1, sizeof (int));
+  int *counts = (int*) malloc (sizeof (int) * (n + 1));
+
+  int nrofbase = m->nrofassumptions + size + nroflearnt;
+  int *base    = (int*) malloc (sizeof (int) * (nrofbase + 1));
+  if (m->nrofassumptions) memcpy (base, m->assumptions, sizeof (int) * m->nrofassumptions);
+  if (size)               memcpy (base + m->nrofassumptions, cube, sizeof (int) * size);
+  if (nroflearnt)         memcpy (base + m->nrofassumptions + size, learnt, sizeof (int) * nroflearnt);
+  if (nroflearnt)         memcpy (record + REWARDS_LEARNT, learnt, sizeof (int) * nroflearnt);
+
+  int nrofnew = 0;
+  if (!march_rewards (m->ctx, base, nrofbase, m->freeLits, n, m->maxvar, 1, counts, record + REWARDS_LEARNT + nroflearnt, &nrofnew, &record[ REWARDS_ASSIGNED ]))
+    record[ REWARDS_CONFLICT ] = 1;
+
+  /* the literals come in pairs, and a variable can be cubed with if neither
+     of its literals failed; keep the best ones, as LIMIT_TOP_3 */
+  double score[ MCTS_ACTIONS ];
+  int i, j, nrofactions = 0;
+  for (i = 0; !record[ REWARDS_CONFLICT ] && i < n; i += 2) {
+    if (counts[ i ] < 0 || counts[ i + 1 ] < 0) continue;
+
+    double _score = mcts_score (counts[ i ], counts[ i + 1 ], size);
+    for (j = nrofactions; j > 0 && score[ j - 1 ] < _score; j--)
+      if (j < MCTS_ACTIONS) {
+        score [ j ] = score[ j - 1 ];
+        record[ REWARDS_VARS + j ] = record[ REWARDS_VARS + j - 1 ];
+        record[ REWARDS_POS  + j ] = record[ REWARDS_POS  + j - 1 ];
+        record[ REWARDS_NEG  + j ] = record[ REWARDS_NEG  + j - 1 ]; }
+    if (j < MCTS_ACTIONS) {
+      score [ j ] = _score;
+      record[ REWARDS_VARS + j ] = m->freeLits[ i ];
+      record[ REWARDS_POS  + j ] = counts[ i ];
+      record[ REWARDS_NEG  + j ] = counts[ i + 1 ];
+      if (nrofactions < MCTS_ACTIONS) nrofactions++; } }
+  record[ REWARDS_ACTIONS ] = nrofactions;
+
+  free (base);
+  free (counts);
+
+  __sync_fetch_and_add (&m->evaluated, 1);
+  *count = REWARDS_LEARNT + nroflearnt + nrofnew;
+  return record; }
+
+/* create a node for the cube (calculate_march_metrics in KSLogicMode0). As
+   in EvalVarCalc, the first lookahead of a set of decisions is reused for
+   every order in which they are taken. */
+struct mcts_node *mcts_new_node (struct mcts *m, const int *cube, int size, const int *learnt, int nroflearnt, double reward) {
+  struct mcts_node *node = (struct mcts_node*) calloc (1, sizeof (struct mcts_node));
+  int *key = (int*) malloc (sizeof (int) * (size + 1));
+  if (size) memcpy (key, cube, sizeof (int) * size);
+  sort_cube (key, size);
+
+  const int *data;
+  int *record = NULL, count = 0;
+  pthread_mutex_lock (&m->cacheLock);
+  if (look_cache_find (m->cache, LOOK_CACHE_REWARDS, key, size, &data, &count)) {
+    record = (int*) malloc (sizeof (int) * count);
+    memcpy (record, data, sizeof (int) * count); }
+  pthread_mutex_unlock (&m->cacheLock);
+
+  if (record == NULL) {
+    record = mcts_lookahead (m, cube, size, learnt, nroflearnt, &count);
+    pthread_mutex_lock (&m->cacheLock);
+    int _count;
+    if (!look_cache_find (m->cache, LOOK_CACHE_REWARDS, key, size, &data, &_count))
+      look_cache_insert (m->cache, LOOK_CACHE_REWARDS, key, size, record, count);
+    pthread_mutex_unlock (&m->cacheLock); }
+
+  node->cube       = (int*) malloc (sizeof (int) * (size + 1));
+  node->learnt     = (int*) malloc (sizeof (int) * (count - REWARDS_LEARNT + 1));
+  node->size       = size;
+  node->reward     = reward;
+  node->nroflearnt = count - REWARDS_LEARNT;
+  if (size) memcpy (node->cube, cube, sizeof (int) * size);
+  memcpy (node->learnt, record + REWARDS_LEARNT, sizeof (int) * node->nroflearnt);
+
+  node->conflict    = record[ REWARDS_CONFLICT ];
+  node->assigned    = record[ REWARDS_ASSIGNED ];
+  node->nrofactions = record[ REWARDS_ACTIONS ];
+  node->refuted     = node->conflict || node->nrofactions == 0;
+
+  double sum = 0;
+  int i;
+  for (i = 0; i < node->nrofactions; i++) {
+    node->vars [ i ] = record[ REWARDS_VARS + i ];
+    node->score[ i ] = mcts_score (record[ REWARDS_POS + i ], record[ REWARDS_NEG + i ], size);
+    sum += node->score[ i ]; }
+
+  /* the prior of each literal is its share of the scores, both literals of
+     a variable having the same; the value of a child is the normalised score */
+  for (i = 0; i < node->nrofactions; i++) {
+    node->prior[ i ] = sum > 0 ? node->score[ i ] / (2 * sum) : 1.0 / (2 * node->nrofactions);
+    node->score[ i ] /= m->maxMetric; }
+
+  free (key);
+  free (record);
+  return node; }
+
+void mcts_free_node (struct mcts_node *node) {
+  int i;
+  for (i = 0; i < node->nrofactions; i++)
+    if (node->children[ i ][ 0 ]) {
+      mcts_free_node (node->children[ i ][ 0 ]);
+      mcts_free_node (node->children[ i ][ 1 ]); }
+  free (node->cube);
+  free (node->learnt);
+  free (node); }
+
+int mcts_is_leaf (struct mcts *m, struct mcts_node *node, int depthCutoff) {
+  return node->refuted ||
+    (m->varsCutoff && node->assigned >= m->varsCutoff) ||
+    (depthCutoff && node->size >= depthCutoff); }
+
+/* create both children of the action; called with the lock held, which is
+   released during their lookahead */
+void mcts_expand (struct mcts *m, struct mcts_node *node, int action) {
+  if (node->children[ action ][ 0 ]) return;
+  if (node->expanding[ action ]) {
+    while (node->expanding[ action ]) pthread_cond_wait (&m->expanded, &m->lock);
+    return; }
+
+  node->expanding[ action ] = 1;
+  pthread_mutex_unlock (&m->lock);
+
+  struct mcts_node *children[ 2 ];
+  int *cube = (int*) malloc (sizeof (int) * (node->size + 1)), i;
+  memcpy (cube, node->cube, sizeof (int) * node->size);
+  for (i = 0; i < 2; i++) {
+    cube[ node->size ] = i ? -node->vars[ action ] : node->vars[ action ];
+    children[ i ] = mcts_new_node (m, cube, node->size + 1, node->learnt, node->nroflearnt, node->score[ action ]); }
+  free (cube);
+
+  pthread_mutex_lock (&m->lock);
+  node->children[ action ][ 0 ] = children[ 0 ];
+  node->children[ action ][ 1 ] = children[ 1 ];
+  node->expanding[ action ] = 0;
+  pthread_cond_broadcast (&m->expanded); }
+
+/* one simulation (MCTS.search), called with the lock held */
+double mcts_search (struct mcts *m, struct mcts_node *node) {
+  if (mcts_is_leaf (m, node, m->depthCutoff ? m->depthCutoff + m->ctx->mcts_depth : 0))
+    return node->refuted ? MCTS_REFUTED_REWARD : node->reward;
+
+  if (!node->visited) {
+    node->visited = 1;
+    return node->reward; }
+
+  int i, action = 0, pending = 0;
+  for (i = 0; i < node->nrofactions; i++) pending += node->virtualLoss[ i ];
+
+  double bestU = -INFINITY;
+  for (i = 0; i < node->nrofactions; i++) {
+    int n = node->actionVisits[ i ] + node->virtualLoss[ i ];
+    double u;
+    if (n) u = node->value[ i ] * node->actionVisits[ i ] / n +
+             m->ctx->cpuct * node->prior[ i ] * sqrt (node->visits + pending) / (1 + n);
+    else   u = m->ctx->cpuct * node->prior[ i ] * sqrt (node->visits + pending + MCTS_EPS);
+    if (u > bestU || (u == bestU && node->vars[ i ] < node->vars[ action ])) { bestU = u; action = i; } }
+
+  node->virtualLoss[ action ]++;
+  mcts_expand (m, node, action);
+  double v1 = mcts_search (m, node->children[ action ][ 0 ]);
+  double v2 = mcts_search (m, node->children[ action ][ 1 ]);
+  node->virtualLoss[ action ]--;
+
+  double v = (v1 + v2) / 2 - m->ctx->varpen * fabs (v1 - v2);
+  if (node->actionVisits[ action ] == 0 || v > node->best[ action ]) node->best[ action ] = v;
+  node->value[ action ] = (node->actionVisits[ action ] * node->value[ action ] + v) / (node->actionVisits[ action ] + 1);
+  node->actionVisits[ action ]++;
+  node->visits++;
+  return v; }
+
+void *mcts_loop (void *arg) {
+  struct mcts *m = (struct mcts*) arg;
+
+  pthread_mutex_lock (&m->lock);
+  while (m->started < m->sims) {
+    m->started++;
+    mcts_search (m, m->root); }
+  pthread_mutex_unlock (&m->lock);
+
+  return NULL; }
+
+void mcts_simulate (struct mcts *m, struct mcts_node *node) {
+  int i, threads = m->ctx->threads > 1 ? m->ctx->threads : 1;
+  pthread_t *workers = (pthread_t*) malloc (sizeof (pthread_t) * threads);
+
+  m->root    = node;
+  m->started = 0;
+  for (i = 1; i < threads; i++) pthread_create (&workers[ i ], NULL, mcts_loop, m);
+  mcts_loop (m);
+  for (i = 1; i < threads; i++) pthread_join (workers[ i ], NULL);
+
+  free (workers); }
+
+void mcts_emit (struct mcts *m, struct mcts_node *node) {
+  fprintf (m->out, "a ");
+  int i;
+  for (i = 0; i < m->nrofassumptions; i++) fprintf (m->out, "%d ", m->assumptions[ i ]);
+  for (i = 0; i < node->size; i++) fprintf (m->out, "%d ", node->cube[ i ]);
+  fprintf (m->out, "0\n");
+  fflush (m->out);
+  m->leaves++;
+  if (node->refuted) m->refuted++; }
+
+/* the cube tree (Coach.DFSUtil): every leaf is emitted, refuted ones too */
+void mcts_cube (struct mcts *m, struct mcts_node *node) {
+  if (mcts_is_leaf (m, node, m->depthCutoff)) {
+    mcts_emit (m, node);
+    return; }
+
+  mcts_simulate (m, node);
+
+  /* without any simulation through the node, take the best lookahead */
+  int i, action = 0;
+  for (i = 0; i < node->nrofactions; i++)
+    if (node->actionVisits[ i ] && (!node->actionVisits[ action ] || node->best[ i ] > node->best[ action ] ||
+        (node->best[ i ] == node->best[ action ] && node->vars[ i ] < node->vars[ action ])))
+      action = i;
+
+  pthread_mutex_lock (&m->lock);
+  mcts_expand (m, node, action);
+  pthread_mutex_unlock (&m->lock);
+
+  mcts_cube (m, node->children[ action ][ 0 ]);
+  mcts_cube (m, node->children[ action ][ 1 ]); }
+
+int march_mcts (march_ctx *ctx, const int *assumptions, int nrofassumptions, int depthCutoff, int varsCutoff, int maxvar, int sims, FILE *out_cubes) {
+  struct mcts m;
+
+  if (depthCutoff <= 0 && varsCutoff <= 0) return EXIT_CODE_ERROR;
+
+  m.ctx             = ctx;
+  m.assumptions     = assumptions;
+  m.nrofassumptions = nrofassumptions;
+  m.depthCutoff     = depthCutoff > 0 ? depthCutoff : 0;
+  m.varsCutoff      = varsCutoff  > 0 ? varsCutoff  : 0;
+  m.maxvar          = (maxvar > 0 && maxvar < ctx->nrofvars) ? maxvar : ctx->nrofvars;
+  m.sims            = sims;
+  m.evaluated = m.leaves = m.refuted = 0;
+
+  /* max_metric_val of KSGame */
+  m.maxMetric = m.varsCutoff ? (double) m.varsCutoff * m.varsCutoff : (double) (m.maxvar / 4) * (m.maxvar / 4);
+  if (m.maxMetric <= 0) m.maxMetric = 1;
+
+  if      (out_cubes)                      m.out = out_cubes;
+  else if (ctx->quiet_mode == QUIET_MODE)  m.out = stdout;
+  else                                     m.out = fopen (cubesFile, "w");
+
+  if (ctx->quiet_mode == QUIET_MODE) {
+    printf ("p inccnf\n");
+    int i; for (i = 0; i < ctx->nrofliterals; i++)
+      printf (ctx->lits[ i ] ? "%d " : "%d\n", ctx->lits[ i ]); }
+
+  mcts_free_literals (&m);
+  m.cache = look_cache_open (NULL);
+  pthread_mutex_init (&m.lock, NULL);
+  pthread_mutex_init (&m.cacheLock, NULL);
+  pthread_cond_init (&m.expanded, NULL);
+
+  int result = EXIT_CODE_UNKNOWN;
+  struct mcts_node *root = mcts_new_node (&m, NULL, 0, NULL, 0, 0);
+  if (root->conflict)
+    result = EXIT_CODE_UNSAT;
+  else
+    mcts_cube (&m, root);
+
+  mcts_free_node (root);
+  look_cache_close (m.cache);
+  pthread_mutex_destroy (&m.lock);
+  pthread_mutex_destroy (&m.cacheLock);
+  pthread_cond_destroy (&m.expanded);
+  free (m.freeLits);
+  if (m.out != out_cubes && m.out != stdout) fclose (m.out);
+
+  if (ctx->quiet_mode == 0)
+    printf ("c march_mcts():: %i cubes, %i refuted, %i nodes evaluated\n", m.leaves, m.refuted, m.evaluated);
+
+  return result; }
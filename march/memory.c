@@ -115,7 +115,11 @@ void free_big_clauses_datastructures () {
   FREE( literal_list    );
   FREE( clause_list     );
   FREE( clause_length   );
-  FREE( clause_database ); }
+  FREE( clause_database );
+#ifndef HIDIFF
+  FREE( clause_weight   );
+#endif
+}
 
 void allocateTernaryImp( int **_tImpTable, int ***_tImp, int **_tImpSize )
 {
@@ -322,6 +326,6 @@ void free_BinaryImp()
 	for( i = 0; i < (2 * nrofvars + 1); i++ )
 	    free( BinaryImp[ i ] );
 
-	free( BinaryImp       );
-	free( BinaryImpLength );
+	FREE( BinaryImp       );
+	FREE( BinaryImpLength );
 }
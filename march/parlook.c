@@ -0,0 +1,341 @@
+/*
+   MARCH Satisfiability Solver
+
+   Parallel lookahead, see parlook.h
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "common.h"
+#include "parlook.h"
+#include "lookahead.h"
+#include "doublelook.h"
+#include "tree.h"
+
+/* the segments of the tree a round of the workers looks ahead on, per thread */
+#define SEGMENTS_PER_THREAD 8
+
+/* the per thread state of the lookahead; the main thread uses the solver's
+   own state, the workers point these to private copies */
+__thread tstamp *timeAssignments, currentTimeStamp;
+__thread int *clause_length;
+__thread int *rstackp, *end_fixstackp, *look_fixstackp;
+__thread int *look_resstack, *look_resstackp;
+__thread float DL_trigger_sum;
+__thread long long doublelook_count, doublelook_failed;
+__thread int look_worker;
+
+extern __thread int new_binaries;
+extern __thread float weighted_new_binaries;
+extern int *NBCounter, *failed_DL_stamp;
+extern float *WNBCounter;
+
+#ifdef DL_DECREASE
+extern double DL_decrease;
+#endif
+
+/* what the lookahead on a node of the tree does when it leaves the state of
+   the lookahead as it is; a node is impure if it would change it */
+struct look_result {
+  int impure, looked;
+  int new_binaries;
+  float weighted_new_binaries; };
+
+struct worker_state {
+  pthread_t thread;
+  tstamp *timeAssignments;
+  int *clause_length, *fixstack, *resstack;
+  int *segment_stamp, *new_binaries, segment;
+  float *weighted_new_binaries; };
+
+struct worker_state *workers;
+
+pthread_mutex_t pool_lock;
+pthread_cond_t  pool_start, pool_done;
+int pool_generation, pool_pending, pool_quit;
+
+/* the snapshot the workers copy at the start of a round */
+tstamp *shared_timeAssignments, look_base;
+int *shared_clause_length, *shared_fixstack, *shared_end_fixstackp;
+int next_segment, last_segment;
+
+/* the tree split in segments, the nodes of segment s are the positions
+   segment_start[ s ] up to segment_start[ s + 1 ] of treeArray */
+int *segment_start, nrofsegments;
+tstamp *min_later_gap;
+struct look_result *look_results;
+
+/* split the tree where every later node has a larger gap than all earlier
+   nodes, so that a node never sees the assignments of an earlier segment */
+void find_segments () {
+  int i;
+  tstamp max_gap = 0;
+
+  for (i = tree_elements - 1; i >= 0; i--) {
+    min_later_gap[ i ] = treeArray[ i ].gap;
+    if (i < tree_elements - 1 && min_later_gap[ i + 1 ] < min_later_gap[ i ])
+      min_later_gap[ i ] = min_later_gap[ i + 1 ]; }
+
+  nrofsegments = 0;
+  for (i = 0; i < tree_elements; i++) {
+    if (i == 0 || min_later_gap[ i ] > max_gap) segment_start[ nrofsegments++ ] = i;
+    if (treeArray[ i ].gap > max_gap) max_gap = treeArray[ i ].gap; }
+  segment_start[ nrofsegments ] = tree_elements; }
+
+void worker_snapshot (struct worker_state *ws) {
+  memcpy (ws->timeAssignments - nrofvars, shared_timeAssignments - nrofvars, sizeof (tstamp) * (2 * nrofvars + 1));
+  end_fixstackp  = ws->fixstack;
+  look_fixstackp = ws->fixstack;
+
+  /* the literals on the fixstack of the main thread are restored by the
+     first look_backtrack as they would be by the main thread */
+  if (kSAT_flag) {
+    memcpy (ws->clause_length, shared_clause_length, sizeof (int) * nrofbigclauses);
+    int *p; for (p = shared_fixstack; p < shared_end_fixstackp; p++)
+      *(end_fixstackp++) = *p; } }
+
+/* look ahead on the nodes of segment s as treelookvar does, until a node
+   would change the state of the lookahead */
+void look_segment (struct worker_state *ws, const int s) {
+  int i;
+
+  ws->segment++;
+  for (i = segment_start[ s ]; i < segment_start[ s + 1 ]; i++) {
+    const int nrval = treeArray[ i ].literal;
+    const int parent = assignment_array[ nrval ].parent;
+    struct look_result *r = &look_results[ i ];
+
+    currentTimeStamp = look_base + treeArray[ i ].gap;
+    if (currentTimeStamp >= LOOK_MAX) return;
+
+    r->impure = 1;
+    r->looked = 0;
+    r->new_binaries = 0;
+    r->weighted_new_binaries = 0;
+
+    if ((parent != 0) && IS_FIXED(parent) && IS_NOT_FORCED(parent)) {
+      if (ws->segment_stamp[ parent ] != ws->segment) return;
+      r->new_binaries          = ws->new_binaries[ parent ];
+      r->weighted_new_binaries = ws->weighted_new_binaries[ parent ]; }
+
+    if (IS_FIXED(nrval)) {
+      if (IS_FORCED(nrval)) { r->impure = 0; continue; }
+      if (FIXED_ON_COMPLEMENT(nrval)) return;
+#ifdef AUTARKY
+      return;
+#endif
+      r->impure = 0; continue; }
+
+    r->looked = 1;
+    if (look_IFIUP (nrval) == UNSAT) return;
+    if (look_resstackp > look_resstack) return;
+
+    r->new_binaries          += new_binaries;
+    r->weighted_new_binaries += weighted_new_binaries;
+#ifdef AUTARKY
+    if (new_binaries == 0) return;
+#endif
+
+    const int *loc = BinaryImp[ -nrval ];
+    int j; for (j = 2; j < loc[ 0 ]; j++)
+      if (IS_FIXED(loc[ j ]) && IS_NOT_FORCED(loc[ j ])) return;
+
+    ws->segment_stamp        [ nrval ] = ws->segment;
+    ws->new_binaries         [ nrval ] = r->new_binaries;
+    ws->weighted_new_binaries[ nrval ] = r->weighted_new_binaries;
+    r->impure = 0; } }
+
+void look_job (struct worker_state *ws) {
+  worker_snapshot (ws);
+
+  int s;
+  while ((s = __sync_fetch_and_add (&next_segment, 1)) < last_segment)
+    look_segment (ws, s); }
+
+void *worker_loop (void *arg) {
+  struct worker_state *ws = (struct worker_state*) arg;
+  int generation = 0;
+
+  timeAssignments = ws->timeAssignments;
+  clause_length   = ws->clause_length;
+  rstackp         = ws->fixstack;
+  look_fixstackp  = ws->fixstack;
+  end_fixstackp   = ws->fixstack;
+  look_resstack   = ws->resstack;
+  look_resstackp  = ws->resstack;
+  look_worker     = 1;
+
+  do {
+    pthread_mutex_lock (&pool_lock);
+    while (pool_generation == generation && !pool_quit)
+      pthread_cond_wait (&pool_start, &pool_lock);
+    generation = pool_generation;
+    int quit = pool_quit;
+    pthread_mutex_unlock (&pool_lock);
+
+    if (quit) break;
+
+    look_job (ws);
+
+    pthread_mutex_lock (&pool_lock);
+    if (--pool_pending == 0) pthread_cond_signal (&pool_done);
+    pthread_mutex_unlock (&pool_lock); }
+  while (1);
+
+  return NULL; }
+
+/* look ahead on the segments from s on the current state; returns the
+   segment after the last one */
+int speculate (const int s) {
+  shared_timeAssignments = timeAssignments;
+  shared_clause_length   = clause_length;
+  shared_fixstack        = rstackp;
+  shared_end_fixstackp   = end_fixstackp;
+  look_base              = currentTimeStamp;
+  next_segment           = s;
+  last_segment           = s + SEGMENTS_PER_THREAD * look_threads;
+  if (last_segment > nrofsegments) last_segment = nrofsegments;
+
+  pthread_mutex_lock (&pool_lock);
+  pool_pending = look_threads;
+  pool_generation++;
+  pthread_cond_broadcast (&pool_start);
+  while (pool_pending) pthread_cond_wait (&pool_done, &pool_lock);
+  pthread_mutex_unlock (&pool_lock);
+
+  return last_segment; }
+
+void init_parallel_lookahead () {
+  int i;
+
+  look_results  = (struct look_result*) malloc (sizeof (struct look_result) * (2 * nrofvars + 1));
+  segment_start = (int*) malloc (sizeof (int) * (2 * nrofvars + 2));
+  min_later_gap = (tstamp*) malloc (sizeof (tstamp) * (2 * nrofvars + 1));
+
+  pthread_mutex_init (&pool_lock, NULL);
+  pthread_cond_init (&pool_start, NULL);
+  pthread_cond_init (&pool_done, NULL);
+  pool_generation = pool_pending = pool_quit = 0;
+
+  workers = (struct worker_state*) malloc (sizeof (struct worker_state) * look_threads);
+  for (i = 0; i < look_threads; i++) {
+    struct worker_state *ws = &workers[ i ];
+    ws->timeAssignments = (tstamp*) malloc (sizeof (tstamp) * (2 * nrofvars + 1)) + nrofvars;
+    ws->clause_length   = (int*) malloc (sizeof (int) * (nrofbigclauses + 1));
+    ws->fixstack        = (int*) malloc (sizeof (int) * (3 * nrofvars + 1));
+    ws->resstack        = (int*) malloc (sizeof (int) * (2 * nrofvars + 1));
+    ws->segment_stamp   = (int*) calloc (2 * nrofvars + 1, sizeof (int)) + nrofvars;
+    ws->new_binaries    = (int*) malloc (sizeof (int) * (2 * nrofvars + 1)) + nrofvars;
+    ws->weighted_new_binaries = (float*) malloc (sizeof (float) * (2 * nrofvars + 1)) + nrofvars;
+    ws->segment         = 0;
+    pthread_create (&ws->thread, NULL, worker_loop, ws); } }
+
+void dispose_parallel_lookahead () {
+  int i;
+
+  pthread_mutex_lock (&pool_lock);
+  pool_quit = 1;
+  pthread_cond_broadcast (&pool_start);
+  pthread_mutex_unlock (&pool_lock);
+
+  for (i = 0; i < look_threads; i++) {
+    struct worker_state *ws = &workers[ i ];
+    pthread_join (ws->thread, NULL);
+    FREE_OFFSET( ws->timeAssignments );
+    FREE( ws->clause_length );
+    FREE( ws->fixstack );
+    FREE( ws->resstack );
+    FREE_OFFSET( ws->segment_stamp );
+    FREE_OFFSET( ws->new_binaries );
+    FREE_OFFSET( ws->weighted_new_binaries ); }
+  FREE( workers );
+
+  pthread_mutex_destroy (&pool_lock);
+  pthread_cond_destroy (&pool_start);
+  pthread_cond_destroy (&pool_done);
+
+  FREE( look_results  );
+  FREE( segment_start );
+  FREE( min_later_gap ); }
+
+/* the number of nodes of segment s the lookahead takes the results of the
+   workers for, or -1 if the segment has to be looked ahead on again;
+   *stop tells whether the lookahead ends after these nodes */
+int check_segment (const int s, const int lastChanged, int *stop) {
+  float trigger = DL_trigger;
+  int i;
+
+  *stop = 0;
+  for (i = segment_start[ s ]; i < segment_start[ s + 1 ]; i++) {
+    const int nrval = treeArray[ i ].literal;
+    const struct look_result *r = &look_results[ i ];
+
+    if (nrval == lastChanged || currentTimeStamp + treeArray[ i ].gap >= LOOK_MAX) {
+      *stop = 1;
+      return i - segment_start[ s ]; }
+
+    if (r->impure) return -1;
+
+    /* the trigger of check_doublelook */
+    if (r->looked && dl_iter != 0 && failed_DL_stamp[ nrval ] != nodeCount) {
+      if (r->weighted_new_binaries > trigger) return -1;
+#ifdef DL_DECREASE
+      trigger *= DL_decrease;
+#endif
+    } }
+
+  return i - segment_start[ s ]; }
+
+void commit_segment (const int s, const int nodes) {
+  int i;
+
+  for (i = segment_start[ s ]; i < segment_start[ s ] + nodes; i++) {
+    const int nrval = treeArray[ i ].literal;
+    const struct look_result *r = &look_results[ i ];
+
+    NBCounter [ nrval ] = r->new_binaries;
+    WNBCounter[ nrval ] = r->weighted_new_binaries;
+    if (r->looked == 0) continue;
+
+    lookAheadCount++;
+    if (dl_iter != 0 && failed_DL_stamp[ nrval ] != nodeCount) {
+      dl_possibility_counter++;
+#ifdef DL_DECREASE
+      DL_trigger *= DL_decrease;
+#endif
+    } } }
+
+int parallel_lookahead () {
+  int iterCount   = 0;
+  int lastChanged = 0;
+
+  init_lookahead_procedure ();
+  find_segments ();
+
+  do {
+    iterCount++;
+    int _forced_literals = forced_literals;
+    int s = 0;
+    while (s < nrofsegments) {
+      int last = speculate (s);
+      for (; s < last; s++) {
+        int stop, nodes = check_segment (s, lastChanged, &stop);
+        if (nodes >= 0) {
+          commit_segment (s, nodes);
+          if (stop) return SAT;
+          continue; }
+
+        /* the segment changes the state: look ahead on it as tree_lookahead
+           does, and look ahead on the later segments again after it */
+        int i; for (i = segment_start[ s ]; i < segment_start[ s + 1 ]; i++) {
+          int _result = tree_lookahead_node (treeArray[ i ], &_forced_literals, &lastChanged);
+          if (_result != SAT) return _result == UNSAT ? UNSAT : SAT; }
+        s++;
+        break; } }
+    currentTimeStamp += 2 * tree_elements;
+  } while (lastChanged != 0 && iterCount <= sl_iter);
+
+  return SAT; }
@@ -0,0 +1,26 @@
+/*
+   MARCH Satisfiability Solver
+
+   Parallel lookahead (option -t): the tree lookahead of tree_lookahead,
+   with the nodes of the tree looked ahead on by a pool of worker threads,
+   each on a private copy of the assignment and its own propagation stacks,
+   while the clause database is shared read-only. The tree is split into
+   segments whose nodes cannot see the assignments of earlier segments;
+   the workers look ahead on the next segments on a snapshot of the state,
+   and the main thread takes their results in the order of the tree. A
+   segment that would change the state (a failed literal, a windfall
+   resolvent, a necessary assignment or a doublelook) is looked ahead on
+   again by the main thread, as tree_lookahead does, and the later segments
+   on the new state. So the lookahead, and the cubes, are the same as
+   without -t for any number of threads. Without INTELLOOK, -t is ignored.
+*/
+
+#ifndef __PARLOOK_H__
+#define __PARLOOK_H__
+
+void init_parallel_lookahead ();
+void dispose_parallel_lookahead ();
+
+int parallel_lookahead ();
+
+#endif
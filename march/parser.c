@@ -45,13 +45,40 @@ int *simplify_stack, *simplify_stackp;
 */
 int initFormula( FILE* in )
 {
-	int result;
+	int result, _nrofvars = 0, _nrofclauses = 0;
 
+	/*
+		search for p-line in DIMACS format
+	*/
+	do
+	{
+		result = fscanf( in, " p cnf %i %i \n", &( _nrofvars ), &( _nrofclauses ) );
+		if( result > 0 && result != EOF )
+			break;
+
+		result = fscanf( in, "%*s\n" );
+	}
+	while (result != 2 && result != EOF);
+
+	if (result == EOF || result != 2) return 0;
+
+	initFormulaSize( _nrofvars, _nrofclauses );
+
+	return 1;
+}
+
+/*
+	Same as initFormula, but with the size given directly instead of by a p-line.
+
+	MALLOCS: 	-
+	REALLOCS:	-
+	FREES:	 	-
+*/
+void initFormulaSize( int _nrofvars, int _nrofclauses )
+{
 	/*
 		initialize global data structure.
 	*/
-	original_nrofvars    = 0;
-	original_nrofclauses = 0;
 	nrofvars             = 0;
 	activevars           = 0;
 	nrofclauses          = 0;
@@ -67,22 +94,10 @@ int initFormula( FILE* in )
 	timeAssignments      = NULL;
 	VeqDepends           = NULL;
 
-	/*
-		search for p-line in DIMACS format
-	*/
-	do
-	{
-		result = fscanf( in, " p cnf %i %i \n", &( original_nrofvars ), &( original_nrofclauses ) );
-		if( result > 0 && result != EOF )
-			break;
-
-		result = fscanf( in, "%*s\n" );
-	}
-	while (result != 2 && result != EOF);
-
-	if (result == EOF || result != 2) return 0;
+	original_nrofvars    = _nrofvars;
+	original_nrofclauses = _nrofclauses;
 
-        if (quiet_mode) printf ("p inccnf\n");
+        if (quiet_mode == QUIET_MODE) printf ("p inccnf\n");
 
 	nrofvars    = original_nrofvars;
 	activevars  = original_nrofvars;
@@ -100,15 +115,13 @@ int initFormula( FILE* in )
 
         if (quiet_mode == 0)
           printf( "c the DIMACS p-line indicates a CNF of %i variables and %i clauses.\n", nrofvars, nrofclauses );
-
-	return 1;
 }
 
 
 /*
 	MALLOCS: 	-
 	REALLOCS:	-
-	FREES:	 	Cv[ * ], Cv, Clength, timeAssignments, VeqDepends
+	FREES:	 	Cv[ * ], Cv, Clength, BinaryImp, timeAssignments, VeqDepends
 */
 void disposeFormula () {
 /* Can also be used to delete a partial formula, because Cv[ i ]
@@ -131,6 +144,11 @@ void disposeFormula () {
   FREE_OFFSET( timeAssignments );
   FREE( VeqDepends );
   FREE( Clength );
+  free_BinaryImp ();
+
+/* Before nrofvars is reset, since it gives the size of Veq. */
+
+  dispose_equivalence ();
 
 /* Update cnf structure. */
 
@@ -138,27 +156,16 @@ void disposeFormula () {
   original_nrofclauses = 0;
   nrofvars 	       = 0;
   nrofclauses	       = 0;
-
-  dispose_equivalence ();
 }
 
 /*
-	MALLOCS: 	_clause, Cv, Cv[], Clength, timeAssignments
+	MALLOCS: 	Cv, Clength, BinaryImp, timeAssignments, VeqDepends
 	REALLOCS:	-
-	FREES:	 	_clause
+	FREES:	 	-
 */
-int parseCNF( FILE* in )
+void allocateFormula()
 {
-	int *_clause, clen, _lit;
-	int i, j, error;
-
-	int unary = 0;
-
-	/*
-		Allocate buffer to hold clause. A clause can never
-		be longer than nrofvars, for obvious reasons.
-	*/
-	_clause = (int*) malloc( sizeof( int ) * nrofvars );
+	int i;
 
 	/* INIT GLOBAL DATASTRUCTURES!! */
 
@@ -196,6 +203,25 @@ int parseCNF( FILE* in )
 	    timeAssignments[  i ] = 0;
 	    timeAssignments[ -i ] = 0;
 	}
+}
+
+/*
+	MALLOCS: 	_clause, Cv, Cv[], Clength, timeAssignments
+	REALLOCS:	-
+	FREES:	 	_clause
+*/
+int parseCNF( FILE* in )
+{
+	int *_clause, clen, _lit;
+	int i, error;
+
+	/*
+		Allocate buffer to hold clause. A clause can never
+		be longer than nrofvars, for obvious reasons.
+	*/
+	_clause = (int*) malloc( sizeof( int ) * nrofvars );
+
+	allocateFormula();
 
 	i = clen = error = 0;
 	while( i < nrofclauses && !error )
@@ -214,16 +240,8 @@ int parseCNF( FILE* in )
 		    }
 		    else
 		    {
-			if( clen == 1 )
-			    unary++;
-
-			Cv[ i ] = (int*) malloc( sizeof( int ) * clen );
-			Clength[ i ] = clen;
-                        if (quiet_mode) {
-  			  for (j = 0; j < clen; j++) printf ("%i ", _clause[j]);
-                          printf ("0\n"); }
-			for( j = 0; j < clen; j++ ) Cv[ i ][ j ] = _clause[ j ];
-			    clen = 0;
+			storeClause( i, _clause, clen );
+			clen = 0;
 			i++;
 		    }
 		}
@@ -244,14 +262,62 @@ int parseCNF( FILE* in )
 	/* free clause buffer */
 	free( _clause );
 
-//	if( !error )
-//	    printf( "c parseCNF():: the CNF contains %i unary clauses.\n", unary );
 	if( error )
 	    disposeFormula();
 
 	return !error;
 }
 
+void storeClause( int i, const int *_clause, int clen )
+{
+	int j;
+
+	Cv[ i ] = (int*) malloc( sizeof( int ) * clen );
+	Clength[ i ] = clen;
+        if (quiet_mode == QUIET_MODE) {
+	  for (j = 0; j < clen; j++) printf ("%i ", _clause[j]);
+          printf ("0\n"); }
+	for( j = 0; j < clen; j++ ) Cv[ i ][ j ] = _clause[ j ];
+}
+
+/*
+	Counterpart of parseCNF for clauses in memory: nrofclauses zero-terminated
+	clauses are read from lits.
+
+	MALLOCS: 	Cv, Cv[], Clength, timeAssignments
+	REALLOCS:	-
+	FREES:	 	-
+*/
+int loadCNF( const int *lits )
+{
+	int i, clen;
+
+	allocateFormula();
+
+	for( i = 0; i < nrofclauses; i++ )
+	{
+	    for( clen = 0; lits[ clen ] != 0; clen++ )
+		if( abs( lits[ clen ] ) > nrofvars )
+		{
+		    printf( "c WARNING: literal %i exceeds the number of variables.\n", lits[ clen ] );
+		    disposeFormula();
+		    return 0;
+		}
+
+	    if( clen == 0 )
+	    {
+		printf( "c WARNING: zero length clause found in input!\n" );
+		disposeFormula();
+		return 0;
+	    }
+
+	    storeClause( i, lits, clen );
+	    lits += clen + 1;
+	}
+
+	return 1;
+}
+
 int simplify_formula () {
   int _iterCounter    = 0;
   int tautologies     = 0;
@@ -306,22 +372,28 @@ int sort_literals () {
   return count; }
 
 int find_and_propagate_unary_clauses () {
-  int i;
-
   simplify_stack = (int*) malloc (sizeof(int) * (nrofvars + 1));
   simplify_stackp = simplify_stack;
 
+  int result = push_unary_clauses();
+  if (result != UNSAT) result = propagate_unary_clauses();
+
+  free (simplify_stack);
+
+  return result; }
+
+/* PUSH_PARSER_NA returns UNSAT on a conflict, so the callers of the
+   functions that use it free what they allocated */
+int push_unary_clauses () {
+  int i;
+
   for (i = 0; i < nrofclauses; i++)
     if (Clength[ i ] == 1) { PUSH_PARSER_NA( Cv[ i ][ 0 ] ); }
 
   for (i = 0; i < nrofceq; i++)
     if (CeqSizes[ i ] == 1) { PUSH_PARSER_NA( Ceq[ i ][ 0 ] * CeqValues[ i ] ); }
 
-  int result = propagate_unary_clauses();
-
-  free (simplify_stack);
-
-  return result; }
+  return SAT; }
 
 /*
 	MALLOCS: 	_Vc, _Vc[], _VcTemp
@@ -330,15 +402,29 @@ int find_and_propagate_unary_clauses () {
 */
 int propagate_unary_clauses()
 {
-        int i, j, nrval, clsidx, *_simplify_stackp;
+        int result;
         int **_variableArray;
 
-
-	_simplify_stackp = simplify_stack;
-
 	allocateSmallVc( &_variableArray , 1 );
 	_variableArray += nrofvars;
 
+	result = propagate_unary_occurrences( _variableArray );
+
+	/*
+		Free temporary allocated space.
+	*/
+	_variableArray -= nrofvars;
+	freeSmallVc( _variableArray );
+
+	return result;
+}
+
+int propagate_unary_occurrences( int **_variableArray )
+{
+        int i, j, nrval, clsidx, *_simplify_stackp;
+
+	_simplify_stackp = simplify_stack;
+
 	/* fix monotone variables that do not occur in equivalence clauses */
 #ifdef FIX_MONOTONE
 	for( i = 1; i <= nrofvars; i++ )
@@ -405,12 +491,6 @@ int propagate_unary_clauses()
 		}
 	}
 
-	/*
-		Free temporary allocated space.
-	*/
-	_variableArray -= nrofvars;
-	freeSmallVc( _variableArray );
-
 	return 1;
 }
 
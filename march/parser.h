@@ -30,8 +30,14 @@
 	Parsing...
 */
 int initFormula( FILE* in );
+void initFormulaSize( int _nrofvars, int _nrofclauses );
+void allocateFormula();
 int parseCNF( FILE* in );
+int loadCNF( const int *lits );
+void storeClause( int i, const int *_clause, int clen );
+int push_unary_clauses( );
 int propagate_unary_clauses( );
+int propagate_unary_occurrences( int **_variableArray );
 void disposeFormula();
 
 int simplify_formula();
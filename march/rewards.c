@@ -0,0 +1,300 @@
+/*
+   MARCH Satisfiability Solver
+
+   Lookahead rewards for AlphaMapleSAT, see march_rewards in marchlib.h.
+
+   This is plain unit propagation on the loaded formula, independent of the
+   solver state of march, so it can run next to march_cube. Propagation
+   counts the falsified literals of each clause instead of watching two of
+   them, so the clause database stays read-only and every thread only needs
+   its own assignment, counters and trail.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "marchlib.h"
+#include "rewards.h"
+
+struct reward_engine {
+  int nrofliterals;                 // of the context when the engine was built
+  int nrofvars, nrofclauses;
+  int *clauseLits, *clauseStart;    // clause i is clauseLits[clauseStart[i] .. clauseStart[i+1])
+  int *occStart, *occ;              // the clauses of literal l are occ[occStart[l] .. occStart[l+1]), offset by nrofvars
+  int *units, nrofunits, empty; };  // unit clauses and whether there is an empty clause
+
+struct reward_worker {
+  pthread_t thread;
+  signed char *value;
+  int *falseCount, *trail, trailSize, processed, conflict; };
+
+struct reward_job {
+  struct reward_engine *engine;
+  struct reward_worker *workers;
+  const int *base, *candidates;
+  int nrofbase, nrofcandidates, maxvar, baseAssigned;
+  int *counts, *failed;
+  int next; };
+
+struct reward_arg {
+  struct reward_job *job;
+  int index; };
+
+/* sort the literals of a clause and remove duplicates; returns 0 for a
+   tautology, otherwise the new size */
+int normalize_clause (int *lits, int size) {
+  int i, j, k;
+  for (i = 1; i < size; i++)
+    for (j = i; j > 0 && abs (lits[ j - 1 ]) > abs (lits[ j ]); j--) {
+      int tmp = lits[ j ]; lits[ j ] = lits[ j - 1 ]; lits[ j - 1 ] = tmp; }
+
+  for (i = 0, k = 0; i < size; i++) {
+    if (k && lits[ k - 1 ] == -lits[ i ]) return 0;
+    if (k && lits[ k - 1 ] ==  lits[ i ]) continue;
+    lits[ k++ ] = lits[ i ]; }
+  return k; }
+
+struct reward_engine *build_reward_engine (march_ctx *ctx) {
+  struct reward_engine *e = (struct reward_engine*) malloc (sizeof (struct reward_engine));
+  int i, n = ctx->nrofvars;
+
+  e->nrofliterals = ctx->nrofliterals;
+  e->nrofvars     = n;
+  e->nrofclauses  = 0;
+  e->nrofunits    = 0;
+  e->empty        = 0;
+  e->clauseLits   = (int*) malloc (sizeof (int) * (ctx->nrofliterals + 1));
+  e->clauseStart  = (int*) malloc (sizeof (int) * (ctx->nrofclauses + 1));
+  e->units        = (int*) malloc (sizeof (int) * (ctx->nrofclauses + 1));
+  e->occStart     = (int*) calloc (2 * n + 2, sizeof (int));
+
+  int used = 0, start = 0;
+  for (i = 0; i < ctx->nrofliterals; i++) {
+    if (ctx->lits[ i ] != 0) continue;
+
+    int size = i - start;
+    memcpy (e->clauseLits + used, ctx->lits + start, sizeof (int) * size);
+    start = i + 1;
+
+    if (size == 0) { e->empty = 1; continue; }
+    size = normalize_clause (e->clauseLits + used, size);
+    if (size == 0) continue;
+    if (size == 1) { e->units[ e->nrofunits++ ] = e->clauseLits[ used ]; continue; }
+
+    e->clauseStart[ e->nrofclauses++ ] = used;
+    int j; for (j = 0; j < size; j++)
+      e->occStart[ e->clauseLits[ used + j ] + n + 1 ]++;
+    used += size; }
+  e->clauseStart[ e->nrofclauses ] = used;
+
+  for (i = 1; i <= 2 * n + 1; i++) e->occStart[ i ] += e->occStart[ i - 1 ];
+
+  int *fill = (int*) malloc (sizeof (int) * (2 * n + 1));
+  memcpy (fill, e->occStart, sizeof (int) * (2 * n + 1));
+  e->occ = (int*) malloc (sizeof (int) * (used + 1));
+  for (i = 0; i < e->nrofclauses; i++) {
+    int j; for (j = e->clauseStart[ i ]; j < e->clauseStart[ i + 1 ]; j++)
+      e->occ[ fill[ e->clauseLits[ j ] + n ]++ ] = i; }
+  free (fill);
+
+  return e; }
+
+void free_reward_engine (struct reward_engine *e) {
+  free (e->clauseLits);
+  free (e->clauseStart);
+  free (e->occStart);
+  free (e->occ);
+  free (e->units);
+  free (e); }
+
+void init_reward_worker (struct reward_worker *w, struct reward_engine *e) {
+  w->value      = (signed char*) calloc (e->nrofvars + 1, sizeof (signed char));
+  w->falseCount = (int*) calloc (e->nrofclauses + 1, sizeof (int));
+  w->trail      = (int*) malloc (sizeof (int) * (e->nrofvars + 1));
+  w->trailSize  = 0;
+  w->processed  = 0;
+  w->conflict   = 0; }
+
+void dispose_reward_worker (struct reward_worker *w) {
+  free (w->value);
+  free (w->falseCount);
+  free (w->trail); }
+
+/* returns 0 if the literal is already false */
+int reward_assign (struct reward_worker *w, const int lit) {
+  int v = abs (lit), s = lit > 0 ? 1 : -1;
+  if (w->value[ v ]) return w->value[ v ] == s;
+  w->value[ v ] = s;
+  w->trail[ w->trailSize++ ] = lit;
+  return 1; }
+
+/* propagate the unprocessed part of the trail; returns 0 on a conflict */
+int reward_propagate (struct reward_worker *w, struct reward_engine *e) {
+  while (w->processed < w->trailSize) {
+    int lit = w->trail[ w->processed++ ];
+    int *p   = e->occ + e->occStart[ -lit + e->nrofvars ];
+    int *end = e->occ + e->occStart[ -lit + e->nrofvars + 1 ];
+
+    for (; p < end; p++) {
+      int c = *p;
+      int size = e->clauseStart[ c + 1 ] - e->clauseStart[ c ];
+      if (++w->falseCount[ c ] < size - 1 || w->conflict) continue;
+
+      if (w->falseCount[ c ] == size) { w->conflict = 1; continue; }
+
+      /* one literal left: the clause is satisfied or unit */
+      int *l = e->clauseLits + e->clauseStart[ c ], unit = 0, j;
+      for (j = 0; j < size; j++) {
+        int v = abs (l[ j ]);
+        if (w->value[ v ] == 0) unit = l[ j ];
+        else if ((w->value[ v ] > 0) == (l[ j ] > 0)) break; }
+      if (j == size) {
+        if (unit) reward_assign (w, unit);
+        else w->conflict = 1; } }
+
+    /* the counters of the conflicting literal are complete, so it can be
+       undone like the others */
+    if (w->conflict) return 0; }
+  return 1; }
+
+void reward_undo (struct reward_worker *w, struct reward_engine *e, int mark) {
+  while (w->trailSize > mark) {
+    int lit = w->trail[ --w->trailSize ];
+    if (w->trailSize < w->processed) {
+      int *p;
+      for (p = e->occ + e->occStart[ -lit + e->nrofvars ]; p < e->occ + e->occStart[ -lit + e->nrofvars + 1 ]; p++)
+        w->falseCount[ *p ]--; }
+    w->value[ abs (lit) ] = 0; }
+  if (w->processed > mark) w->processed = mark;
+  w->conflict = 0; }
+
+int count_assigned (struct reward_worker *w, int from, int maxvar) {
+  int i, count = 0;
+  for (i = from; i < w->trailSize; i++)
+    if (abs (w->trail[ i ]) <= maxvar) count++;
+  return count; }
+
+/* assign the formula units and the base literals; returns 0 on a conflict */
+int reward_base (struct reward_worker *w, struct reward_engine *e, const int *base, int nrofbase, int *level0) {
+  reward_undo (w, e, 0);
+  if (e->empty) return 0;
+
+  int i;
+  for (i = 0; i < e->nrofunits; i++)
+    if (!reward_assign (w, e->units[ i ])) return 0;
+  if (!reward_propagate (w, e)) return 0;
+  *level0 = w->trailSize;
+
+  for (i = 0; i < nrofbase; i++)
+    if (!reward_assign (w, base[ i ])) return 0;
+  return reward_propagate (w, e); }
+
+void *reward_loop (void *arg) {
+  struct reward_job *job = ((struct reward_arg*) arg)->job;
+  struct reward_worker *w = job->workers + ((struct reward_arg*) arg)->index;
+  struct reward_engine *e = job->engine;
+  int level0;
+
+  if (!reward_base (w, e, job->base, job->nrofbase, &level0)) return NULL;
+  int mark = w->trailSize;
+
+  int i;
+  while ((i = __sync_fetch_and_add (&job->next, 1)) < job->nrofcandidates) {
+    int lit = job->candidates[ i ];
+    if (job->counts[ i ] == -2) continue; // skipped
+
+    if (w->value[ abs (lit) ]) {
+      if ((w->value[ abs (lit) ] > 0) == (lit > 0)) job->counts[ i ] = job->baseAssigned;
+      else job->failed[ i ] = 1;
+      continue; }
+
+    reward_assign (w, lit);
+    if (reward_propagate (w, e))
+      job->counts[ i ] = job->baseAssigned + count_assigned (w, mark, job->maxvar);
+    else
+      job->failed[ i ] = 1;
+    reward_undo (w, e, mark); }
+
+  return NULL; }
+
+int march_rewards (march_ctx *ctx, const int *assumptions, int nrofassumptions, const int *candidates, int nrofcandidates, int maxvar, int threads, int *counts, int *learnt, int *nroflearnt, int *assigned) {
+  if (ctx->rewards && ctx->rewards->nrofliterals != ctx->nrofliterals) {
+    free_reward_engine (ctx->rewards);
+    ctx->rewards = NULL; }
+  if (ctx->rewards == NULL) ctx->rewards = build_reward_engine (ctx);
+
+  struct reward_engine *e = ctx->rewards;
+  if (maxvar <= 0 || maxvar > e->nrofvars) maxvar = e->nrofvars;
+  if (threads < 1) threads = 1;
+
+  int i, level0, result = 1;
+  int *base = (int*) malloc (sizeof (int) * (nrofassumptions + nrofcandidates + 1));
+  int nrofbase = nrofassumptions;
+  memcpy (base, assumptions, sizeof (int) * nrofassumptions);
+
+  int *failed = (int*) malloc (sizeof (int) * (nrofcandidates + 1));
+  struct reward_worker *workers = (struct reward_worker*) malloc (sizeof (struct reward_worker) * threads);
+  struct reward_arg *args = (struct reward_arg*) malloc (sizeof (struct reward_arg) * threads);
+  for (i = 0; i < threads; i++) init_reward_worker (&workers[ i ], e);
+
+  *nroflearnt = 0;
+  *assigned   = 0;
+
+  /* the candidates that fail are added to the base until none fails */
+  int pass; for (pass = 0; ; pass++) {
+    struct reward_worker *w = &workers[ 0 ];
+    /* after the first pass, a conflict means that the failed literals refute
+       the assumptions: as in EvalVarCalc, no candidate is left then */
+    if (!reward_base (w, e, base, nrofbase, &level0)) {
+      if (pass == 0) result = 0;
+      for (i = 0; i < nrofcandidates; i++) counts[ i ] = -1;
+      break; }
+
+    struct reward_job job;
+    job.engine         = e;
+    job.workers        = workers;
+    job.base           = base;
+    job.nrofbase       = nrofbase;
+    job.candidates     = candidates;
+    job.nrofcandidates = nrofcandidates;
+    job.maxvar         = maxvar;
+    job.baseAssigned   = count_assigned (w, level0, maxvar);
+    job.counts         = counts;
+    job.failed         = failed;
+    job.next           = 0;
+    if (pass == 0) *assigned = job.baseAssigned;
+
+    /* as the restarts of EvalVarCalc, skip the candidates on variables of
+       the assumptions and the learnt literals */
+    for (i = 0; i < nrofcandidates; i++) {
+      failed[ i ] = 0;
+      counts[ i ] = -1;
+      int j; for (j = 0; j < nrofbase; j++)
+        if (abs (base[ j ]) == abs (candidates[ i ])) counts[ i ] = -2; }
+
+    for (i = 0; i < threads; i++) {
+      args[ i ].job   = &job;
+      args[ i ].index = i;
+      if (i) pthread_create (&workers[ i ].thread, NULL, reward_loop, &args[ i ]); }
+    reward_loop (&args[ 0 ]);
+    for (i = 1; i < threads; i++) pthread_join (workers[ i ].thread, NULL);
+
+    int nroffailed = 0;
+    for (i = 0; i < nrofcandidates; i++)
+      if (failed[ i ]) {
+        base[ nrofbase++ ] = learnt[ (*nroflearnt)++ ] = -candidates[ i ];
+        nroffailed++; }
+    if (nroffailed == 0) break; }
+
+  for (i = 0; i < nrofcandidates; i++)
+    if (counts[ i ] < -1 || !result) counts[ i ] = -1;
+
+  for (i = 0; i < threads; i++) dispose_reward_worker (&workers[ i ]);
+  free (workers);
+  free (args);
+  free (failed);
+  free (base);
+
+  return result; }
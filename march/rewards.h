@@ -0,0 +1,14 @@
+/*
+   MARCH Satisfiability Solver
+
+   Lookahead rewards for AlphaMapleSAT, see march_rewards in marchlib.h
+*/
+
+#ifndef __REWARDS_H__
+#define __REWARDS_H__
+
+struct reward_engine;
+
+void free_reward_engine (struct reward_engine *e);
+
+#endif
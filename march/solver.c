@@ -402,14 +402,30 @@ void disposeSolver () {
 
   FREE_OFFSET( TernaryImp        );
   FREE_OFFSET( TernaryImpSize    );
+  FREE_OFFSET( TernaryImpLast    );
+  FREE( TernaryImpTable );
   FREE_OFFSET( tmpTernaryImpSize );
   FREE_OFFSET( bImp_stamps       );
   FREE_OFFSET( bImp_satisfied    );
+  FREE_OFFSET( bImp_start        );
   FREE_OFFSET( node_stamps       );
 
   FREE( tmpEqImpSize );
   FREE( impstack );
   FREE( rstack );
+  FREE( subsumestack );
+  FREE( bieqstack );
+  FREE( newbistack );
+  FREE( substack );
+  FREE_OFFSET( TernaryImpReduction );
+
+  FREE( decisions );
+  FREE( var_weight );
+  FREE( trail );
+  FREE( CDCL.DB );
+#ifdef CUBE
+  dispose_assumptions();
+#endif
 }
 
 int propagate_forced_literals() {
@@ -676,6 +692,12 @@ int march_solve_rec() {
 	}
 	while( (percentage_forced > 50.0) || (branch_literal == 0) );
 
+	if (rootForced && depth == 0) {
+	    int i; nrofRootForced = 0;
+	    for (i = 1; i <= original_nrofvars; i++)
+		if (IS_FORCED(i))
+		    rootForced[ nrofRootForced++ ] = FIXED_ON_COMPLEMENT(i) ? -i : i; }
+
 	_percentage_forced = percentage_forced;
 
 	if (gah && depth == 0) {
@@ -1557,24 +1579,27 @@ int verifySolution()
 	dollars = solution_bits - depth;
 	if( dollars < 1 ) dollars = 1;
 
-	printf("\nc |" );
-	for( i = solution_bits; i >= dollars; i-- )
+	if( quiet_mode != LIBRARY_MODE )
 	{
+	    printf("\nc |" );
+	    for( i = solution_bits; i >= dollars; i-- )
+	    {
 #ifdef DISTRIBUTION
-	    if( solution_bits - i == jump_depth ) printf(".");
+		if( solution_bits - i == jump_depth ) printf(".");
 #endif
 #ifdef SUPER_LINEAR
-	    if( solution_bits - i == sl_depth ) printf(".");
+		if( solution_bits - i == sl_depth ) printf(".");
 #endif
-	    if( ((solution_bin & mask) >> i) > 0 ) printf("1");
-	    else printf("0");
-	    mask = mask >> 1;
-	}
+		if( ((solution_bin & mask) >> i) > 0 ) printf("1");
+		else printf("0");
+		mask = mask >> 1;
+	    }
 
-	for( i = solution_bits - depth; i >= 2; i-- )
-	   printf("$");
+	    for( i = solution_bits - depth; i >= 2; i-- )
+		printf("$");
 
-	printf("|\n");
+	    printf("|\n");
+	}
 #else
         printf("s %i\n", solution_bin + 1);
 	fflush( stdout );
@@ -1603,10 +1628,13 @@ int verifySolution()
 
   	    if( !satisfied )
 	    {
-	 	printf("\nc clause %i: ", i);
-		for( j = 0; j < Clength[ i ]; j++ )
-	  	    printf("%i [%i] ", Cv[i][j], IS_FIXED(Cv[i][j]) );
-		printf("not satisfied yet\n");
+		if( quiet_mode != LIBRARY_MODE )
+		{
+		    printf("\nc clause %i: ", i);
+		    for( j = 0; j < Clength[ i ]; j++ )
+			printf("%i [%i] ", Cv[i][j], IS_FIXED(Cv[i][j]) );
+		    printf("not satisfied yet\n");
+		}
 		return UNKNOWN;
 	    }
 	}
@@ -1619,7 +1647,8 @@ int verifySolution()
             	value *= EQSGN( Ceq[ i ][ j ] );
             if( value == -1 )
             {
-                printf("c eq-clause %i is not satisfied yet\n", i);
+                if( quiet_mode != LIBRARY_MODE )
+                    printf("c eq-clause %i is not satisfied yet\n", i);
             	return UNKNOWN;
             }
         }
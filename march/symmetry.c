@@ -0,0 +1,117 @@
+/*
+   MARCH Satisfiability Solver
+
+   Symmetry-aware branching, see symmetry.h
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "common.h"
+#include "symmetry.h"
+
+int nrofedgevars;
+int *edge_u, *edge_v;
+int *cell, *cellSize;
+unsigned long long *signature, *sorted;
+
+void init_symmetry () {
+  int u, v, var = 1;
+
+  nrofedgevars = graph_order * (graph_order - 1) / 2;
+  if (nrofedgevars > nrofvars) {
+    if (quiet_mode != LIBRARY_MODE)
+      printf ("c init_symmetry():: order %i needs %i variables, symmetry ignored\n", graph_order, nrofedgevars);
+    nrofedgevars = 0; }
+
+  edge_u    = (int*) malloc (sizeof (int) * (nrofedgevars + 1));
+  edge_v    = (int*) malloc (sizeof (int) * (nrofedgevars + 1));
+  cell      = (int*) malloc (sizeof (int) * graph_order);
+  cellSize  = (int*) malloc (sizeof (int) * graph_order);
+  signature = (unsigned long long*) malloc (sizeof (unsigned long long) * graph_order);
+  sorted    = (unsigned long long*) malloc (sizeof (unsigned long long) * graph_order);
+
+  if (graph_row_wise)
+    for (u = 0; u < graph_order && var <= nrofedgevars; u++)
+      for (v = u + 1; v < graph_order; v++) {
+        edge_u[ var ] = u;
+        edge_v[ var ] = v;
+        var++; }
+  else
+    for (v = 1; v < graph_order && var <= nrofedgevars; v++)
+      for (u = 0; u < v; u++) {
+        edge_u[ var ] = u;
+        edge_v[ var ] = v;
+        var++; } }
+
+void dispose_symmetry () {
+  FREE( edge_u );
+  FREE( edge_v );
+  FREE( cell );
+  FREE( cellSize );
+  FREE( signature );
+  FREE( sorted ); }
+
+int compare_signatures (const void *a, const void *b) {
+  unsigned long long x = *(unsigned long long*) a, y = *(unsigned long long*) b;
+  return (x > y) - (x < y); }
+
+unsigned long long mix (unsigned long long x) {
+  x ^= x >> 33; x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x; }
+
+/* an edge is absent (0), present (1) or still open (2) */
+int edge_state (const int varnr) {
+  if (IS_NOT_FORCED(varnr)) return 2;
+  return FIXED_ON_COMPLEMENT(varnr) ? 0 : 1; }
+
+/* colour refinement on the partial graph: a vertex's new colour is its old
+   colour together with the multiset of (edge state, neighbour colour) over
+   all other vertices, iterated until the number of cells is stable. Hash
+   collisions only make the partition coarser. */
+void compute_vertex_cells () {
+  int i, var, nrofcells = 1;
+
+  for (i = 0; i < graph_order; i++) cell[ i ] = 0;
+  if (nrofedgevars == 0) { cellSize[ 0 ] = graph_order; return; }
+
+  do {
+    for (i = 0; i < graph_order; i++) signature[ i ] = mix (cell[ i ] + 1);
+
+    for (var = 1; var <= nrofedgevars; var++) {
+      unsigned long long state = edge_state (var);
+      int u = edge_u[ var ], v = edge_v[ var ];
+      signature[ u ] += mix ((state << 32) | cell[ v ]);
+      signature[ v ] += mix ((state << 32) | cell[ u ]); }
+
+    for (i = 0; i < graph_order; i++) sorted[ i ] = signature[ i ];
+    qsort (sorted, graph_order, sizeof (unsigned long long), compare_signatures);
+
+    int _nrofcells = 0;
+    for (i = 0; i < graph_order; i++)
+      if (i == 0 || sorted[ i ] != sorted[ i - 1 ])
+        sorted[ _nrofcells++ ] = sorted[ i ];
+
+    for (i = 0; i < graph_order; i++) {
+      int lo = 0, hi = _nrofcells - 1;
+      while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (sorted[ mid ] < signature[ i ]) lo = mid + 1; else hi = mid; }
+      cell[ i ] = lo; }
+
+    if (_nrofcells == nrofcells) break;
+    nrofcells = _nrofcells; }
+  while (nrofcells < graph_order);
+
+  for (i = 0; i < graph_order; i++) cellSize[ i ] = 0;
+  for (i = 0; i < graph_order; i++) cellSize[ cell[ i ] ]++; }
+
+/* scale factor in [1,2] for the diff score of a variable: edges whose end
+   points still lie in large cells break more symmetry */
+double symmetry_weight (const int varnr) {
+  if (varnr > nrofedgevars || graph_order < 2) return 1.0;
+
+  int u = edge_u[ varnr ], v = edge_v[ varnr ];
+  return 1.0 + (cellSize[ cell[ u ] ] + cellSize[ cell[ v ] ] - 2) / (2.0 * (graph_order - 1)); }
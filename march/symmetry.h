@@ -0,0 +1,24 @@
+/*
+   MARCH Satisfiability Solver
+
+   Symmetry-aware branching for graph instances (option -order): the first
+   order*(order-1)/2 variables are the edge variables of a graph on order
+   vertices. The edge between u < v is variable v*(v-1)/2+u+1 (column by
+   column, as in cadical-ks and maplesat-ks), or numbered row by row as in
+   SMS with -row-wise. Before a branching variable is selected, the
+   vertices of the partial graph are partitioned by colour refinement,
+   which over-approximates the orbits of its automorphisms. Edges between
+   vertices in large cells are preferred, since branching on them breaks
+   most of the remaining symmetry.
+*/
+
+#ifndef __SYMMETRY_H__
+#define __SYMMETRY_H__
+
+void init_symmetry ();
+void dispose_symmetry ();
+
+void compute_vertex_cells ();
+double symmetry_weight (const int varnr);
+
+#endif
@@ -0,0 +1,92 @@
+/*
+   MARCH Satisfiability Solver
+
+   Test that the library frees the state of the solver after each call:
+   march_cube and march_cube_deep are called in a loop on a random 3-SAT
+   formula with some longer clauses, also under assumptions that falsify
+   its first clause, and the heap in use (including the
+   memory that malloc maps) must not grow. Run with 'make check', which
+   turns off the thread cache of malloc, since mallinfo counts the chunks
+   in it as in use; or build with -fsanitize=address for a report of the
+   leaks.
+*/
+
+#include <malloc.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "marchlib.h"
+
+#define VARS		60
+#define CLAUSES		240
+#define LONG_CLAUSES	20
+#define CALLS		40
+
+static unsigned int state = 1;
+
+static int next_literal () {
+  state = state * 1103515245 + 12345;
+  int var = 1 + (state >> 8) % VARS;
+  return (state >> 4) & 1 ? var : -var; }
+
+static size_t heap_in_use () {
+  struct mallinfo2 info = mallinfo2 ();
+  return info.uordblks + info.hblkhd; }
+
+static int cube (march_ctx *ctx, int deep, const int *assumptions, int nrofassumptions) {
+  char *buffer = NULL;
+  size_t size = 0;
+  FILE *out = open_memstream (&buffer, &size);
+  int result = deep ? march_cube_deep (ctx, assumptions, nrofassumptions, 4, 0, 0, out)
+                    : march_cube (ctx, assumptions, nrofassumptions, 4, 0, out);
+  fclose (out);
+  free (buffer);
+  return result; }
+
+static int check_under (march_ctx *ctx, int deep, const int *assumptions, int nrofassumptions, const char *what) {
+  int i;
+  cube (ctx, deep, assumptions, nrofassumptions); /* the first call may allocate for good, e.g. in stdio */
+  size_t before = heap_in_use ();
+  for (i = 0; i < CALLS; i++) cube (ctx, deep, assumptions, nrofassumptions);
+  size_t after = heap_in_use ();
+
+  if (after > before + 4096) {
+    printf ("test_leak: %s leaks %zu bytes in %i calls\n", what, after - before, CALLS);
+    return 1; }
+  return 0; }
+
+static int check (march_ctx *ctx, int deep, const char *what) {
+  return check_under (ctx, deep, NULL, 0, what); }
+
+int main () {
+  int i, j, failures = 0, falsified[ 3 ];
+  march_ctx *ctx = march_ctx_new ();
+
+  for (i = 0; i < CLAUSES + LONG_CLAUSES; i++) {
+    int length = i < CLAUSES ? 3 : 5;
+    for (j = 0; j < length; j++) {
+      int lit = next_literal ();
+      if (i == 0) falsified[ j ] = -lit;
+      march_load_clauses (ctx, &lit, 1); }
+    int zero = 0;
+    march_load_clauses (ctx, &zero, 1); }
+
+  /* refuted by the simplification: a complementary pair of units, and the
+     units that falsify the first clause, found by their propagation */
+  const int complementary[] = { 1, -1 };
+  failures += check_under (ctx, 0, complementary, 2, "march_cube on complementary units");
+  failures += check_under (ctx, 0, falsified, 3, "march_cube on a falsified clause");
+
+  failures += check (ctx, 0, "march_cube");
+  failures += check (ctx, 1, "march_cube_deep");
+  ctx->threads = 2;
+  failures += check (ctx, 0, "march_cube with 2 lookahead threads");
+  ctx->threads = 0;
+  ctx->order = 11; /* the first 55 variables as the edges of a graph */
+  failures += check (ctx, 0, "march_cube with -order");
+
+  march_ctx_free (ctx);
+
+  if (failures) return EXIT_FAILURE;
+  printf ("test_leak: ok\n");
+  return EXIT_SUCCESS; }
@@ -0,0 +1,67 @@
+/*
+   MARCH Satisfiability Solver
+
+   Test of the edge numbering of the symmetry-aware branching (see
+   symmetry.h): the star with centre 0 on 5 vertices, given by its edge
+   variables in both layouts, must put the centre in a cell of its own and
+   the four leaves in one cell. Run with 'make check'.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "common.h"
+#include "symmetry.h"
+
+extern int *edge_u, *edge_v, *cell, *cellSize;
+
+static int failures = 0;
+
+static void expect (const int condition, const char *what, const char *layout) {
+  if (condition) return;
+  printf ("test_symmetry: %s (%s)\n", what, layout);
+  failures++; }
+
+/* the star K_{1,4} as units on the edge variables, all other edges absent */
+static void check_star (const int *star, const char *layout) {
+  int i, var;
+
+  graph_order = 5;
+  nrofvars = graph_order * (graph_order - 1) / 2;
+  timeAssignments = (tstamp*) calloc (2 * nrofvars + 1, sizeof (tstamp)) + nrofvars;
+  init_symmetry ();
+
+  for (var = 1; var <= nrofvars; var++) FIX( -var, VARMAX );
+  for (i = 0; i < 4; i++) FIX( star[ i ], VARMAX );
+
+  for (var = 1; var <= nrofvars; var++) {
+    int u = edge_u[ var ], v = edge_v[ var ];
+    expect (u < v, "edge with u >= v", layout);
+    if (graph_row_wise)
+      expect (var == u * (2 * graph_order - u - 1) / 2 + v - u, "edge variable not row by row", layout);
+    else
+      expect (var == v * (v - 1) / 2 + u + 1, "edge variable not column by column", layout); }
+
+  compute_vertex_cells ();
+  expect (cellSize[ cell[ 0 ] ] == 1, "centre of the star not in a cell of its own", layout);
+  for (i = 1; i < graph_order; i++)
+    expect (cell[ i ] == cell[ 1 ] && cellSize[ cell[ i ] ] == 4, "leaves of the star not in one cell", layout);
+
+  dispose_symmetry ();
+  free (timeAssignments - nrofvars);
+  timeAssignments = NULL; }
+
+int main () {
+  const int column_star[] = { 1, 2, 4, 7 }; /* {0,v} is v*(v-1)/2+1 */
+  const int row_star[]    = { 1, 2, 3, 4 }; /* {0,v} is v */
+
+  quiet_mode = LIBRARY_MODE;
+
+  graph_row_wise = 0;
+  check_star (column_star, "column by column");
+  graph_row_wise = 1;
+  check_star (row_star, "row by row");
+
+  if (failures) return EXIT_FAILURE;
+  printf ("test_symmetry: ok\n");
+  return EXIT_SUCCESS; }
@@ -3,37 +3,90 @@ import multiprocessing
 import os
 import queue
 import argparse
+import json
+import signal
 
 remove_file = True
 
+def stats_result(stats_file):
+    # The result in the --stats-json summary of a solver run, or None if
+    # the solver did not write one (e.g. it was killed)
+    try:
+        with open(stats_file, "r") as file:
+            return json.load(file).get("result")
+    except (OSError, ValueError):
+        return None
+
+def predicted_hard(status_file):
+    # Whether the --status snapshot of a cadical-ks run predicts that it
+    # will not finish within the timeout, once it ran for --predict-split
+    # seconds.  Returns the pid of the solver in that case.
+    try:
+        with open(status_file, "r") as file:
+            status = json.load(file)
+    except (OSError, ValueError):
+        return None
+    predicted = status.get("predicted_seconds")
+    if status.get("done") or status["seconds"] < predict_split_g or predicted is None:
+        return None
+    if status["seconds"] + predicted <= timeout_g:
+        return None
+    return status.get("pid")
+
 def run_command(command):
     process_id = os.getpid()
     print(f"Process {process_id}: Executing command: {command}", flush=True)
 
-    file_to_cube = command.split()[-1]
+    # A solve started from a checkpoint ends in '--warm <checkpoint>'
+    args = command.split()
+    if args[-2] == "--warm":
+        args = args[:-2]
+    file_to_cube = args[-1]
 
     try:
+        status_file = f"{file_to_cube}.status"
+        if os.path.exists(status_file):
+            os.remove(status_file)
         process = subprocess.Popen(command, stdout=subprocess.PIPE, stderr=subprocess.PIPE, shell=True)
-        stdout, stderr = process.communicate()
+        while True:
+            try:
+                stdout, stderr = process.communicate(timeout=5 if predict_split_g else None)
+                break
+            except subprocess.TimeoutExpired:
+                pid = predicted_hard(status_file)
+                if pid:
+                    # SIGUSR2 stops cadical-ks as on its timeout, which leaves a
+                    # checkpoint, the --stats-json summary and a final status
+                    print(f"Process {process_id}: {file_to_cube} is predicted to take longer than {timeout_g} seconds, splitting it", flush=True)
+                    os.kill(pid, signal.SIGUSR2)
+                    stdout, stderr = process.communicate()
+                    break
         stdout_str = stdout.decode()
 
         if stderr:
             print(f"Error executing command: {stderr.decode()}", flush=True)
 
+        result = stats_result(f"{file_to_cube}.log.json")
+        if result in ("SATISFIABLE", "UNSATISFIABLE"):
+            print("solved", flush=True)
+            process.terminate()
         # Check for SMS mode completion
-        if (solving_mode_g == "sms" or solving_mode_g == "smsd2") and "Search finished" in stdout_str:
+        elif result is None and (solving_mode_g == "sms" or solving_mode_g == "smsd2") and "Search finished" in stdout_str:
             print("solved", flush=True)
             process.terminate()
         # Check for SAT solver completion
-        elif "UNSATISFIABLE" in stdout_str:
+        elif result is None and "UNSATISFIABLE" in stdout_str:
             print("solved", flush=True)
             process.terminate()
-        elif "SATISFIABLE" in stdout_str:
+        elif result is None and "SATISFIABLE" in stdout_str:
             print("solved", flush=True)
             process.terminate()
         else:
             print("Continue cubing this subproblem...", flush=True)
-            command = f"cube('{file_to_cube}', 'N', 0, {mg}, '{orderg}', {numMCTSg}, queue, '{cutoffg}', {cutoffvg}, {dg}, 'True')"
+            # cadical-ks leaves a checkpoint of what it learned when it times out
+            checkpoint = f"{file_to_cube}.ckpt"
+            warm = checkpoint if os.path.exists(checkpoint) else None
+            command = f"cube('{file_to_cube}', 'N', 0, {mg}, '{orderg}', {numMCTSg}, queue, '{cutoffg}', {cutoffvg}, {dg}, 'True', {warm!r})"
             queue.put(command)
 
     except Exception as e:
@@ -75,49 +128,56 @@ def worker(queue):
             run_cube_command(args)
         queue.task_done()
 
-def cube(original_file, cube, index, m, order, numMCTS, queue, cutoff='d', cutoffv=5, d=0, extension="False"):
-    global solving_mode_g, cubing_mode_g
+def cube(original_file, cube, index, m, order, numMCTS, queue, cutoff='d', cutoffv=5, d=0, extension="False", warm=None):
+    global solving_mode_g, cubing_mode_g, simp_conflicts_g
+
+    # Simplifications and solves below a timed-out cube start from its checkpoint
+    warm_arg = f" --warm {warm}" if warm else ""
     
     if cube != "N":
         if solving_mode_g == "satcas":
-            command = f"./gen_cubes/apply.sh {original_file} {cube} {index} > {cube}{index}.cnf && ./simplification/simplify-by-conflicts.sh {cube}{index}.cnf {order} 10000 -cas"
+            command = f"./gen_cubes/apply.sh {original_file} {cube} {index} > {cube}{index}.cnf && ./simplification/simplify-by-conflicts.sh {cube}{index}.cnf {order} {simp_conflicts_g} -cas"
         elif solving_mode_g == "exhaustive-no-cas":
-            command = f"./gen_cubes/apply.sh {original_file} {cube} {index} > {cube}{index}.cnf && ./simplification/simplify-by-conflicts.sh {cube}{index}.cnf {order} 10000 -exhaustive-no-cas"
+            command = f"./gen_cubes/apply.sh {original_file} {cube} {index} > {cube}{index}.cnf && ./simplification/simplify-by-conflicts.sh {cube}{index}.cnf {order} {simp_conflicts_g} -exhaustive-no-cas"
         elif solving_mode_g == "sms":
-            command = f"./gen_cubes/apply.sh {original_file} {cube} {index} > {cube}{index}.cnf && ./simplification/simplify-by-conflicts.sh {cube}{index}.cnf {order} 10000 -sms"
+            command = f"./gen_cubes/apply.sh {original_file} {cube} {index} > {cube}{index}.cnf && ./simplification/simplify-by-conflicts.sh {cube}{index}.cnf {order} {simp_conflicts_g} -sms"
         elif solving_mode_g == "smsd2":
-            command = f"./gen_cubes/apply.sh {original_file} {cube} {index} > {cube}{index}.cnf && ./simplification/simplify-by-conflicts.sh {cube}{index}.cnf {order} 10000 -smsd2"
+            command = f"./gen_cubes/apply.sh {original_file} {cube} {index} > {cube}{index}.cnf && ./simplification/simplify-by-conflicts.sh {cube}{index}.cnf {order} {simp_conflicts_g} -smsd2"
         else:
-            command = f"./gen_cubes/apply.sh {original_file} {cube} {index} > {cube}{index}.cnf && ./simplification/simplify-by-conflicts.sh {cube}{index}.cnf {order} 10000"
+            command = f"./gen_cubes/apply.sh {original_file} {cube} {index} > {cube}{index}.cnf && ./simplification/simplify-by-conflicts.sh {cube}{index}.cnf {order} {simp_conflicts_g}"
         file_to_cube = f"{cube}{index}.cnf.simp"
         simplog_file = f"{cube}{index}.cnf.simplog"
         file_to_check = f"{cube}{index}.cnf.ext"
     else:
         if solving_mode_g == "satcas":
-            command = f"./simplification/simplify-by-conflicts.sh {original_file} {order} 10000 -cas"
+            command = f"./simplification/simplify-by-conflicts.sh {original_file} {order} {simp_conflicts_g} -cas"
         elif solving_mode_g == "exhaustive-no-cas":
-            command = f"./simplification/simplify-by-conflicts.sh {original_file} {order} 10000 -exhaustive-no-cas"
+            command = f"./simplification/simplify-by-conflicts.sh {original_file} {order} {simp_conflicts_g} -exhaustive-no-cas"
         elif solving_mode_g == "sms":
-            command = f"./simplification/simplify-by-conflicts.sh {original_file} {order} 10000 -sms"
+            command = f"./simplification/simplify-by-conflicts.sh {original_file} {order} {simp_conflicts_g} -sms"
         elif solving_mode_g == "smsd2":
-            command = f"./simplification/simplify-by-conflicts.sh {original_file} {order} 10000 -smsd2"
+            command = f"./simplification/simplify-by-conflicts.sh {original_file} {order} {simp_conflicts_g} -smsd2"
         else:
-            command = f"./simplification/simplify-by-conflicts.sh {original_file} {order} 10000"
+            command = f"./simplification/simplify-by-conflicts.sh {original_file} {order} {simp_conflicts_g}"
         file_to_cube = f"{original_file}.simp"
         simplog_file = f"{original_file}.simplog"
         file_to_check = f"{original_file}.ext"
-    subprocess.run(command, shell=True)
+    subprocess.run(command + warm_arg, shell=True)
     # Remove the cube file after it's been used
     #remove_related_files([cube])
 
-    # Check if the output contains "c exit 20"
-    with open(simplog_file, "r") as file:
-        if "c exit 20" in file.read():
-            print("the cube is UNSAT", flush=True)
-            if cube != "N":
-                files_to_remove = [f'{cube}{index}.cnf', file_to_cube, file_to_check]
-                #remove_related_files(files_to_remove)
-            return
+    # Check if the simplification refuted the cube, in its summary or else
+    # its output ("c exit 20")
+    result = stats_result(f"{simplog_file}.json")
+    if result is None:
+        with open(simplog_file, "r") as file:
+            result = "UNSATISFIABLE" if "c exit 20" in file.read() else None
+    if result == "UNSATISFIABLE":
+        print("the cube is UNSAT", flush=True)
+        if cube != "N":
+            files_to_remove = [f'{cube}{index}.cnf', file_to_cube, file_to_check]
+            #remove_related_files(files_to_remove)
+        return
     
     command = f"sed -E 's/.* 0 [-]*([0-9]*) 0$/\\1/' < {file_to_check} | awk '$0<={m}' | sort | uniq | wc -l"
     result = subprocess.run(command, shell=True, text=True, capture_output=True)
@@ -155,7 +215,7 @@ def cube(original_file, cube, index, m, order, numMCTS, queue, cutoff='d', cutof
                         command = f"./solve.sh {order} -cadical {timeout_g} -smsd2 {original_file}"
                 else:
                     command = f"./solve.sh {order} -cadical {timeout_g} {file_to_cube}"
-                queue.put(command)
+                queue.put(command + warm_arg)
             return
     if cutoff == 'v':
         if var_removed >= cutoffv:
@@ -182,12 +242,21 @@ def cube(original_file, cube, index, m, order, numMCTS, queue, cutoff='d', cutof
                         command = f"./solve.sh {order} -cadical {timeout_g} -smsd2 {original_file}"
                 else:
                     command = f"./solve.sh {order} -cadical {timeout_g} {file_to_cube}"
-                queue.put(command)
+                queue.put(command + warm_arg)
             return
 
+    # With --symmetry-cubing march_cu prefers the edges that break the most
+    # symmetry; the edges of the SMS encodings are numbered row by row, all
+    # others column by column
+    graph = ""
+    if symmetry_cubing_g and order is not None and solving_mode_g != "other":
+        graph = f"-order {order}" + (" -row-wise" if solving_mode_g in ("sms", "smsd2") else "")
+
     # Select cubing method based on cubing_mode
     if cubing_mode_g == "march":
-        subprocess.run(f"./march/march_cu {file_to_cube} -d 1 -m {m} -o {file_to_cube}.temp", shell=True)
+        subprocess.run(f"./march/march_cu {file_to_cube} -d 1 -m {m} -o {file_to_cube}.temp -stats-json {file_to_cube}.march.json {graph}", shell=True)
+    elif cubing_mode_g == "ams-native":
+        subprocess.run(f"./march/march_cu {file_to_cube} -d 1 -m {m} -o {file_to_cube}.temp -stats-json {file_to_cube}.march.json -mcts {numMCTS} {graph}", shell=True)
     else:  # ams mode
         subprocess.run(f"python3 -u alpha-zero-general/main.py {file_to_cube} -d 1 -m {m} -o {file_to_cube}.temp -prod -numMCTSSims {numMCTS}", shell=True)
         #subprocess.run(f"python3 -u alpha-zero-general/main.py {file_to_cube} -d 1 -m {m} -o {file_to_cube}.temp -order {order} -prod -numMCTSSims {numMCTS}", shell=True)
@@ -211,12 +280,12 @@ def cube(original_file, cube, index, m, order, numMCTS, queue, cutoff='d', cutof
     else:
         files_to_remove = [file_to_cube, file_to_check]
         remove_related_files(files_to_remove)
-    command1 = f"cube('{original_file}', '{next_cube}', 1, {m}, '{order}', {numMCTS}, queue, '{cutoff}', {cutoffv}, {d})"
-    command2 = f"cube('{original_file}', '{next_cube}', 2, {m}, '{order}', {numMCTS}, queue, '{cutoff}', {cutoffv}, {d})"
+    command1 = f"cube('{original_file}', '{next_cube}', 1, {m}, '{order}', {numMCTS}, queue, '{cutoff}', {cutoffv}, {d}, 'False', {warm!r})"
+    command2 = f"cube('{original_file}', '{next_cube}', 2, {m}, '{order}', {numMCTS}, queue, '{cutoff}', {cutoffv}, {d}, 'False', {warm!r})"
     queue.put(command1)
     queue.put(command2)
 
-def main(order, file_name_solve, m, solving_mode="other", cubing_mode="march", numMCTS=2, cutoff='d', cutoffv=5, solveaftercube='True', timeout=2147483647):
+def main(order, file_name_solve, m, solving_mode="other", cubing_mode="march", numMCTS=2, cutoff='d', cutoffv=5, solveaftercube='True', timeout=2147483647, workers=None, simp_conflicts=10000, predict_split=0, symmetry_cubing=False):
     """
     Parameters:
     - order: the order of the graph (required for satcas and exhaustive-no-cas modes)
@@ -226,36 +295,49 @@ def main(order, file_name_solve, m, solving_mode="other", cubing_mode="march", n
                    or 'exhaustive-no-cas' (cadical with exhaustive search)
                    or 'sms' (placeholder for SMS mode)
                    or 'other' (cadical simplification no cas, maplesat solving no cas)
-    - cubing_mode: 'march' (use march_cu) or 'ams' (use alpha-zero-general)
-    - numMCTS: number of MCTS simulations (only used with ams mode)
+    - cubing_mode: 'march' (use march_cu), 'ams' (use alpha-zero-general)
+                   or 'ams-native' (the same MCTS cubing in march_cu -mcts)
+    - numMCTS: number of MCTS simulations (only used with ams modes)
     - cutoff: 'd' for depth-based or 'v' for variable-based
     - cutoffv: cutoff value
     - solveaftercube: whether to solve after cubing
     - timeout: timeout in seconds (default: 1 hour)
+    - workers: number of worker processes (default: number of CPUs)
+    - simp_conflicts: conflicts of each simplification (default: 10000)
+    - predict_split: seconds after which a satcas cube predicted to take
+                     longer than the timeout is split (default: 0, never)
+    - symmetry_cubing: march_cu prefers the edge variables which break the
+                       most symmetry (-order, needs the order and a mode
+                       other than 'other'; default: False)
     """
     # Validate input parameters
     if solving_mode not in ["satcas", "exhaustive-no-cas", "sms", "smsd2", "other"]:
         raise ValueError("solving_mode must be one of 'satcas', 'exhaustive-no-cas', 'sms', 'smsd2', or 'other'")
-    if cubing_mode not in ["march", "ams"]:
-        raise ValueError("cubing_mode must be either 'march' or 'ams'")
+    if cubing_mode not in ["march", "ams", "ams-native"]:
+        raise ValueError("cubing_mode must be one of 'march', 'ams', or 'ams-native'")
     if m is None:
         raise ValueError("m parameter must be specified")
     if (solving_mode == "satcas" or solving_mode == "exhaustive-no-cas" or solving_mode == "sms") and order is None:
         raise ValueError("order parameter must be specified when using satcas, exhaustive-no-cas, or sms mode")
+    if symmetry_cubing and (order is None or solving_mode == "other"):
+        raise ValueError("symmetry_cubing needs the order and a solving mode other than 'other'")
 
     d = 0
     cutoffv = int(cutoffv)
     m = int(m)
 
     # Update global variables
-    global queue, orderg, numMCTSg, cutoffg, cutoffvg, dg, mg, solveaftercubeg, file_name_solveg, solving_mode_g, cubing_mode_g, timeout_g
+    global queue, orderg, numMCTSg, cutoffg, cutoffvg, dg, mg, solveaftercubeg, file_name_solveg, solving_mode_g, cubing_mode_g, timeout_g, simp_conflicts_g, predict_split_g, symmetry_cubing_g
     orderg, numMCTSg, cutoffg, cutoffvg, dg, mg, solveaftercubeg, file_name_solveg = order, numMCTS, cutoff, cutoffv, d, m, solveaftercube, file_name_solve
     solving_mode_g = solving_mode
     cubing_mode_g = cubing_mode
     timeout_g = timeout
+    simp_conflicts_g = simp_conflicts
+    predict_split_g = predict_split
+    symmetry_cubing_g = symmetry_cubing
 
     queue = multiprocessing.JoinableQueue()
-    num_worker_processes = multiprocessing.cpu_count()
+    num_worker_processes = workers if workers else multiprocessing.cpu_count()
 
     # Start worker processes
     processes = [multiprocessing.Process(target=worker, args=(queue,)) for _ in range(num_worker_processes)]
@@ -307,10 +389,10 @@ if __name__ == "__main__":
                         help='Number of variables to consider for cubing')
     parser.add_argument('--solving-mode', choices=['satcas', 'exhaustive-no-cas', 'sms', 'smsd2', 'other'], default='other',
                         help='Solving mode: satcas (cadical+cas), exhaustive-no-cas (cadical+exhaustive), sms, smsd2, or other (default)')
-    parser.add_argument('--cubing-mode', choices=['march', 'ams'], default='march',
-                        help='Cubing mode: march (default) or ams (alpha-zero-general)')
+    parser.add_argument('--cubing-mode', choices=['march', 'ams', 'ams-native'], default='march',
+                        help='Cubing mode: march (default), ams (alpha-zero-general), or ams-native (its MCTS in march_cu)')
     parser.add_argument('--numMCTS', type=int, default=2,
-                        help='Number of MCTS simulations (only for ams mode)')
+                        help='Number of MCTS simulations (only for ams modes)')
     parser.add_argument('--cutoff', choices=['d', 'v'], default='d',
                         help='Cutoff type: d (depth-based) or v (variable-based)')
     parser.add_argument('--cutoffv', type=int, default=5,
@@ -319,6 +401,14 @@ if __name__ == "__main__":
                         help='Whether to solve after cubing')
     parser.add_argument('--timeout', type=int, default=3600,
                         help='Timeout in seconds (default: 3600)')
+    parser.add_argument('--workers', type=int, default=None,
+                        help='Number of worker processes (default: number of CPUs)')
+    parser.add_argument('--simp-conflicts', type=int, default=10000,
+                        help='Conflicts of each simplification (default: 10000)')
+    parser.add_argument('--predict-split', type=int, default=0,
+                        help='Split a satcas cube early if, after this many seconds, its progress predicts that it will not finish within the timeout (default: 0, never)')
+    parser.add_argument('--symmetry-cubing', action='store_true',
+                        help='Let march_cu prefer the edge variables which break the most symmetry (march_cu -order; needs the order and a solving mode other than other)')
 
     args = parser.parse_args()
     
@@ -326,5 +416,9 @@ if __name__ == "__main__":
     if (args.solving_mode == "satcas" or args.solving_mode == "exhaustive-no-cas" or args.solving_mode == "sms" or args.solving_mode == "smsd2") and args.order is None:
         parser.error("order parameter is required when using satcas, exhaustive-no-cas, sms, or smsd2 mode")
 
+    if args.symmetry_cubing and (args.order is None or args.solving_mode == "other"):
+        parser.error("--symmetry-cubing needs the order and a solving mode other than other")
+
     main(args.order, args.file_name_solve, args.m, args.solving_mode, args.cubing_mode,
-         args.numMCTS, args.cutoff, args.cutoffv, args.solveaftercube, args.timeout)
+         args.numMCTS, args.cutoff, args.cutoffv, args.solveaftercube, args.timeout, args.workers, args.simp_conflicts, args.predict_split,
+         args.symmetry_cubing)
@@ -1,8 +1,16 @@
 #!/bin/bash
 
+# Optional trailing '--warm <checkpoint>': start cadical-ks from the
+# checkpoint of a timed-out parent cube
+warm=""
+if [ $# -ge 2 ] && [ "${@: -2:1}" = "--warm" ]; then
+    warm="--warm ${@: -1}"
+    set -- "${@:1:$(($#-2))}"
+fi
+
 # Check if the correct number of arguments is provided
 if [ "$#" -lt 3 ]; then
-    echo "Usage: $0 <input_file> <order> <num_conflicts> [-cas|-exhaustive-no-cas|-sms]"
+    echo "Usage: $0 <input_file> <order> <num_conflicts> [-cas|-exhaustive-no-cas|-sms] [--warm <checkpoint>]"
     exit 1
 fi
 
@@ -24,12 +32,12 @@ output_ext="${input_file}.ext"
 # Run the appropriate solver based on the mode
 if [ "$mode" = "-cas" ]; then
     echo "Running simplification with CAS mode"
-    ./cadical-ks/build/cadical-ks "$input_file" --order "$order" -c "$num_conflicts" -o "$output_file" -e "$output_ext" | tee "$output_log"
+    ./cadical-ks/build/cadical-ks "$input_file" --order "$order" -c "$num_conflicts" -o "$output_file" -e "$output_ext" --stats-json "${output_log}.json" $warm | tee "$output_log"
     # Output final simplified instance
     ./gen_cubes/concat-edge.sh $order "$output_file" "$output_ext" > "${output_file}.tmp" && mv "${output_file}.tmp" "$output_file"
 elif [ "$mode" = "-exhaustive-no-cas" ]; then
     echo "Running simplification with exhaustive search mode (no CAS)"
-    ./cadical-ks/build/cadical-ks "$input_file" --order "$order" --exhaustive -c "$num_conflicts" -o "$output_file" -e "$output_ext" | tee "$output_log"
+    ./cadical-ks/build/cadical-ks "$input_file" --order "$order" --exhaustive -c "$num_conflicts" -o "$output_file" -e "$output_ext" --stats-json "${output_log}.json" $warm | tee "$output_log"
     # Output final simplified instance
     #./gen_cubes/concat.sh "$output_file" "$output_ext" > "${output_file}.tmp" && mv "${output_file}.tmp" "$output_file"
 elif [ "$mode" = "-sms" ]; then
@@ -37,16 +45,16 @@ elif [ "$mode" = "-sms" ]; then
     triangle_vars=$(( ($order * ($order - 1)) / 2 + 1 ))
     sms_cmd="smsg --vertices $order --print-stats True --triangle-vars $triangle_vars --non010 --all-graphs --dimacs \"$input_file\" --assignment-cutoff-prerun-time 30 --learned-clauses \"${input_file}_learned.dimacs\""
     echo "Executing command: $sms_cmd" | tee "$output_log"
-    smsg --vertices $order --print-stats True --triangle-vars $triangle_vars --non010 --all-graphs --dimacs "$input_file" --assignment-cutoff-prerun-time 30 --learned-clauses "${input_file}_learned.dimacs" 2>&1 | tee -a "$output_log"
+    smsg --vertices $order --print-stats True --triangle-vars $triangle_vars --non010 --all-graphs --dimacs "$input_file" --assignment-cutoff-prerun-time 30 --learned-clauses "${input_file}_learned.dimacs" --stats-json "${output_log}.json" 2>&1 | tee -a "$output_log"
     cat "$input_file" "${input_file}_learned.dimacs" > "$output_file"
 elif [ "$mode" = "-smsd2" ]; then
     echo "Running simplification with SMS d2 mode"
     sms_cmd="smsg -v $order --all-graphs --frequency 5 --dimacs \"$input_file\" --cutoff 20000 --assignment-cutoff-prerun-time 30 --learned-clauses \"${input_file}_learned.dimacs\""
     echo "Executing command: $sms_cmd" | tee "$output_log"
-    smsg -v $order --all-graphs --frequency 5 --dimacs "$input_file" --cutoff 20000 --assignment-cutoff-prerun-time 30 --learned-clauses "${input_file}_learned.dimacs" 2>&1 | tee -a "$output_log"
+    smsg -v $order --all-graphs --frequency 5 --dimacs "$input_file" --cutoff 20000 --assignment-cutoff-prerun-time 30 --learned-clauses "${input_file}_learned.dimacs" --stats-json "${output_log}.json" 2>&1 | tee -a "$output_log"
     cat "$input_file" "${input_file}_learned.dimacs" > "$output_file"
 else
     echo "Running standard simplification"
-    ./cadical-ks/build/cadical-ks "$input_file" -c "$num_conflicts" -o "$output_file" -e "$output_ext" | tee "$output_log"
+    ./cadical-ks/build/cadical-ks "$input_file" -c "$num_conflicts" -o "$output_file" -e "$output_ext" --stats-json "${output_log}.json" $warm | tee "$output_log"
     ./gen_cubes/concat.sh "$output_file" "$output_ext" > "${output_file}.tmp" && mv "${output_file}.tmp" "$output_file"
 fi
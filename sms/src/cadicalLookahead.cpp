@@ -47,7 +47,7 @@ int CadicalSolver::lookaheadDecide()
     // fflush(stdout);
     // printf("Lookahead decide\n");
 
-    size_t decisionLvl = current_trail.size() - 1; // the actual current decision level before picking the next branching literal
+    size_t decisionLvl = trail_lim.size() - 1; // the actual current decision level before picking the next branching literal
     // printf("Current decision level: %ld\n", decisionLvl);
 
     bool startNewLookaheadLevel = false;
@@ -76,7 +76,7 @@ int CadicalSolver::lookaheadDecide()
         {
             // update the number of propagated literals
             int absLit = abs(previousLookaheadLiteral);
-            int numPropagated = (int)current_trail.back().size();
+            int numPropagated = (int)(current_trail.size() - trail_lim.back());
             // if (true)
             // {
             //     numPropagated = 0;
@@ -106,7 +106,7 @@ int CadicalSolver::lookaheadDecide()
 
     // !!!! trail must be at correct level here, i.e., backtracked and everything
 
-    decisionLvl = current_trail.size() - 1; // update decision level
+    decisionLvl = trail_lim.size() - 1; // update decision level
     if (allEdgeVariablesAssigned())
     {
         // printf("All edge variables are assigned\n");
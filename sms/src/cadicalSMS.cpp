@@ -6,7 +6,7 @@
 void CadicalSolver::init(SolverConfig config, cnf_t &cnf)
 {
     // The root-level of the trail is always there
-    current_trail.push_back(std::vector<int>());
+    trail_lim.push_back(0);
 
     // only_propagating = false;
     solver = new CaDiCaL::Solver();
@@ -84,6 +84,15 @@ void CadicalSolver::init(SolverConfig config, cnf_t &cnf)
     }
 
     initEdgeMemory();
+
+    // only the search is recorded, the fixed assignments while adding the clauses also happen when replaying
+    if (!config.propRecordFile.empty())
+    {
+        FILE *file = fopen(config.propRecordFile.c_str(), "wb");
+        if (!file)
+            EXIT_UNWANTED_STATE
+        trace = new CaDiCaL::PropagatorTraceWriter(file);
+    }
 }
 
 // add formula and register propagator
@@ -117,6 +126,8 @@ int* CadicalSolver::getNextGraph(vector<int> assumptions)
       }
 
       int res = solver->solve();
+      if (trace)
+          trace->flush(); // the solver is not deleted at the end
       if (res == 20) // no more solutions
           return nullptr;
       if (res != 10) { EXIT_UNWANTED_STATE } // TODO just to be sure for know
@@ -165,6 +176,8 @@ bool CadicalSolver::solve(vector<int> assumptions)
         }
 
         int res = solver->solve();
+        if (trace)
+            trace->flush(); // the solver is not deleted at the end
         if (res == 20) // not
             return false;
         if (res != 10)
@@ -178,6 +191,26 @@ bool CadicalSolver::solve(vector<int> assumptions)
     return true;
 }
 
+// the calls are made directly on the propagator, so the answers can be compared with the recorded ones
+bool CadicalSolver::replayTrace(FILE *file, CaDiCaL::PropagatorReplay &replay)
+{
+    struct Adapter
+    {
+        CadicalSolver *s;
+        void fixed(int lit) { s->notify_fixed_assignment(lit); }
+        void assign(const vector<int> &lits) { s->notify_assignment(lits); }
+        void level() { s->notify_new_decision_level(); }
+        void backtrack(size_t new_level) { s->notify_backtrack(new_level); }
+        bool model(const vector<int> &m) { return s->cb_check_found_model(m); }
+        bool has_clause(bool &is_forgettable) { return s->cb_has_external_clause(is_forgettable); }
+        int clause_lit() { return s->cb_add_external_clause_lit(); }
+        int decide() { return s->cb_decide(); }
+        int propagate() { return s->cb_propagate(); }
+        int reason(int plit) { return s->cb_add_reason_clause_lit(plit); }
+    } adapter = {this};
+    return replay.run(file, adapter);
+}
+
 void CadicalSolver::printFullModel()
 {
     printf("Model: ");
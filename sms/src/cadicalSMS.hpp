@@ -3,6 +3,7 @@
 
 #include "sms.hpp"
 #include "cadical.hpp"
+#include "proptrace.hpp"
 #include <deque>
 
 using std::deque;
@@ -11,17 +12,17 @@ class TimeoutTerminator : public CaDiCaL::Terminator
 {
 private:
     int timeout;
-    clock_t start_time;
+    double start_time; // CPU time of the calling thread, so that solvers running in parallel don't share a budget
 
 public:
     TimeoutTerminator(int timeout) : timeout(timeout)
     {
-        start_time = clock();
+        start_time = threadCPUTime();
     }
 
     bool terminate() override
     {
-        return (clock() - start_time) / CLOCKS_PER_SEC > timeout;
+        return threadCPUTime() - start_time > timeout;
     }
 };
 
@@ -128,13 +129,16 @@ private:
     vector<pair<vector<int>, bool>> clauses; // all clauses which should be added. The second value indicates whether the clause is forgettable or not
     int incrementalMode = false;             // if true solver has finished and clauses are added by the normal "incremental interface", i.e., adding clauses without observed variables is possible
 
-    deque<vector<int>> current_trail; // for each decision lvl store the assigned literals (only positive version)
+    vector<int> current_trail;   // assigned literals of all decision levels (only positive version)
+    vector<size_t> trail_lim;    // trail_lim[l] is the position in current_trail where decision level l starts
     vector<bool> isFixed;             // isFixed[v] is true if the truth value of this variable is fixed
     vector<lit_t> fixedLiterals;
 
     vector<vector<int>> literal2clausePos; // for each edge variable store clause which was used the last time.
     vector<vector<int>> literal2clauseNeg; // for each negation of an edge variable
 
+    CaDiCaL::PropagatorTraceWriter *trace = NULL; // records the calls of the solver to the propagator (see --prop-record)
+
     void init(SolverConfig config, cnf_t &cnf);
 
 public:
@@ -145,11 +149,13 @@ public:
     {
         solver->disconnect_external_propagator();
         delete solver;
+        delete trace;
     }
 
     bool solve(vector<int> assumptions);
     bool solve(vector<int> assumptions, int timeout);
     void printFullModel(void);
+    bool replayTrace(FILE *file, CaDiCaL::PropagatorReplay &replay); // feed a trace recorded with --prop-record to the propagator instead of solving
 
     void setDefaultCubingArguments() {
         // if (!solver->set("probeint", 1))
@@ -200,12 +206,12 @@ public:
         }
 
         vector<lit_t> clause;
-        int level = 0;
-        for (auto lits : current_trail)
+        for (size_t level = 0; level < trail_lim.size(); level++)
         {
-            level++;
-            for (auto lit : lits)
+            size_t end = level + 1 < trail_lim.size() ? trail_lim[level + 1] : current_trail.size();
+            for (size_t i = trail_lim[level]; i < end; i++)
             {
+                int lit = current_trail[i];
                 if (lit > numEdges) // trail only saves the absolute literals
                     continue;
 
@@ -217,15 +223,15 @@ public:
             }
 
             // printf("Size of clause: %ld\n", clause.size());
-            if ((int)clause.size() + (int)fixedEdgeLits.size() >= config.assignmentCutoff) //  && current_trail.size() - level > 20) // avoid trivial cubes
+            if ((int)clause.size() + (int)fixedEdgeLits.size() >= assignmentCutoff()) //  && current_trail.size() - level > 20) // avoid trivial cubes
             {
                 addClause(clause, false);
-                printf("a");
+                vector<lit_t> cube;
                 for (auto lit : clause)
-                    printf(" %d", -lit);
+                    cube.push_back(-lit);
                 for (auto lit : fixedEdgeLits)
-                    printf(" %d", -lit);
-                printf("\n");
+                    cube.push_back(lit);
+                submitCube(cube);
                 return false;
             }
         }
@@ -347,6 +353,8 @@ private: // information stored for lookahead; currently only on edge variables f
 public:
     void notify_fixed_assignment(int lit)
     {
+        if (trace)
+            trace->fixed(lit);
         // printf("Fixed assignment: %d\n", lit);
         if (abs(lit) < isFixed.size())
         {
@@ -357,37 +365,44 @@ public:
 
     void notify_assignment(const std::vector<int> &lits)
     {
+        if (trace)
+            trace->assign(lits.data(), lits.size());
         for (auto lit : lits)
         {
             changeInTrail = true;
             int absLit = abs(lit);
             currentAssignment[absLit] = lit > 0 ? truth_value_true : truth_value_false;
             // this->isFixed[absLit] = is_fixed;
-            current_trail.back().push_back(absLit);
+            current_trail.push_back(absLit);
         }
     }
 
     void notify_new_decision_level()
     {
-        current_trail.push_back(vector<int>());
+        if (trace)
+            trace->level();
+        trail_lim.push_back(current_trail.size());
     }
 
     void notify_backtrack(size_t new_level)
     {
-        while (current_trail.size() > new_level + 1)
+        if (trace)
+            trace->backtrack(new_level);
+        if (trail_lim.size() <= new_level + 1)
+            return;
+        size_t start = trail_lim[new_level + 1];
+        for (size_t i = start; i < current_trail.size(); i++)
         {
-            auto last = current_trail.back();
-            for (int l : last)
-            {
-                if (!isFixed[l])
-                    currentAssignment[l] = truth_value_unknown;
-            }
-            current_trail.pop_back();
+            int l = current_trail[i];
+            if (!isFixed[l])
+                currentAssignment[l] = truth_value_unknown;
         }
+        current_trail.resize(start);
+        trail_lim.resize(new_level + 1);
     }
 
     // currently not checked in propagator but with the normal incremental interface to allow adding other literals or even new once.
-    bool cb_check_found_model(const std::vector<int> &model)
+    bool checkFoundModel(const std::vector<int> &model)
     {
         this->model = &model;
         if (!clauses.empty())
@@ -429,7 +444,7 @@ public:
         return true;
     }
 
-    bool cb_has_external_clause(bool &is_forgettable)
+    bool hasExternalClause(bool &is_forgettable)
     {
         // PRINT_CURRENT_LINE
         // if no clause, then check whether a clause could be added. If already a clause present then just return clause.
@@ -449,7 +464,7 @@ public:
         return false;
     }
 
-    int cb_add_external_clause_lit()
+    int addExternalClauseLit()
     {
         // PRINT_CURRENT_LINE
         // printf("Call: Add external clause\n");
@@ -474,8 +489,7 @@ public:
         }
     }
 
-    // functions need to be defined
-    int cb_decide()
+    int decide()
     {
         if (config.lookahead || config.lookaheadAll)
         {
@@ -485,7 +499,7 @@ public:
         return 0;
     }
 
-    int cb_propagate()
+    int propagateLiteral()
     {
         if (!config.propagateLiteralsCadical)
             return 0;
@@ -499,7 +513,7 @@ public:
         if (clauses.empty())
             return 0;
 
-        auto lastClause = clauses.back().first;
+        vector<int> &lastClause = clauses.back().first;
         assert(!lastClause.empty());
         // find unassigned literal otherwise take last one; first check if clause is unit
         int nUnknown = 0;
@@ -521,18 +535,19 @@ public:
         if (nUnknown == 1)
         {
             // notify_assignment(unassigned, false); // push back the clause to the current trail
-            clauses.pop_back(); // delete last clause
+            // keep the clause as reason without copying it
             if (unassigned > 0)
-                literal2clausePos[abs(unassigned)] = lastClause;
+                literal2clausePos[abs(unassigned)].swap(lastClause);
             else
-                literal2clauseNeg[abs(unassigned)] = lastClause;
+                literal2clauseNeg[abs(unassigned)].swap(lastClause);
+            clauses.pop_back(); // delete last clause
             // PRINT_CURRENT_LINE
             return unassigned;
         }
         return 0;
     }
 
-    int cb_add_reason_clause_lit(int plit)
+    int addReasonClauseLit(int plit)
     {
         // PRINT_CURRENT_LINE
         if (plit > 0)
@@ -564,6 +579,55 @@ public:
             return l;
         }
     };
+
+public: // the callbacks with answers, which are recorded with --prop-record
+    bool cb_check_found_model(const std::vector<int> &model)
+    {
+        bool res = checkFoundModel(model);
+        if (trace)
+            trace->model(model, res);
+        return res;
+    }
+
+    bool cb_has_external_clause(bool &is_forgettable)
+    {
+        bool res = hasExternalClause(is_forgettable);
+        if (trace)
+            trace->has_clause(res, res && is_forgettable);
+        return res;
+    }
+
+    int cb_add_external_clause_lit()
+    {
+        int lit = addExternalClauseLit();
+        if (trace)
+            trace->clause_lit(lit);
+        return lit;
+    }
+
+    int cb_decide()
+    {
+        int lit = decide();
+        if (trace)
+            trace->decide(lit);
+        return lit;
+    }
+
+    int cb_propagate()
+    {
+        int lit = propagateLiteral();
+        if (trace)
+            trace->propagate(lit);
+        return lit;
+    }
+
+    int cb_add_reason_clause_lit(int plit)
+    {
+        int lit = addReasonClauseLit(plit);
+        if (trace)
+            trace->reason(plit, lit);
+        return lit;
+    }
 };
 
 extern "C"
@@ -10,7 +10,7 @@ typedef struct VCPair
 	color c;
 } VCPair;
 
-int num_colorings = 0;
+std::atomic<int> num_colorings(0); // shared by solver threads
 
 // colors the first non-colored vertex with the first available one. Dummy implementation
 int simpleColoringAlg(const adjacency_matrix_t &adjacencyMatrix, int maxColors, int nVertices, coloring_t &coloring, int vertex, int highestUsedColor)
@@ -189,7 +189,7 @@ bool getColoringSAT(const adjacency_matrix_t &adjacencyMatrix, coloring_t &color
 	return res == 10;
 }
 
-int simpleColoring010(const adjacency_matrix_t &adjacencyMatrix, int nVertices, coloring_t &coloring, int vertex, vector<vector<vector<int>>> &triangle_stats, vector<vector<int>> &edge_stats)
+int simpleColoring010(const adjacency_matrix_t &adjacencyMatrix, int nVertices, coloring_t &coloring, int vertex, const vector<vector<vector<int>>> &triangle_stats, const vector<vector<int>> &edge_stats)
 {
 	if (vertex == nVertices)
 	{
@@ -350,13 +350,224 @@ vector<vector<lit_t>> getHyperColoringCircuit(const coloring_t &coloring, int nV
 	return circuit;
 }
 
-int get010Coloring(int nVertices, const adjacency_matrix_t &adjacencyMatrix, coloring_t &coloring, vector<vector<vector<int>>> triangle_stats, vector<vector<int>> edge_stats)
+int get010Coloring(int nVertices, const adjacency_matrix_t &adjacencyMatrix, coloring_t &coloring, const vector<vector<vector<int>>> &triangle_stats, const vector<vector<int>> &edge_stats)
 {
 	int colorable = simpleColoring010(adjacencyMatrix, nVertices, coloring, 0, triangle_stats, edge_stats);
 	num_colorings += colorable;
 	return colorable;
 }
 
+void Coloring010::loadGraph(const adjacency_matrix_t &matrix)
+{
+	if ((int)matrix.size() != nVertices)
+	{
+		nVertices = (int)matrix.size();
+		lastColoring.clear();
+	}
+	previousMatrix = matrix;
+
+	neighbours.assign(nVertices, vertex_set_010_t());
+	for (int u = 0; u < nVertices; u++)
+		for (int v = u + 1; v < nVertices; v++)
+			if (matrix[u][v] == truth_value_true)
+			{
+				neighbours[u].set(v);
+				neighbours[v].set(u);
+			}
+
+	triangles.assign(nVertices, vector<std::pair<int, int>>());
+	for (int u = 0; u < nVertices; u++)
+		for (int v = u + 1; v < nVertices; v++)
+		{
+			if (!neighbours[u][v])
+				continue;
+			vertex_set_010_t common = neighbours[u] & neighbours[v];
+			for (int w = v + 1; w < nVertices; w++)
+				if (common[w])
+				{
+					triangles[u].push_back(std::make_pair(v, w));
+					triangles[v].push_back(std::make_pair(u, w));
+					triangles[w].push_back(std::make_pair(u, v));
+				}
+		}
+}
+
+bool Coloring010::isValid(const coloring_t &coloring) const
+{
+	for (int v = 0; v < nVertices; v++)
+	{
+		if (coloring[v] == 1)
+		{
+			for (int u = 0; u < v; u++)
+				if (neighbours[v][u] && coloring[u] == 1)
+					return false;
+		}
+		else
+		{
+			for (auto t : triangles[v])
+				if (coloring[t.first] == 0 && coloring[t.second] == 0)
+					return false;
+		}
+	}
+	return true;
+}
+
+// check whether v can get color c given the currently colored vertices
+bool Coloring010::canColor(int v, int c) const
+{
+	if (c == 1)
+		return !(neighbours[v] & ones).any();
+
+	for (auto t : triangles[v])
+		if (zeros[t.first] && zeros[t.second])
+			return false;
+	return true;
+}
+
+void Coloring010::assign(int v, int c, coloring_t &coloring)
+{
+	coloring[v] = c;
+	if (c == 1)
+		ones.set(v);
+	else
+		zeros.set(v);
+}
+
+void Coloring010::unassign(int v)
+{
+	ones.reset(v);
+	zeros.reset(v);
+}
+
+// color the vertices order[pos..] extending the current partial coloring.
+// If useStatistics is set, the color order is given by the statistics of previous solutions, otherwise the last coloring is preferred.
+// Returns false if no extension exists or more than limit (if non-zero) partial colorings were explored.
+bool Coloring010::search(const vector<int> &order, size_t pos, coloring_t &coloring, bool useStatistics, long long limit)
+{
+	if (pos == order.size())
+		return true; // all vertices colored
+
+	int vertex = order[pos];
+	int val[2] = {0, 1};
+	int can[2] = {canColor(vertex, 0), canColor(vertex, 1)};
+
+	if (useStatistics)
+	{
+		uint32_t cost[2] = {0, 0};
+		for (int v = 0; v < nVertices; v++)
+		{
+			if (zeros[v])
+			{
+				for (int w = v + 1; w < nVertices; w++)
+					if (zeros[w])
+						cost[0] += triangle_stats[v][w][vertex];
+			}
+			else if (ones[v])
+			{
+				cost[1] += edge_stats[v][vertex];
+			}
+		}
+
+		if (cost[1] < cost[0] || (cost[1] == cost[0] && vertex * 3 <= nVertices))
+		{
+			std::swap(can[0], can[1]);
+			std::swap(val[0], val[1]);
+		}
+	}
+	else if (lastColoring[vertex] == 1)
+	{
+		std::swap(can[0], can[1]);
+		std::swap(val[0], val[1]);
+	}
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (!can[i])
+			continue;
+		if (limit && explored >= limit)
+			return false;
+		explored++;
+		assign(vertex, val[i], coloring);
+		if (search(order, pos + 1, coloring, useStatistics, limit))
+			return true;
+		unassign(vertex);
+	}
+	return false;
+}
+
+// keep the last coloring on all vertices not incident to a changed edge and only recolor the remaining ones
+bool Coloring010::repair(coloring_t &coloring, const vertex_set_010_t &changed)
+{
+	vector<int> order;
+	ones.reset();
+	zeros.reset();
+	coloring = lastColoring;
+	for (int v = 0; v < nVertices; v++)
+	{
+		if (changed[v])
+			order.push_back(v);
+		else if (coloring[v] == 1)
+			ones.set(v);
+		else
+			zeros.set(v);
+	}
+	if (order.empty() || order.size() * 2 > (size_t)nVertices)
+		return false; // nothing to repair or not local anymore
+
+	return search(order, 0, coloring, false, REPAIR_LIMIT_010 * (long long)order.size());
+}
+
+bool Coloring010::getColoring(const adjacency_matrix_t &matrix, coloring_t &coloring)
+{
+	explored = 0;
+	if ((int)matrix.size() > MAX_VERTICES_010)
+		return get010Coloring((int)matrix.size(), matrix, coloring, triangle_stats, edge_stats);
+
+	// endpoints of edges which changed since the last call
+	vertex_set_010_t changed;
+	if (previousMatrix.size() == matrix.size())
+	{
+		for (int u = 0; u < (int)matrix.size(); u++)
+			for (int v = u + 1; v < (int)matrix.size(); v++)
+				if (matrix[u][v] != previousMatrix[u][v])
+				{
+					changed.set(u);
+					changed.set(v);
+				}
+	}
+	loadGraph(matrix);
+
+	bool colorable = false;
+	if (!lastColoring.empty())
+	{
+		if (isValid(lastColoring))
+		{
+			coloring = lastColoring;
+			colorable = true;
+		}
+		else
+		{
+			colorable = repair(coloring, changed);
+		}
+	}
+
+	if (!colorable)
+	{
+		// complete search from scratch in the natural vertex order
+		ones.reset();
+		zeros.reset();
+		vector<int> order(nVertices);
+		for (int v = 0; v < nVertices; v++)
+			order[v] = v;
+		colorable = search(order, 0, coloring, true, 0);
+	}
+
+	if (colorable)
+		lastColoring = coloring;
+	num_colorings += colorable;
+	return colorable;
+}
+
 vector<lit_t> get010ColoringClause(const coloring_t &coloring, int nVertices, const vector<vector<lit_t>> &E, const vector<vector<vector<lit_t>>> &T)
 {
 	vector<lit_t> clause;
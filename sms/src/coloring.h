@@ -2,6 +2,7 @@
 #define COLORING_H
 
 #include "useful.h"
+#include <bitset>
 
 typedef std::vector<int> coloring_t;
 typedef std::vector<vertex_t> vertex_ordering_t;
@@ -22,7 +23,48 @@ public:
     static vertex_ordering_t coloring2vertexOrdering(coloring_t &coloring);
 };
 
-int get010Coloring(int nVertices, const adjacency_matrix_t &adjacencyMatrix, coloring_t &coloring, vector<vector<vector<int>>> triangle_stats, vector<vector<int>> edge_stats);
+#define MAX_VERTICES_010 128
+#define REPAIR_LIMIT_010 64 // partial colorings explored per recolored vertex before falling back to a complete search
+typedef std::bitset<MAX_VERTICES_010> vertex_set_010_t;
+
+/**
+ * @brief Incremental search for 010-colorings (no two adjacent vertices colored 1, no triangle colored 000).
+ *
+ * Keeps the statistics of previous solutions by reference and remembers the last coloring found.
+ * A new graph is first checked against the last coloring, then only the vertices incident to edges
+ * that changed since the previous call are recolored; only if this repair fails a complete search is started.
+ */
+class Coloring010
+{
+private:
+    const vector<vector<vector<int>>> &triangle_stats;
+    const vector<vector<int>> &edge_stats;
+
+    int nVertices = 0;
+    vector<vertex_set_010_t> neighbours;            // bitset neighbourhood of each vertex
+    vector<vector<std::pair<int, int>>> triangles;  // triangles[v] contains the pairs (u, w) forming a triangle with v
+    adjacency_matrix_t previousMatrix;              // graph of the previous call
+    coloring_t lastColoring;                        // last 010-coloring found; empty if none
+
+    vertex_set_010_t ones, zeros; // currently colored vertices
+
+    void loadGraph(const adjacency_matrix_t &matrix);
+    bool isValid(const coloring_t &coloring) const;
+    bool canColor(int v, int c) const;
+    void assign(int v, int c, coloring_t &coloring);
+    void unassign(int v);
+    bool search(const vector<int> &order, size_t pos, coloring_t &coloring, bool useStatistics, long long limit);
+    bool repair(coloring_t &coloring, const vertex_set_010_t &changed);
+
+public:
+    long long explored = 0; // number of (partial) colorings explored during the last call
+
+    Coloring010(const vector<vector<vector<int>>> &triangle_stats, const vector<vector<int>> &edge_stats) : triangle_stats(triangle_stats), edge_stats(edge_stats) {}
+
+    bool getColoring(const adjacency_matrix_t &matrix, coloring_t &coloring); // returns true if a 010-coloring was found
+};
+
+int get010Coloring(int nVertices, const adjacency_matrix_t &adjacencyMatrix, coloring_t &coloring, const vector<vector<vector<int>>> &triangle_stats, const vector<vector<int>> &edge_stats);
 int getHyperColoring(int nVertices[2], const adjacency_matrix_t &matrix, vector<int> &coloring);
 vector<lit_t> get010ColoringClause(const coloring_t &coloring, int nVertices, const vector<vector<lit_t>> &E, const vector<vector<vector<lit_t>>> &T);
 vector<lit_t> getHyperColoringClause(const coloring_t &coloring, int nVertices[2], const adjacency_matrix_t &matrix, const vector<vector<lit_t>> &E);
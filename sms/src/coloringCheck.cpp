@@ -160,8 +160,6 @@ vector<int> HypergraphMinChromaticNumberChecker::getCliqueInIntersectionMatrix(c
     return clique;
 }
 
-#include "cadical.hpp"
-
 void Non010colorableChecker::checkProperty(const adjacency_matrix_t &matrix, const vector<int> &, int &)
 {
     int vertices = (int)matrix.size();
@@ -169,7 +167,10 @@ void Non010colorableChecker::checkProperty(const adjacency_matrix_t &matrix, con
     {
 
         coloring_t coloring(vertices);
-        if (get010Coloring(vertices, matrix, coloring, *triangle_stats, *edge_stats))
+        bool colorable = coloring010.getColoring(matrix, coloring);
+        coloringsExplored += coloring010.explored;
+        maxColoringsExplored = std::max(maxColoringsExplored, coloring010.explored);
+        if (colorable)
         {
             vector<clause_t> clauses;
 
@@ -198,35 +199,42 @@ void Non010colorableChecker::checkProperty(const adjacency_matrix_t &matrix, con
     }
     else // get all valid colorings
     {
-        auto coloringSolver = new CaDiCaL::Solver();
-        vector<int> color(vertices);
-        iota(color.begin(), color.end(), 1);
+        // each call retires its selector by a unit clause, which leaves a fixed variable behind, so the solver is rebuilt
+        // after maxRetiredSelectors calls; the clauses of edges and triangles are added again on demand
+        if (coloringSolver == NULL || coloringSolverVertices != vertices || retiredSelectors > maxRetiredSelectors)
+            initColoringSolver(vertices);
 
+        // only clauses for edges and triangles which were never seen before are added, all others are just activated
+        vector<int> assumptions;
         for (int i = 0; i < vertices; i++)
             for (int j = i + 1; j < vertices; j++)
                 if (matrix[i][j] == truth_value_true)
-                {
-                    coloringSolver->add(color[i]);
-                    coloringSolver->add(color[j]);
-                    coloringSolver->add(0);
-                }
+                    assumptions.push_back(getEdgeActivation(i, j));
 
         for (int i = 0; i < vertices; i++)
             for (int j = i + 1; j < vertices; j++)
+            {
+                if (matrix[i][j] != truth_value_true)
+                    continue;
                 for (int k = j + 1; k < vertices; k++)
-                    if (matrix[i][j] == truth_value_true && matrix[i][k] == truth_value_true && matrix[k][j] == truth_value_true)
-                    {
-                        coloringSolver->add(-color[i]);
-                        coloringSolver->add(-color[j]);
-                        coloringSolver->add(-color[k]);
-                        coloringSolver->add(0);
-                    }
+                    if (matrix[i][k] == truth_value_true && matrix[k][j] == truth_value_true)
+                        assumptions.push_back(getTriangleActivation(i, j, k));
+            }
+
+        // blocking clauses of this call are only active under the selector and retired afterwards
+        int selector = nextColoringVar++;
+        assumptions.push_back(selector);
 
         int numberOfColorings = 0;
         vector<clause_t> clauses;
 
-        while (coloringSolver->solve() == 10)
+        while (true)
         {
+            for (auto lit : assumptions)
+                coloringSolver->assume(lit);
+            if (coloringSolver->solve() != 10)
+                break;
+
             numberOfColorings++;
             vector<int> resultingColoring(vertices, 0);
             for (int i = 0; i < vertices; i++)
@@ -235,19 +243,92 @@ void Non010colorableChecker::checkProperty(const adjacency_matrix_t &matrix, con
 
             clauses.push_back(get010ColoringClause(resultingColoring, vertices, edges, triangleVars));
 
+            coloringSolver->add(-selector);
             for (int i = 0; i < vertices; i++)
                 if (resultingColoring[i] == 1)
                     coloringSolver->add(color[i]);
             coloringSolver->add(0);
         }
+        coloringSolver->add(-selector);
+        coloringSolver->add(0);
+        retiredSelectors++;
+
+        totalColorings += numberOfColorings;
         printf("Number of colorings: %d\n", numberOfColorings);
-        delete coloringSolver;
 
         if (numberOfColorings != 0)
             throw clauses;
     }
 }
 
+Non010colorableChecker::~Non010colorableChecker()
+{
+    delete coloringSolver;
+}
+
+void Non010colorableChecker::initColoringSolver(int vertices)
+{
+    delete coloringSolver;
+    coloringSolver = new CaDiCaL::Solver();
+    coloringSolverVertices = vertices;
+
+    color = vector<int>(vertices);
+    iota(color.begin(), color.end(), 1);
+    nextColoringVar = vertices + 1;
+    retiredSelectors = 0;
+    for (auto c : color)
+        coloringSolver->freeze(c);
+
+    edgeActivation = vector<vector<int>>(vertices, vector<int>(vertices, 0));
+    triangleActivation = vector<vector<vector<int>>>(vertices, vector<vector<int>>(vertices, vector<int>(vertices, 0)));
+}
+
+// no two adjacent vertices with color 1
+int Non010colorableChecker::getEdgeActivation(int i, int j)
+{
+    int &a = edgeActivation[i][j];
+    if (!a)
+    {
+        a = nextColoringVar++;
+        coloringSolver->freeze(a);
+        coloringSolver->add(-a);
+        coloringSolver->add(color[i]);
+        coloringSolver->add(color[j]);
+        coloringSolver->add(0);
+    }
+    return a;
+}
+
+// no triangle with all vertices colored 0
+int Non010colorableChecker::getTriangleActivation(int i, int j, int k)
+{
+    int &a = triangleActivation[i][j][k];
+    if (!a)
+    {
+        a = nextColoringVar++;
+        coloringSolver->freeze(a);
+        coloringSolver->add(-a);
+        coloringSolver->add(-color[i]);
+        coloringSolver->add(-color[j]);
+        coloringSolver->add(-color[k]);
+        coloringSolver->add(0);
+    }
+    return a;
+}
+
+void Non010colorableChecker::printStats()
+{
+    GraphChecker::printStats();
+    if (allColorings)
+    {
+        std::cout << "\tEnumerated colorings: " << totalColorings << std::endl;
+        std::cout << "\tColoring solver variables: " << nextColoringVar - 1 << std::endl;
+        return;
+    }
+    std::cout << "\tExplored colorings: " << coloringsExplored << std::endl;
+    std::cout << "\tExplored colorings per call: " << (calls ? (double)coloringsExplored / calls : 0.0) << " (max " << maxColoringsExplored << ")" << std::endl;
+}
+
 void HyperColoringChecker::checkProperty(const adjacency_matrix_t &matrix, const vector<int> &, int &nextFreeVariable)
 {
     coloring_t coloring(b_vertices[0]);
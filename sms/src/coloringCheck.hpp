@@ -3,6 +3,8 @@
 
 #include "graphChecker.hpp"
 #include "useful.h"
+#include "coloring.h"
+#include "cadical.hpp"
 
 /**
  * @brief Check wether the subgraph given by the first few vertices has at least a certain chromatic number
@@ -98,20 +100,38 @@ class Non010colorableChecker : public ComplexFullyDefinedGraphChecker
     bool allColorings = false;
     bool permuteColorings = false;
 
-    vector<vector<vector<int>>> *triangle_stats;
-    vector<vector<int>> *edge_stats;
+    Coloring010 coloring010; // warm-started coloring engine; uses the statistics of the solver by reference
+    long long coloringsExplored = 0; // total number of partial colorings explored
+    long long maxColoringsExplored = 0; // maximum number of partial colorings explored in a single call
+
+    // persistent solver for enumerating all colorings; edge and triangle clauses are guarded by activation literals
+    CaDiCaL::Solver *coloringSolver = NULL;
+    int coloringSolverVertices = 0;
+    int nextColoringVar = 1;
+    int retiredSelectors = 0;                  // selectors of previous calls, fixed to false
+    static const int maxRetiredSelectors = 10000;
+    vector<int> color;                         // color[v] is true iff v has color 0
+    vector<vector<int>> edgeActivation;        // activation literal of the clause for edge {i,j}; 0 if not created yet
+    vector<vector<vector<int>>> triangleActivation; // activation literal of the clause for triangle {i,j,k} with i < j < k; 0 if not created yet
+    long long totalColorings = 0;
+
+    void initColoringSolver(int vertices);
+    int getEdgeActivation(int i, int j);
+    int getTriangleActivation(int i, int j, int k);
 
 public:
-    Non010colorableChecker(vector<vector<vector<int>>> &triangleVars, vector<vector<int>> &edges, vector<vector<vector<int>>> *triangle_stats, vector<vector<int>> *edge_stats) :
+    Non010colorableChecker(vector<vector<vector<int>>> &triangleVars, vector<vector<int>> &edges, vector<vector<vector<int>>> &triangle_stats, vector<vector<int>> &edge_stats, bool allColorings = false) :
       triangleVars (triangleVars),
-      edges (edges)
+      edges (edges),
+      allColorings (allColorings),
+      coloring010 (triangle_stats, edge_stats)
     {
-        this->triangle_stats = triangle_stats;
-        this->edge_stats = edge_stats;
         this->name = "Non010colorableChecker";
         addsOnlyObservedLiterals = false;
     }
+    ~Non010colorableChecker();
     void checkProperty(const adjacency_matrix_t &matrix, const vector<int> &, int &);
+    void printStats();
 };
 
 // TODO not sure what exactly it does
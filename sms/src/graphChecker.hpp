@@ -20,7 +20,27 @@ protected:
     long long limit_reached = 0;   // count calls which did not provide a conclusive answer
 
 public:
-    void printStats()
+    virtual ~GraphChecker() {}
+
+    // accumulate the statistics of the same checker used by another solver instance
+    void addStats(const GraphChecker &other)
+    {
+        calls += other.calls;
+        time += other.time;
+        numberOfAddedClauses += other.numberOfAddedClauses;
+        limit_reached += other.limit_reached;
+    }
+
+    // the statistics of printStats as a JSON object
+    string statsJson() const
+    {
+        char buffer[256];
+        snprintf(buffer, sizeof buffer, "{\"calls\": %lld, \"time\": %.4f, \"added_clauses\": %ld, \"limit_reached\": %lld}",
+                 calls, ((double)time) / CLOCKS_PER_SEC, numberOfAddedClauses, limit_reached);
+        return "\"" + name + "\": " + buffer;
+    }
+
+    virtual void printStats()
     {
         std::cout << "Statistics for " << name << ":" << std::endl;
         std::cout << std::fixed << std::setprecision(4);
@@ -107,6 +107,7 @@ int main(int argc, char const **argv)
       ("print-full-model", po::bool_switch(&config.printFullModel), "Print the full model, i.e., all variable assignments")
       ("print-intermediate-stats", po::bool_switch(&config.printIntermediateStatistic), "Print intermediate statistics")
       ("print-stats", po::bool_switch(&config.printStats), "Print statistics after solving")
+      ("stats-json", po::value<std::string>(&config.statsJsonFile), "Write a JSON summary of the run (result, times, solutions, cubes, checker statistics) to the given file")
       ("print-added-clauses", po::value<std::string>()->notifier([&](const std::string &value)
                                                                       {
           config.addedClauses = fopen(value.c_str(), "w");
@@ -115,6 +116,8 @@ int main(int argc, char const **argv)
               "Print all custom-learned clauses to this file")
       ("print-partial", po::value<int>(&config.printPartiallyDefined), "The frequency with which to print partially defined graphs (0 means never)")
       ("proof", po::value<std::string>(&config.proofFile), "Output a proof to this file")
+      ("prop-record", po::value<std::string>(&config.propRecordFile), "Record the calls of the SAT solver to the propagator and its answers to this file (binary)")
+      ("prop-replay", po::value<std::string>(&config.propReplayFile), "Instead of solving, replay a recording of --prop-record with the same options to the propagator, time it and check that its answers are the same")
       ("hypergraph", po::bool_switch(&config.hypermode), "Assume the bipartite graph to represent a hypergraph (changes output format of graphs to python list of sets = hyperedges)")
       ("symClauses", po::value<std::string>()->notifier([&config](const std::string &value)
         {
@@ -242,7 +245,7 @@ int main(int argc, char const **argv)
       ("non-hyper-colorable,nh", po::bool_switch(&hypercoloring), "Search for non-2-colorable hypergraphs (must be combined with --bipartite)")
       ("non-hyper-edge-colorable,nhec", po::bool_switch(&config.hyperedgeColoring), "Search for hypergraphs that are not n-edge-colorable, where n is the number of vertices (relates to the EFL conjecture; equivalent to --minChromaticIndexHypergraph = --vertices + 1)")
       ("non-010-colorable,non010", po::bool_switch(&config.non010colorable), "Search for non-010-colorable graphs (relates to Kochen-Specker graphs)")
-      ("non-010-colorable-all,non010-all", po::bool_switch(&non010colorableAll), "Enable non-010 colorable all option")
+      ("non-010-colorable-all,non010-all", po::bool_switch(&non010colorableAll), "Search for non-010-colorable graphs and block all 010-colorings of a candidate at once instead of a single one (implies --non010)")
       ("triangle-version", po::bool_switch(&triangleVersion), "Request the creation of triangle variables")
       ("triangle-vars", po::value<int>(&triangleVars)->implicit_value(0), "For problems which use triangle variables (variable to denote whether a given set of 3 vertices forms a triangle), specify where the triangle variables start")
       ("min-chromatic-number,chi", po::value<int>(&minChromaticNumber)->implicit_value(0), "Search for graphs with chromatic number at least this")
@@ -295,6 +298,8 @@ int main(int argc, char const **argv)
       ("assignment-cutoff-prerun", po::value<int>(&config.assignmentCutoffPrerun), "Postpone cubing until the propagator has been called this many times (see also assignment-cutoff)")
       ("assignment-cutoff-prerun-time", po::value<long>(&config.assignmentCutoffPrerunTime), "Postpone cubing until this much time has elapsed (in seconds; see also assignment-cutoff)")
       ("cubes", po::value<std::string>(&config.cubeFile), "File containing a list of cubes to be solved")
+      ("threads", po::value<int>(&config.threads), "Solve the cubes (see --cubes) with this many solver threads; the output is printed in the order of the cube file. "
+                                                   "With --assignment-cutoff one thread generates cubes and the others solve them while cubing continues")
 
       ("cube2solve", po::value<std::vector<int>>()->multitoken()->composing()->notifier([&rangeCubesTemp](const std::vector<int> &values)
           {
@@ -417,6 +422,36 @@ int main(int argc, char const **argv)
 
     config.rangeCubes = rangeCubesTemp;
 
+    if (config.threads > 1)
+    {
+        if (config.cubeFile.empty() == !config.assignmentCutoff)
+        {
+            printf("Error: --threads requires either --cubes or --assignment-cutoff\n");
+            return EXIT_FAILURE;
+        }
+        // these options either write to a shared file, read checker input from a stream, or are not supported for cubes
+        if (!config.proofFile.empty() || !config.propRecordFile.empty() || !config.propReplayFile.empty() || config.addedClauses || config.symBreakClausesFile || useClingo ||
+            !config.simlifiedCNFFile.empty() || !config.learnedClausesFile.empty() ||
+            config.assignmentCutoffPrerun || config.assignmentCutoffPrerunTime || config.lookahead || config.lookaheadAll ||
+            forAllFile.is_open() || forAllFileQCIR.is_open() || qcirFile.is_open() ||
+            forbiddenSubgraphFile.is_open() || forbiddenInducedSubgraphFile.is_open() || forbiddenSubgraphFileCadical.is_open())
+        {
+            printf("Error: --threads is not supported in combination with the given options\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!config.propRecordFile.empty() && !config.propReplayFile.empty())
+    {
+        printf("Error: --prop-record and --prop-replay can not be combined\n");
+        return EXIT_FAILURE;
+    }
+    if ((!config.propRecordFile.empty() || !config.propReplayFile.empty()) && useClingo)
+    {
+        printf("Error: the propagator can only be recorded and replayed with Cadical\n");
+        return EXIT_FAILURE;
+    }
+
     if (!initialPartitionArguments.empty())
     {
         assert(vertices != 0);
@@ -430,7 +465,9 @@ int main(int argc, char const **argv)
         // Perform additional checks if needed
     }
 
-    if (config.non010colorable || non010colorableAll)
+    if (non010colorableAll)
+        config.non010colorable = true; // enumerating all colorings implies the non-010-colorable checker
+    if (config.non010colorable)
         triangleVersion = true;
 
     // ASSIGN DEFAULTS
@@ -563,162 +600,210 @@ int main(int argc, char const **argv)
 #endif
     }
 
-#ifndef DIRECTED
-    if (planarityFrequency)
+    // add the checkers to a solver; called once per solver thread
+    auto addCheckers = [&](GraphSolver *solver)
     {
-        solver->addPartiallyDefinedGraphChecker(new PlanarityChecker(planarityFrequency));
-    }
+#ifndef DIRECTED
+        if (planarityFrequency)
+        {
+            solver->addPartiallyDefinedGraphChecker(new PlanarityChecker(planarityFrequency));
+        }
 #else
-    if (planarityFrequency)
-    {
-        solver->addPartiallyDefinedGraphChecker(new DirectedPlanarityChecker(planarityFrequency));
-    }
+        if (planarityFrequency)
+        {
+            solver->addPartiallyDefinedGraphChecker(new DirectedPlanarityChecker(planarityFrequency));
+        }
 #endif
-    if (thickness2Frequency)
-    {
-        solver->addPartiallyDefinedGraphChecker(new ThicknessTwoChecker(thickness2Frequency));
-    }
+        if (thickness2Frequency)
+        {
+            solver->addPartiallyDefinedGraphChecker(new ThicknessTwoChecker(thickness2Frequency));
+        }
 
-    if (thickness2FrequencyMultigraph)
-    {
-        solver->addPartiallyDefinedMultiGraphChecker(new ThicknessTwoCheckerMulti(thickness2FrequencyMultigraph));
-    }
+        if (thickness2FrequencyMultigraph)
+        {
+            solver->addPartiallyDefinedMultiGraphChecker(new ThicknessTwoCheckerMulti(thickness2FrequencyMultigraph));
+        }
 
-    if (minChomaticNumberSubgraph.first)
-    {
-        solver->addPartiallyDefinedGraphChecker(new SubgraphChromaticNumberChecker(30, minChomaticNumberSubgraph.second, minChomaticNumberSubgraph.first, coloringAlgo));
-    }
+        if (minChomaticNumberSubgraph.first)
+        {
+            solver->addPartiallyDefinedGraphChecker(new SubgraphChromaticNumberChecker(30, minChomaticNumberSubgraph.second, minChomaticNumberSubgraph.first, coloringAlgo));
+        }
 
-    // checkers related to coloring
-    if (config.non010colorable)
-    {
-        solver->addComplexFullyDefinedGraphChecker(new Non010colorableChecker(config.triangles, config.edges, &solver->triangle_stats, &solver->edge_stats));
-    }
+        // checkers related to coloring
+        if (config.non010colorable)
+        {
+            solver->addComplexFullyDefinedGraphChecker(new Non010colorableChecker(config.triangles, config.edges, solver->triangle_stats, solver->edge_stats, non010colorableAll));
+        }
 
-    if (minChromaticNumber)
-    {
-        solver->addComplexFullyDefinedGraphChecker(new MinChromaticNumberChecker(minChromaticNumber, coloringAlgo, config.edges, addPermutedColorings));
-    }
+        if (minChromaticNumber)
+        {
+            solver->addComplexFullyDefinedGraphChecker(new MinChromaticNumberChecker(minChromaticNumber, coloringAlgo, config.edges, addPermutedColorings));
+        }
 
-    if (minChromaticIndexHypergraph)
-    {
-        solver->addComplexFullyDefinedGraphChecker(new HypergraphMinChromaticNumberChecker(minChromaticIndexHypergraph, coloringAlgo, config.edges_intersection_graph, config.b_vertices));
-    }
+        if (minChromaticIndexHypergraph)
+        {
+            solver->addComplexFullyDefinedGraphChecker(new HypergraphMinChromaticNumberChecker(minChromaticIndexHypergraph, coloringAlgo, config.edges_intersection_graph, config.b_vertices));
+        }
 
-    if (hypercoloring)
-    {
-        solver->addComplexFullyDefinedGraphChecker(new HyperColoringChecker(coloringAlgo, config.b_vertices, config.edges));
-    }
+        if (hypercoloring)
+        {
+            solver->addComplexFullyDefinedGraphChecker(new HyperColoringChecker(coloringAlgo, config.b_vertices, config.edges));
+        }
 
-    if (generate_connected)
-    {
-        solver->addFullyDefinedGraphChecker(new ConnectedChecker());
-    }
+        if (generate_connected)
+        {
+            solver->addFullyDefinedGraphChecker(new ConnectedChecker());
+        }
 
-    if (kConnected)
-    {
-        solver->addFullyDefinedGraphChecker(new KConnectedChecker(kConnected));
-    }
+        if (kConnected)
+        {
+            solver->addFullyDefinedGraphChecker(new KConnectedChecker(kConnected));
+        }
 
 #ifdef GLASGOW
-    if (frequencyForbiddenSubgraphs == 0)
-        frequencyForbiddenSubgraphs = vertices > 2 ? vertices : 3;
-    if (forbiddenSubgraphFile.is_open() || forbiddenInducedSubgraphFile.is_open())
-        solver->addPartiallyDefinedGraphChecker(new ForbiddenSubgraphCheckerGlasgow(frequencyForbiddenSubgraphs, forbiddenSubgraphFile, forbiddenInducedSubgraphFile));
+        if (frequencyForbiddenSubgraphs == 0)
+            frequencyForbiddenSubgraphs = vertices > 2 ? vertices : 3;
+        if (forbiddenSubgraphFile.is_open() || forbiddenInducedSubgraphFile.is_open())
+            solver->addPartiallyDefinedGraphChecker(new ForbiddenSubgraphCheckerGlasgow(frequencyForbiddenSubgraphs, forbiddenSubgraphFile, forbiddenInducedSubgraphFile));
 
-    if (independenceNumberUpperBound)
-        solver->addPartiallyDefinedGraphChecker(new MaxIndependentSetChecker(frequencyForbiddenSubgraphs, independenceNumberUpperBound));
+        if (independenceNumberUpperBound)
+            solver->addPartiallyDefinedGraphChecker(new MaxIndependentSetChecker(frequencyForbiddenSubgraphs, independenceNumberUpperBound));
 
-    if (cliqueNumberUpperBound)
-        solver->addPartiallyDefinedGraphChecker(new MaxCliqueChecker(frequencyForbiddenSubgraphs, cliqueNumberUpperBound));
+        if (cliqueNumberUpperBound)
+            solver->addPartiallyDefinedGraphChecker(new MaxCliqueChecker(frequencyForbiddenSubgraphs, cliqueNumberUpperBound));
 #endif
 
-    if (forbiddenSubgraphFileCadical.is_open())
-        solver->addPartiallyDefinedGraphChecker(new ForbiddenSubgraphChecker(200, forbiddenSubgraphFileCadical, vertices));
+        if (forbiddenSubgraphFileCadical.is_open())
+            solver->addPartiallyDefinedGraphChecker(new ForbiddenSubgraphChecker(200, forbiddenSubgraphFileCadical, vertices));
 
-    if (forAllFile.is_open())
-    {
-        // TODO for now the assumptions are just the undirected edge variables but make it more flexable in the future
-        // !!!!!!!not for digraphs yet
-        for (int i = 0; i < vertices; i++)
-            for (int j = i + 1; j < vertices; j++)
-            {
-                forAllAsumptions.push_back(config.edges[i][j]);
-            }
-        solver->addComplexFullyDefinedGraphChecker(new UniversalChecker(forAllFile, forAllAsumptions));
-    }
+        if (forAllFile.is_open())
+        {
+            // TODO for now the assumptions are just the undirected edge variables but make it more flexable in the future
+            // !!!!!!!not for digraphs yet
+            for (int i = 0; i < vertices; i++)
+                for (int j = i + 1; j < vertices; j++)
+                {
+                    forAllAsumptions.push_back(config.edges[i][j]);
+                }
+            solver->addComplexFullyDefinedGraphChecker(new UniversalChecker(forAllFile, forAllAsumptions));
+        }
 
-    if (forAllFileQCIR.is_open())
-    {
-        // assumptions are either the edge variables or specified in a seperate file
-        if (forAllFileQCIRAssumptions.is_open())
+        if (forAllFileQCIR.is_open())
         {
-            std::string line;
-            if (std::getline(forAllFileQCIRAssumptions, line))
+            // assumptions are either the edge variables or specified in a seperate file
+            if (forAllFileQCIRAssumptions.is_open())
             {
-                std::istringstream iss(line);
-                int num;
-                while (iss >> num)
-                    forAllAsumptions.push_back(num);
-                // Now, the 'integers' vector contains all the integers from the first line
-                // for (int num : forAllAsumptions)
-                //     std::cout << num << " ";
-                // std::cout << std::endl;
+                std::string line;
+                if (std::getline(forAllFileQCIRAssumptions, line))
+                {
+                    std::istringstream iss(line);
+                    int num;
+                    while (iss >> num)
+                        forAllAsumptions.push_back(num);
+                    // Now, the 'integers' vector contains all the integers from the first line
+                    // for (int num : forAllAsumptions)
+                    //     std::cout << num << " ";
+                    // std::cout << std::endl;
+                }
+                else
+                {
+                    std::cerr << "The file is empty." << std::endl;
+                }
+                forAllFileQCIRAssumptions.close();
             }
             else
             {
-                std::cerr << "The file is empty." << std::endl;
+                // !!!!!!!not for digraphs yet
+                for (int i = 0; i < vertices; i++)
+                    for (int j = i + 1; j < vertices; j++)
+                    {
+                        forAllAsumptions.push_back(config.edges[i][j]);
+                    }
             }
-            forAllFileQCIRAssumptions.close();
+            solver->addComplexFullyDefinedGraphChecker(new UniversalCheckerQCIR(forAllFileQCIR, forAllAsumptions));
         }
-        else
+
+        if (qcirFile.is_open())
         {
-            // !!!!!!!not for digraphs yet
-            for (int i = 0; i < vertices; i++)
-                for (int j = i + 1; j < vertices; j++)
-                {
-                    forAllAsumptions.push_back(config.edges[i][j]);
-                }
+            QCIRchecker *checker = new QCIRchecker(qcirFile, polarityHashing);
+            solver->addComplexFullyDefinedGraphChecker(checker);
+            solver->nextFreeVariable = std::max(solver->nextFreeVariable, checker->highestVariableInInstance + 1);
         }
-        solver->addComplexFullyDefinedGraphChecker(new UniversalCheckerQCIR(forAllFileQCIR, forAllAsumptions));
-    }
 
-    if (qcirFile.is_open())
-    {
-        QCIRchecker *checker = new QCIRchecker(qcirFile, polarityHashing);
-        solver->addComplexFullyDefinedGraphChecker(checker);
-        solver->nextFreeVariable = std::max(solver->nextFreeVariable, checker->highestVariableInInstance + 1);
-    }
-
-    if (greedyColoring)
-    {
-        solver->addComplexFullyDefinedGraphChecker(new GreedyColoring(coloringAlgo, config.edges, greedyColoring));
-    }
+        if (greedyColoring)
+        {
+            solver->addComplexFullyDefinedGraphChecker(new GreedyColoring(coloringAlgo, config.edges, greedyColoring));
+        }
 
-    if (efxPartitions)
-    {
-        solver->addPartiallyDefinedGraphChecker(new EFXPropagator(efxFrequency, vertices, efxPartitions));
-    }
+        if (efxPartitions)
+        {
+            solver->addPartiallyDefinedGraphChecker(new EFXPropagator(efxFrequency, vertices, efxPartitions));
+        }
 
-    if (dominationNumInterfaces)
-    {
-        solver->addFullyDefinedGraphChecker(new QuasiKConnectedPropagator(dominationSizeOfInterface, dominationNumInterfaces));
-    }
+        if (dominationNumInterfaces)
+        {
+            solver->addFullyDefinedGraphChecker(new QuasiKConnectedPropagator(dominationSizeOfInterface, dominationNumInterfaces));
+        }
 
-    if (non3Decomposable)
-    {
-        if (non3DecomposableFrequency > 0)
+        if (non3Decomposable)
         {
-            solver->addPartiallyDefinedGraphChecker(new SpanningTreeChecker(vertices, non3DecomposableFrequency));
+            if (non3DecomposableFrequency > 0)
+            {
+                solver->addPartiallyDefinedGraphChecker(new SpanningTreeChecker(vertices, non3DecomposableFrequency));
+            }
+            if (!non3DecFullOff)
+            {
+                solver->addFullyDefinedGraphChecker(new ThreeDecomposabilityChecker(vertices, non3DecFullSearch, non3DecHeuMaxIteration));
+            }
         }
-        if (!non3DecFullOff)
+    };
+
+    if (config.threads > 1 && config.assignmentCutoff)
+    {
+        // one thread generates the cubes, the others solve them
+        SolverConfig workerConfig = config;
+        workerConfig.assignmentCutoff = 0;
+        vector<GraphSolver *> workers;
+        for (int i = 1; i < config.threads; i++)
+            workers.push_back(new CadicalSolver(workerConfig, cnf));
+        addCheckers(solver);
+        for (auto worker : workers)
+            addCheckers(worker);
+        GraphSolver::cubeAndConquer(solver, workers);
+    }
+    else if (config.threads > 1)
+    {
+        vector<GraphSolver *> solvers = {solver};
+        for (int i = 1; i < config.threads; i++)
+            solvers.push_back(new CadicalSolver(config, cnf));
+        for (auto threadSolver : solvers)
+            addCheckers(threadSolver);
+        GraphSolver::solveCubesParallel(solvers);
+    }
+    else if (!config.propReplayFile.empty())
+    {
+        addCheckers(solver);
+        FILE *file = fopen(config.propReplayFile.c_str(), "rb");
+        if (!file)
         {
-            solver->addFullyDefinedGraphChecker(new ThreeDecomposabilityChecker(vertices, non3DecFullSearch, non3DecHeuMaxIteration));
+            printf("Error: can not read %s\n", config.propReplayFile.c_str());
+            return EXIT_FAILURE;
         }
+        CaDiCaL::PropagatorReplay replay;
+        bool ok = ((CadicalSolver *)solver)->replayTrace(file, replay);
+        fclose(file);
+        replay.print(stdout);
+        if (!ok)
+            return EXIT_FAILURE;
+    }
+    else
+    {
+        addCheckers(solver);
+        solver->solve();
     }
-
-    solver->solve();
 
     printf("Total time: %f\n", ((double)clock() - solver->stats.start) / CLOCKS_PER_SEC);
+    if (!config.statsJsonFile.empty())
+        solver->writeStatisticsJson(config.statsJsonFile);
     return 0;
 }
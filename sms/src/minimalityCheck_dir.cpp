@@ -1,7 +1,7 @@
 #include "minimalityCheck.hpp"
 
 
-int reachedCutoff = 0;
+std::atomic<int> reachedCutoff(0); // shared by solver threads
 
 // internal functions
 void isMinimal(vertex_ordering_t vertices, partition_t partition, int row, adjacency_matrix_t &adjacency_matrix, minimalit_check_config_t config, int &count);
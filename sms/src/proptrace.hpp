@@ -0,0 +1,269 @@
+#ifndef _proptrace_hpp_INCLUDED
+#define _proptrace_hpp_INCLUDED
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace CaDiCaL {
+
+// Records the calls of the solver to an external propagator, with the
+// answers of the propagator, as a compact binary trace: one byte per event
+// followed by its literals and numbers as variable length integers.  The
+// trace can be replayed to the same propagator without a solver, which
+// gives the time spent in the propagator on exactly the same sequence of
+// calls, however the propagator is changed, and checks that it still
+// answers the same.  Header only, since SMS records and replays the same
+// format with its own copy of CaDiCaL.  This is a copy of
+// 'cadical-ks/src/proptrace.hpp' (installed with the headers of SMS),
+// keep both the same.
+
+enum PropagatorEvent {
+  TRACE_FIXED,      // root level assignment
+  TRACE_ASSIGN,     // assignments (one or a batch)
+  TRACE_LEVEL,      // new decision level
+  TRACE_BACKTRACK,  // backtrack to level
+  TRACE_MODEL,      // model check and its result
+  TRACE_HAS_CLAUSE, // whether there is a clause (and if forgettable)
+  TRACE_CLAUSE_LIT, // next literal of that clause
+  TRACE_DECIDE,     // external decision
+  TRACE_PROPAGATE,  // external propagation
+  TRACE_REASON,     // literal of a reason clause
+  TRACE_EVENTS
+};
+
+static const char *const propagator_event_names[TRACE_EVENTS] = {
+    "fixed",      "assign",     "level",  "backtrack", "model",
+    "has_clause", "clause_lit", "decide", "propagate", "reason"};
+
+static const char propagator_trace_magic[] = "PTRACE1\n";
+
+class PropagatorTraceWriter {
+  FILE *file;
+  unsigned char buffer[1 << 16];
+  size_t size = 0;
+
+  void put (uint64_t u) {
+    if (size + 10 > sizeof buffer)
+      flush ();
+    while (u > 127) {
+      buffer[size++] = (u & 127) | 128;
+      u >>= 7;
+    }
+    buffer[size++] = u;
+  }
+  void lit (int l) { put (l < 0 ? 2 * (uint64_t) -l - 1 : 2 * (uint64_t) l); }
+  void lits (const int *l, size_t n) {
+    put (n);
+    for (size_t i = 0; i < n; i++)
+      lit (l[i]);
+  }
+
+public:
+  PropagatorTraceWriter (FILE *f) : file (f) {
+    fputs (propagator_trace_magic, file);
+  }
+  ~PropagatorTraceWriter () {
+    flush ();
+    fclose (file);
+  }
+
+  // Writes the buffered events, for solvers which are not deleted at the
+  // end.
+  //
+  void flush () {
+    fwrite (buffer, 1, size, file);
+    fflush (file);
+    size = 0;
+  }
+
+  void fixed (int l) { put (TRACE_FIXED), lit (l); }
+  void assign (const int *l, size_t n) { put (TRACE_ASSIGN), lits (l, n); }
+  void level () { put (TRACE_LEVEL); }
+  void backtrack (size_t new_level) { put (TRACE_BACKTRACK), put (new_level); }
+  void model (const std::vector<int> &m, bool res) {
+    put (TRACE_MODEL), lits (m.data (), m.size ()), put (res);
+  }
+  void has_clause (bool res, bool forgettable = false) {
+    put (TRACE_HAS_CLAUSE), put (res + 2 * forgettable);
+  }
+  void clause_lit (int res) { put (TRACE_CLAUSE_LIT), lit (res); }
+  void decide (int res) { put (TRACE_DECIDE), lit (res); }
+  void propagate (int res) { put (TRACE_PROPAGATE), lit (res); }
+  void reason (int plit, int res) { put (TRACE_REASON), lit (plit), lit (res); }
+};
+
+/*------------------------------------------------------------------------*/
+
+// Replays a trace through an adapter of the propagator with the methods
+//
+//   void fixed (int), assign (const std::vector<int> &), level (),
+//        backtrack (size_t)
+//   bool model (const std::vector<int> &), has_clause (bool &forgettable)
+//   int  clause_lit (), decide (), propagate (), reason (int)
+//
+// The trace is decoded completely before, so that only the propagator is
+// timed.  Stops at the first answer which differs from the recorded one,
+// since the propagator would then be called in states it can not be in.
+
+struct PropagatorReplay {
+  uint64_t count[TRACE_EVENTS] = {};
+  double seconds[TRACE_EVENTS] = {};
+  uint64_t events = 0;
+  long mismatch = -1; // index of the first differing answer
+  int expected = 0, got = 0;
+  const char *error = 0;
+
+  template <class Adapter> bool run (FILE *file, Adapter &adapter);
+  void print (FILE *) const;
+};
+
+template <class Adapter>
+bool PropagatorReplay::run (FILE *file, Adapter &adapter) {
+  char magic[sizeof propagator_trace_magic - 1];
+  if (fread (magic, 1, sizeof magic, file) != sizeof magic ||
+      memcmp (magic, propagator_trace_magic, sizeof magic))
+    return error = "not a propagator trace", false;
+
+  // Decoded trace: event, then its integers, with literal lists prefixed
+  // by their length.
+  //
+  std::vector<int64_t> trace;
+  int c, shift = 0;
+  uint64_t u = 0;
+  while ((c = getc (file)) != EOF) {
+    u |= (uint64_t) (c & 127) << shift;
+    if (c & 128) {
+      if ((shift += 7) > 63)
+        return error = "invalid number in trace", false;
+      continue;
+    }
+    trace.push_back (u);
+    u = 0, shift = 0;
+  }
+  if (shift)
+    return error = "truncated trace", false;
+
+  // Decoding of numbers, literals and lists which checks the bounds.
+  //
+  size_t pos = 0;
+  bool truncated = false;
+  auto number = [&] () -> int64_t {
+    if (pos < trace.size ())
+      return trace[pos++];
+    truncated = true;
+    return 0;
+  };
+  auto literal = [&] () -> int {
+    const int64_t v = number ();
+    return v & 1 ? -(int) ((v + 1) / 2) : (int) (v / 2);
+  };
+  std::vector<int> lits;
+  auto list = [&] () {
+    const int64_t n = number ();
+    lits.clear ();
+    for (int64_t i = 0; i < n && !truncated; i++)
+      lits.push_back (literal ());
+  };
+
+  typedef std::chrono::steady_clock clock;
+  while (pos < trace.size ()) {
+    const int64_t event = number ();
+    if (event >= TRACE_EVENTS)
+      return error = "invalid event in trace", false;
+    int64_t expect = 0, answer = 0;
+    bool check = true;
+    int arg = 0;
+    switch (event) {
+    case TRACE_FIXED:
+    case TRACE_REASON:
+      arg = literal ();
+      break;
+    case TRACE_ASSIGN:
+    case TRACE_MODEL:
+      list ();
+      break;
+    case TRACE_BACKTRACK:
+      arg = number ();
+      break;
+    }
+    if (event == TRACE_MODEL || event == TRACE_HAS_CLAUSE)
+      expect = number ();
+    else if (event >= TRACE_CLAUSE_LIT)
+      expect = literal ();
+    if (truncated)
+      return error = "truncated trace", false;
+
+    const auto start = clock::now ();
+    switch (event) {
+    case TRACE_FIXED:
+      adapter.fixed (arg), check = false;
+      break;
+    case TRACE_ASSIGN:
+      adapter.assign (lits), check = false;
+      break;
+    case TRACE_LEVEL:
+      adapter.level (), check = false;
+      break;
+    case TRACE_BACKTRACK:
+      adapter.backtrack (arg), check = false;
+      break;
+    case TRACE_MODEL:
+      answer = adapter.model (lits);
+      break;
+    case TRACE_HAS_CLAUSE: {
+      bool forgettable = false;
+      answer = adapter.has_clause (forgettable);
+      answer += 2 * (answer && forgettable);
+    } break;
+    case TRACE_CLAUSE_LIT:
+      answer = adapter.clause_lit ();
+      break;
+    case TRACE_DECIDE:
+      answer = adapter.decide ();
+      break;
+    case TRACE_PROPAGATE:
+      answer = adapter.propagate ();
+      break;
+    case TRACE_REASON:
+      answer = adapter.reason (arg);
+      break;
+    }
+    seconds[event] +=
+        std::chrono::duration<double> (clock::now () - start).count ();
+    count[event]++;
+    if (check && answer != expect) {
+      mismatch = events, expected = expect, got = answer;
+      error = propagator_event_names[event];
+      return false;
+    }
+    events++;
+  }
+  return true;
+}
+
+inline void PropagatorReplay::print (FILE *file) const {
+  double total = 0;
+  for (int e = 0; e < TRACE_EVENTS; e++)
+    total += seconds[e];
+  fprintf (file, "c replayed %llu propagator calls in %.3f seconds\n",
+           (unsigned long long) events, total);
+  for (int e = 0; e < TRACE_EVENTS; e++)
+    if (count[e])
+      fprintf (file, "c   %-12s %12llu calls %10.3f s %10.0f ns/call\n",
+               propagator_event_names[e], (unsigned long long) count[e],
+               seconds[e], 1e9 * seconds[e] / count[e]);
+  if (mismatch >= 0)
+    fprintf (file,
+             "c answer to call %ld (%s) differs from the trace: "
+             "%d instead of %d\n",
+             mismatch, error, got, expected);
+  else if (error)
+    fprintf (file, "c replay failed: %s\n", error);
+}
+
+} // namespace CaDiCaL
+
+#endif
@@ -2,6 +2,9 @@
  * Implementation of common parts amongst all solvers
  */
 #include <cmath>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include "sms.hpp"
 
 // change the number of vertices in an existing SolverConfig object this way to update all dependencies
@@ -516,15 +519,15 @@ bool GraphSolver::check()
   stats.callsCheck++;
   if (config.printFullyDefinedGraphs)
   {
-    printf("Check\n");
-    fflush(stdout);
+    fprintf(output, "Check\n");
+    fflush(output);
     if (config.hypermode)
     {
-      printHypergraph(matrix, config.b_vertices);
+      printHypergraph(matrix, config.b_vertices, output);
     }
     else
     {
-      printAdjacencyMatrix(matrix, config.printFullMatrix);
+      printAdjacencyMatrix(matrix, config.printFullMatrix, output);
     }
   }
   recordGraphStats(matrix);
@@ -542,27 +545,28 @@ bool GraphSolver::check()
     return false;
 
   nModels++;
+  cubeModels++;
   if (!config.hideGraphs && !config.quiet)
   {
-
-    printf("Solution %d\n", nModels);
+    // with several threads solutions are numbered per cube to keep the output independent of the scheduling
+    fprintf(output, "Solution %d\n", config.threads > 1 ? cubeModels : nModels);
     if (config.numberOfOverlayingGraphs)
     {
       auto multiGraph = getAdjacencyMatrixMultiple();
       int layer = 0;
       for (auto m : multiGraph)
       {
-        printf("Layer %d:\n", layer++);
-        printAdjacencyMatrix(m, config.printFullMatrix);
+        fprintf(output, "Layer %d:\n", layer++);
+        printAdjacencyMatrix(m, config.printFullMatrix, output);
       }
     }
     else if (config.hypermode)
     {
-      printHypergraph(matrix, config.b_vertices);
+      printHypergraph(matrix, config.b_vertices, output);
     }
     else
     {
-      printAdjacencyMatrix(matrix, config.printFullMatrix);
+      printAdjacencyMatrix(matrix, config.printFullMatrix, output);
     }
 
     if (config.printFullModel)
@@ -657,6 +661,49 @@ void GraphSolver::printStatistics()
     checker->printStats();
 }
 
+void GraphSolver::writeStatisticsJson(const string &path)
+{
+  FILE *file = fopen(path.c_str(), "w");
+  if (!file)
+  {
+    printf("Could not write statistics to %s\n", path.c_str());
+    return;
+  }
+  // without solutions the search is only complete if it was not stopped early, no cube was split off and no solver call timed out
+  const char *result = nModels ? "SATISFIABLE" : stats.incomplete || stats.timeouts || stats.cubes ? "UNKNOWN" : "UNSATISFIABLE";
+  fprintf(file, "{\n  \"solver\": \"smsg\",\n  \"result\": \"%s\",\n", result);
+  fprintf(file, "  \"vertices\": %d,\n", vertices);
+  fprintf(file, "  \"process_time\": %.3f,\n", ((double)clock() - stats.start) / CLOCKS_PER_SEC);
+  fprintf(file, "  \"propagator_time\": %.3f,\n", ((double)stats.timePropagator) / CLOCKS_PER_SEC);
+  fprintf(file, "  \"check_full_graphs_time\": %.3f,\n", ((double)stats.timeCheckFullGraphs) / CLOCKS_PER_SEC);
+  fprintf(file, "  \"calls_propagator\": %lld,\n", stats.callsPropagator);
+  fprintf(file, "  \"calls_check\": %lld,\n", stats.callsCheck);
+  fprintf(file, "  \"hyperclauses\": %lld,\n", stats.hyperclauses);
+  fprintf(file, "  \"solutions\": %d,\n", nModels);
+  fprintf(file, "  \"cubes\": %lld,\n", stats.cubes);
+  fprintf(file, "  \"timeouts\": %lld,\n", stats.timeouts);
+  fprintf(file, "  \"incomplete\": %s,\n", stats.incomplete ? "true" : "false");
+  fprintf(file, "  \"checkers\": {");
+
+  vector<GraphChecker *> allCheckers;
+  allCheckers.insert(allCheckers.end(), partiallyDefinedGraphCheckers.begin(), partiallyDefinedGraphCheckers.end());
+  allCheckers.insert(allCheckers.end(), complexPartiallyDefinedGraphCheckers.begin(), complexPartiallyDefinedGraphCheckers.end());
+  allCheckers.insert(allCheckers.end(), fullyDefinedGraphCheckers.begin(), fullyDefinedGraphCheckers.end());
+  allCheckers.insert(allCheckers.end(), complexFullyDefinedGraphCheckers.begin(), complexFullyDefinedGraphCheckers.end());
+  allCheckers.insert(allCheckers.end(), partiallyDefinedMultiGraphCheckers.begin(), partiallyDefinedMultiGraphCheckers.end());
+  for (size_t i = 0; i < allCheckers.size(); i++)
+    fprintf(file, "%s\n    %s", i ? "," : "", allCheckers[i]->statsJson().c_str());
+  fprintf(file, "\n  }\n}\n");
+  fclose(file);
+}
+
+void GraphSolver::prepareSolving()
+{
+  initEdgeMemory();
+  if (config.non010colorable)
+    initTriangleMemory();
+}
+
 bool GraphSolver::solve()
 {
   bool rv = false;
@@ -667,9 +714,7 @@ bool GraphSolver::solve()
     fflush(stdout);
   }
 
-  initEdgeMemory();
-  if (config.non010colorable)
-    initTriangleMemory();
+  prepareSolving();
 
   if (config.assignmentCutoffPrerunTime)
   {
@@ -695,6 +740,7 @@ bool GraphSolver::solve()
 
   if (!config.simlifiedCNFFile.empty())
   {
+    stats.incomplete = true;
     simplify();
     printf("Simplified CNF file was written to file\n");
     return true;
@@ -702,6 +748,7 @@ bool GraphSolver::solve()
 
   if (!config.learnedClausesFile.empty())
   {
+    stats.incomplete = true;
     printLearnedClauses();
     printf("Learned clauses were written to file\n");
     return true;
@@ -712,51 +759,11 @@ bool GraphSolver::solve()
   if (config.lookahead || config.lookaheadAll)
     setDefaultLookaheadArguments();
 
-  int cubeCounter = 0;
   if (!config.cubeFile.empty())
   {
-    std::ifstream is(config.cubeFile);
-    string line;
-    while (getline(is, line))
+    for (auto &cube : readCubes(config))
     {
-      cubeCounter++;
-      if (config.rangeCubes.first != 0)
-      {
-        if (cubeCounter < config.rangeCubes.first)
-          continue;
-        if ((cubeCounter > config.rangeCubes.second))
-          break;
-      }
-
-      printf("Solve cube %d\n", cubeCounter);
-      vector<lit_t> assumptions; // variable names from the initial encoding
-
-      printf("%s\n", line.c_str());
-
-      std::istringstream iss(line);
-
-      string lit;
-      while (std::getline(iss, lit, ' '))
-      {
-        if (lit.empty() || lit == "a" || lit == "0")
-          continue;
-        assumptions.push_back(stoi(lit));
-      }
-
-      clock_t start = clock();
-
-      bool solvedSuccessfully = true;
-      if (config.timeout)
-      {
-        if (!solve(assumptions, config.timeout))
-          printf("Timeout reached\n");
-      }
-      else
-      {
-        rv = solve(assumptions);
-      }
-      if (solvedSuccessfully)
-        printf("Time for cube %f\n", ((double)clock() - start) / CLOCKS_PER_SEC);
+      rv = solveCube(cube.first, cube.second);
       printStatistics();
     }
     printf("All cubes solved\n");
@@ -766,7 +773,10 @@ bool GraphSolver::solve()
     if (config.timeout)
     {
       if (!solve(config.assumptions, config.timeout))
+      {
         printf("Timeout reached\n");
+        stats.timeouts++;
+      }
     }
     else
     {
@@ -784,6 +794,263 @@ bool GraphSolver::solve()
   return rv;
 }
 
+vector<pair<int, string>> readCubes(const SolverConfig &config)
+{
+  vector<pair<int, string>> cubes;
+  std::ifstream is(config.cubeFile);
+  string line;
+  int cubeCounter = 0;
+  while (getline(is, line))
+  {
+    cubeCounter++;
+    if (config.rangeCubes.first != 0)
+    {
+      if (cubeCounter < config.rangeCubes.first)
+        continue;
+      if ((cubeCounter > config.rangeCubes.second))
+        break;
+    }
+    cubes.push_back(make_pair(cubeCounter, line));
+  }
+  return cubes;
+}
+
+bool GraphSolver::solveCube(int cubeIndex, const string &cube)
+{
+  bool rv = false;
+  cubeModels = 0;
+  fprintf(output, "Solve cube %d\n", cubeIndex);
+  vector<lit_t> assumptions; // variable names from the initial encoding
+
+  fprintf(output, "%s\n", cube.c_str());
+
+  std::istringstream iss(cube);
+
+  string lit;
+  while (std::getline(iss, lit, ' '))
+  {
+    if (lit.empty() || lit == "a" || lit == "0")
+      continue;
+    assumptions.push_back(stoi(lit));
+  }
+
+  double start = threadCPUTime();
+
+  if (config.timeout)
+  {
+    if (!solve(assumptions, config.timeout))
+    {
+      fprintf(output, "Timeout reached\n");
+      stats.timeouts++;
+    }
+  }
+  else
+  {
+    rv = solve(assumptions);
+  }
+  fprintf(output, "Time for cube %f\n", threadCPUTime() - start);
+  return rv;
+}
+
+void GraphSolver::addStatistics(const GraphSolver &other)
+{
+  stats.timePropagator += other.stats.timePropagator;
+  stats.timeCheckFullGraphs += other.stats.timeCheckFullGraphs;
+  stats.callsPropagator += other.stats.callsPropagator;
+  stats.callsCheck += other.stats.callsCheck;
+  stats.hyperclauses += other.stats.hyperclauses;
+  stats.cubes += other.stats.cubes;
+  stats.timeouts += other.stats.timeouts;
+  stats.incomplete = stats.incomplete || other.stats.incomplete;
+  nModels += other.nModels;
+
+  // checkers are created in the same order for all solvers
+  for (size_t i = 0; i < partiallyDefinedGraphCheckers.size(); i++)
+    partiallyDefinedGraphCheckers[i]->addStats(*other.partiallyDefinedGraphCheckers[i]);
+  for (size_t i = 0; i < complexPartiallyDefinedGraphCheckers.size(); i++)
+    complexPartiallyDefinedGraphCheckers[i]->addStats(*other.complexPartiallyDefinedGraphCheckers[i]);
+  for (size_t i = 0; i < fullyDefinedGraphCheckers.size(); i++)
+    fullyDefinedGraphCheckers[i]->addStats(*other.fullyDefinedGraphCheckers[i]);
+  for (size_t i = 0; i < complexFullyDefinedGraphCheckers.size(); i++)
+    complexFullyDefinedGraphCheckers[i]->addStats(*other.complexFullyDefinedGraphCheckers[i]);
+  for (size_t i = 0; i < partiallyDefinedMultiGraphCheckers.size(); i++)
+    partiallyDefinedMultiGraphCheckers[i]->addStats(*other.partiallyDefinedMultiGraphCheckers[i]);
+}
+
+void CubeQueue::push(int index, const string &cube)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  changed.wait(lock, [this]
+               { return capacity == 0 || (int)waiting.size() < capacity; });
+  waiting.push_back(make_pair(index, cube));
+  added++;
+  changed.notify_all();
+}
+
+bool CubeQueue::pop(int &position, pair<int, string> &cube)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  changed.wait(lock, [this]
+               { return closed || !waiting.empty(); });
+  if (waiting.empty())
+    return false;
+  position = added - (int)waiting.size();
+  cube = waiting.front();
+  waiting.pop_front();
+  changed.notify_all();
+  return true;
+}
+
+void CubeQueue::close()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  closed = true;
+  changed.notify_all();
+}
+
+int CubeQueue::size()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return waiting.size();
+}
+
+void CubeQueue::finish(int position, const char *text, size_t length)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  finishedOutput[position] = string(text, length);
+  // print all finished cubes in the order in which they were added
+  for (auto it = finishedOutput.begin(); it != finishedOutput.end() && it->first == nextToPrint; it = finishedOutput.erase(it))
+  {
+    fwrite(it->second.data(), 1, it->second.size(), stdout);
+    nextToPrint++;
+  }
+  fflush(stdout);
+}
+
+bool GraphSolver::solveCubes(CubeQueue &queue)
+{
+  bool rv = false;
+  int position;
+  pair<int, string> cube;
+  while (queue.pop(position, cube))
+  {
+    char *buffer = NULL;
+    size_t length = 0;
+    output = open_memstream(&buffer, &length);
+    if (solveCube(cube.first, cube.second))
+      rv = true;
+    fclose(output);
+    output = stdout;
+    queue.finish(position, buffer, length);
+    free(buffer);
+  }
+  return rv;
+}
+
+void GraphSolver::submitCube(const vector<lit_t> &cube)
+{
+  stats.cubes++;
+  string line = "a";
+  for (auto lit : cube)
+  {
+    line += ' ';
+    line += std::to_string(lit);
+  }
+
+  if (!cubeQueue)
+  {
+    fprintf(output, "%s\n", line.c_str());
+    return;
+  }
+
+  cubeQueue->push(cubeQueue->cubes() + 1, line);
+
+  // if cubes pile up, the workers can't keep up, so cube deeper: this produces easier cubes at a slower rate.
+  // if the workers run out of cubes, produce larger cubes faster.
+  int waitingCubes = cubeQueue->size();
+  if (waitingCubes > 2 * cubeQueue->workers && cutoffAdjustment < config.assignmentCutoff)
+    cutoffAdjustment++;
+  else if (waitingCubes < cubeQueue->workers && assignmentCutoff() > config.assignmentCutoff / 2 + 1)
+    cutoffAdjustment--;
+}
+
+bool GraphSolver::solveCubesParallel(vector<GraphSolver *> &solvers)
+{
+  auto cubes = readCubes(solvers[0]->config);
+  printf("Solving %ld cubes with %ld threads\n", cubes.size(), solvers.size());
+  fflush(stdout);
+
+  CubeQueue queue(solvers.size());
+  for (auto &cube : cubes)
+    queue.push(cube.first, cube.second);
+  queue.close();
+
+  std::atomic<bool> anySolved(false);
+  vector<std::thread> threads;
+  for (auto solver : solvers)
+    threads.push_back(std::thread([solver, &queue, &anySolved]
+                                  {
+                                    solver->prepareSolving();
+                                    if (solver->solveCubes(queue))
+                                      anySolved = true; }));
+  for (auto &t : threads)
+    t.join();
+
+  printf("All cubes solved\n");
+  for (size_t i = 1; i < solvers.size(); i++)
+    solvers[0]->addStatistics(*solvers[i]);
+  if (solvers[0]->config.allModels)
+    printf("Number of solutions: %d\n", solvers[0]->nModels);
+  solvers[0]->printStatistics();
+  return anySolved;
+}
+
+bool GraphSolver::cubeAndConquer(GraphSolver *cuber, vector<GraphSolver *> &workers)
+{
+  printf("Solving cubes with %ld threads while cubing\n", workers.size());
+  fflush(stdout);
+
+  // bound the number of waiting cubes; the cuber waits if the workers can't keep up
+  CubeQueue queue(workers.size(), 8 * workers.size());
+  cuber->cubeQueue = &queue;
+
+  std::atomic<bool> anySolved(false);
+  vector<std::thread> threads;
+  for (auto worker : workers)
+    threads.push_back(std::thread([worker, &queue, &anySolved]
+                                  {
+                                    worker->prepareSolving();
+                                    if (worker->solveCubes(queue))
+                                      anySolved = true; }));
+
+  // graphs found by the cuber itself are printed after the cubes to avoid mixing them with the output of the workers
+  char *buffer = NULL;
+  size_t length = 0;
+  cuber->output = open_memstream(&buffer, &length);
+  cuber->prepareSolving();
+  cuber->setDefaultCubingArguments();
+  if (cuber->solve(cuber->config.assumptions))
+    anySolved = true;
+  fclose(cuber->output);
+  cuber->output = stdout;
+  queue.close();
+
+  for (auto &t : threads)
+    t.join();
+  fwrite(buffer, 1, length, stdout);
+  free(buffer);
+
+  printf("Cubes: %d\n", queue.cubes());
+  printf("Final assignment cutoff: %d\n", cuber->assignmentCutoff());
+  printf("All cubes solved\n");
+  for (auto worker : workers)
+    cuber->addStatistics(*worker);
+  if (cuber->config.allModels)
+    printf("Number of solutions: %d\n", cuber->nModels);
+  cuber->printStatistics();
+  return anySolved;
+}
+
 void GraphSolver::initEdgeMemory()
 {
   edge_stats.resize(vertices);
@@ -2,6 +2,10 @@
 #define SOLVE_GENERAL_H
 
 #include <cassert>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <condition_variable>
 
 #include "useful.h"
 #include "graphChecker.hpp"
@@ -21,6 +25,7 @@ class SolverConfig
 public:
   int vertices = 2;
   bool printStats = false;
+  string statsJsonFile; // write a JSON summary of the run to this file
   bool printIntermediateStatistic = false;
   bool hideGraphs = false;
   bool allModels = false;
@@ -60,11 +65,14 @@ public:
   bool non010colorable = false; // TODO get rid of as config parameter
 
   string proofFile;
+  string propRecordFile; // record the calls of the solver to the propagator to this file
+  string propReplayFile; // replay such a recording to the propagator without solving
 
   string cubeFile;           // name of file containing cubes
   pair<int, int> rangeCubes; // solve all cubes between rangeCubes.fist and rangeCubes.second;
 
   int timeout = 0; // timeout in seconds (for each cube)
+  int threads = 1; // number of solver instances solving cubes in parallel
   
   string cadicalConfig = "";
 
@@ -135,12 +143,45 @@ typedef struct
   long long callsPropagator;
   long long callsCheck;
   long long hyperclauses;
+  long long cubes;    // cubes submitted (see assignmentCutoff)
+  long long timeouts; // solve calls which reached config.timeout
+  bool incomplete;    // the search stopped early to write the simplified CNF or the learned clauses
 } statistics;
 
+// read the cubes from config.cubeFile restricted to config.rangeCubes; each cube is given by its (1-based) index in the file and its line
+vector<pair<int, string>> readCubes(const SolverConfig &config);
+
+// cubes waiting for a solver thread; the output of the cubes is printed in the order in which they were added
+class CubeQueue
+{
+public:
+  CubeQueue(int workers, int capacity = 0) : workers(workers), capacity(capacity) {}
+  const int workers; // number of threads taking cubes from the queue
+
+  void push(int index, const string &cube);           // blocks while the queue holds capacity many cubes (0 means unbounded)
+  bool pop(int &position, pair<int, string> &cube);   // blocks until a cube is available; returns false if closed and empty
+  void close();                                       // no further cubes will be added
+  int size();
+  void finish(int position, const char *text, size_t length); // output of the cube at the given position
+  int cubes() { return added; }
+
+private:
+  const int capacity;
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::deque<pair<int, string>> waiting;
+  std::map<int, string> finishedOutput; // output of finished cubes which can't be printed yet
+  int added = 0;
+  int nextToPrint = 0;
+  bool closed = false;
+};
+
 class GraphSolver
 {
 public:
   bool solve(); // TODO suitable return value;
+  static bool solveCubesParallel(vector<GraphSolver *> &solvers); // solve the cubes from the config with one thread per solver; output is written in the order of the cubes
+  static bool cubeAndConquer(GraphSolver *cuber, vector<GraphSolver *> &workers); // cubes generated by the cuber (see assignmentCutoff) are solved by the workers while cubing continues
   GraphSolver(SolverConfig &config)
   {
     stats.start = clock();
@@ -232,6 +273,10 @@ public:
   SolverConfig config;
   vector<truth_value_t> currentAssignment; // currentAssignment[v] gives the truthvalue of variable v (if observed)
 
+  FILE *output = stdout; // graphs and per-cube information are written here
+  CubeQueue *cubeQueue = NULL; // if set, generated cubes are added to this queue instead of being printed
+  int cutoffAdjustment = 0;    // added to config.assignmentCutoff depending on the number of waiting cubes
+
 private:
   vector<PartiallyDefinedGraphChecker *> partiallyDefinedGraphCheckers;
   vector<ComplexPartiallyDefinedGraphChecker *> complexPartiallyDefinedGraphCheckers;
@@ -243,6 +288,7 @@ protected:
   int vertices;
 
   int nModels = 0;
+  int cubeModels = 0;              // number of models found for the current cube
   const vector<int> *model = NULL; // model of the last canidate solution
 
   bool inPrerunState = false; // whether in a prerun state; in this state no cubes are generated
@@ -265,6 +311,8 @@ protected:
   void initEdgeMemory();
   void initTriangleMemory();
   void printEdgeStats();
+  int assignmentCutoff() { return config.assignmentCutoff + cutoffAdjustment; }
+  void submitCube(const vector<lit_t> &cube); // print the cube or add it to the cube queue
 
 protected: // virtual classes from common interface
   adjacency_matrix_t getAdjacencyMatrix();
@@ -277,12 +325,17 @@ private:
   bool cutoffFunction(); // If certain number of edge variables is assigned, a cube will be generated
   bool checkPartiallyDefined(bool isFullyDefined);
   bool checkFullyDefinedGraph(const adjacency_matrix_t &matrix, const vector<int> &model); // check the property of the fully defined graph, given the model
+  void prepareSolving();
+  bool solveCube(int cubeIndex, const string &cube); // solve the cube given as a line of the cube file
+  bool solveCubes(CubeQueue &queue);                 // solve cubes from the queue until it is closed and empty
+  void addStatistics(const GraphSolver &other);      // add statistics of another solver with the same checkers
 
 public:
   bool propagate(); // Check state of partial assignment and add clauses if necessary; returns true if no clause was added otherwise false
   bool check();     // prints and excludes graph from search space; returns true if no clause was added otherwise false
   virtual void addClause(const vector<lit_t> &clause, bool redundant) = 0;
   void printStatistics();
+  void writeStatisticsJson(const string &path); // the statistics above and the result for scripts, instead of scraping the output
 };
 
 #endif
@@ -3,20 +3,29 @@
 #include <string>
 #include <string.h>
 #include <sstream>
+#include <ctime>
 
 using std::string;
 
-void printAdjacencyMatrix(const adjacency_matrix_t &matrix, bool printFullMatrix)
+// CPU time in seconds used by the calling thread (equals the process time in single-threaded runs)
+double threadCPUTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void printAdjacencyMatrix(const adjacency_matrix_t &matrix, bool printFullMatrix, FILE *output)
 {
   if (printFullMatrix)
     for (auto row : matrix)
     {
       for (auto value : row)
-        printf("%d ", value);
-      printf("\n");
+        fprintf(output, "%d ", value);
+      fprintf(output, "\n");
     }
 
-  printf("[");
+  fprintf(output, "[");
   bool first = true;
 
 #ifndef DIRECTED
@@ -25,24 +34,24 @@ void printAdjacencyMatrix(const adjacency_matrix_t &matrix, bool printFullMatrix
       if (matrix[i][j] == truth_value_true)
       {
         if (first)
-          printf("(%d,%d)", i, j);
+          fprintf(output, "(%d,%d)", i, j);
         else
-          printf(",(%d,%d)", i, j);
+          fprintf(output, ",(%d,%d)", i, j);
         first = false;
       }
-  printf("]\n");
+  fprintf(output, "]\n");
 #else
   for (int i = 0; i < (int)matrix.size(); i++)
     for (int j = 0; j < (int)matrix.size(); j++)
       if (matrix[i][j] == truth_value_true)
       {
         if (first)
-          printf("(%d,%d)", i, j);
+          fprintf(output, "(%d,%d)", i, j);
         else
-          printf(",(%d,%d)", i, j);
+          fprintf(output, ",(%d,%d)", i, j);
         first = false;
       }
-  printf("]\n");
+  fprintf(output, "]\n");
 #endif
 }
 
@@ -110,26 +119,26 @@ void printPartiallyDefinedAdjacencyMatrix(const adjacency_matrix_t &matrix)
 #endif
 }
 
-void printHypergraph(const adjacency_matrix_t &matrix, int nVertices[2])
+void printHypergraph(const adjacency_matrix_t &matrix, int nVertices[2], FILE *output)
 {
   char aux[3] = {',', '[', '{'};
   int och = 1;
   for (int e = nVertices[0]; e < nVertices[0] + nVertices[1]; e++)
   {
-    printf("%c", aux[och]);
+    fprintf(output, "%c", aux[och]);
     och = 0;
     int ich = 2;
     for (int v = 0; v < nVertices[0]; v++)
     {
       if (matrix[v][e] == truth_value_true)
       {
-        printf("%c%d", aux[ich], v);
+        fprintf(output, "%c%d", aux[ich], v);
         ich = 0;
       }
     }
-    printf("}");
+    fprintf(output, "}");
   }
-  printf("]\n");
+  fprintf(output, "]\n");
 }
 
 adjacency_matrix_t getIntersectionMatrix(const adjacency_matrix_t &incidence_matrix, int b_vertices[2])
@@ -5,6 +5,8 @@
 #include <fstream>
 #include <algorithm>
 #include <cstdint>
+#include <cstdio>
+#include <atomic>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/config.hpp>
 
@@ -58,12 +60,14 @@ typedef boost::graph_traits<boost_graph>::vertex_iterator VertexIt;
 
 enum{unassigned, edge_color_green, edge_color_red, edge_color_blue};
 
-void printAdjacencyMatrix(const adjacency_matrix_t &matrix, bool printFullMatrix);
+void printAdjacencyMatrix(const adjacency_matrix_t &matrix, bool printFullMatrix, FILE *output = stdout);
 void printPartiallyDefinedAdjacencyMatrix(const adjacency_matrix_t &matrix);
-void printHypergraph(const adjacency_matrix_t &matrix, int nVertices[2]);
+void printHypergraph(const adjacency_matrix_t &matrix, int nVertices[2], FILE *output = stdout);
 
 adjacency_matrix_t getIntersectionMatrix(const adjacency_matrix_t &incidence_matrix, int b_vertices[2]);
 
+double threadCPUTime();
+
 void file2cnf(std::ifstream &file, cnf_t &cnf, int &maxVar);
 
 #endif
@@ -1,5 +1,13 @@
 #!/bin/bash
 
+# Optional trailing '--warm <checkpoint>': start cadical-ks from the
+# checkpoint of a timed-out parent cube
+warm=""
+if [ $# -ge 2 ] && [ "${@: -2:1}" = "--warm" ]; then
+    warm="--warm ${@: -1}"
+    set -- "${@:1:$(($#-2))}"
+fi
+
 # Reorder parameters
 n=$1      #order
 solver=$2  #solver type
@@ -17,7 +25,7 @@ Description:
     Script for solving and generating drat proof for instance
 
 Usage:
-    ./solve.sh n solver t [mode] f
+    ./solve.sh n solver t [mode] f [--warm checkpoint]
 
 Arguments:
     <n>: the order of the instance/number of vertices in the graph
@@ -25,36 +33,41 @@ Arguments:
     <t>: timeout in seconds
     [mode]: -cas or -exhaustive-no-cas or -sms (optional)
     <f>: file name of the CNF instance to be solved
+    [--warm checkpoint]: checkpoint to start cadical-ks from (optional)
+
+    On timeout cadical-ks writes its checkpoint to f.ckpt.  Every solver
+    writes a summary of its run to f.log.json (see summary.py).  With
+    -cas cadical-ks also keeps a snapshot of its progress in f.status.
 " && exit
 
 # Select solver based on arguments
 if [ "$solver" = "-cadical" ]; then
     if [ "$mode" = "-cas" ]; then
-        ./cadical-ks/build/cadical-ks $f --order $n --proofsize 7168 -t $t | tee $f.log
+        ./cadical-ks/build/cadical-ks $f --order $n --proofsize 7168 -t $t --checkpoint $f.ckpt --stats-json $f.log.json --status $f.status $warm | tee $f.log
     elif [ "$mode" = "-exhaustive-no-cas" ]; then
-        ./cadical-ks/build/cadical-ks $f --order $n --exhaustive --proofsize 7168 -t $t | tee $f.log
+        ./cadical-ks/build/cadical-ks $f --order $n --exhaustive --proofsize 7168 -t $t --checkpoint $f.ckpt --stats-json $f.log.json $warm | tee $f.log
     elif [ "$mode" = "-sms" ]; then
         triangle_vars=$(( ($n * ($n - 1)) / 2 + 1 ))
         sms_cmd="timeout 1000000 smsg --vertices $n --print-stats True --triangle-vars $triangle_vars --non010 --all-graphs --dimacs $f"
         echo "Executing command: $sms_cmd" | tee $f.log
-        timeout 1000000 smsg --vertices $n --print-stats True --triangle-vars $triangle_vars --non010 --all-graphs --dimacs $f 2>&1 | tee -a $f.log
+        timeout 1000000 smsg --vertices $n --print-stats True --triangle-vars $triangle_vars --non010 --all-graphs --dimacs $f --stats-json $f.log.json 2>&1 | tee -a $f.log
     elif [ "$mode" = "-smsd2" ]; then
         sms_cmd="timeout 1000000 smsg -v $n --all-graphs --frequency 5 --dimacs $f"
         echo "Executing command: $sms_cmd" | tee $f.log
-        timeout 1000000 smsg -v $n --all-graphs --frequency 5 --dimacs $f 2>&1 | tee -a $f.log
+        timeout 1000000 smsg -v $n --all-graphs --frequency 5 --dimacs $f --stats-json $f.log.json 2>&1 | tee -a $f.log
     else
-        ./cadical-ks/build/cadical-ks $f --proofsize 7168 -t $t | tee $f.log
+        ./cadical-ks/build/cadical-ks $f --proofsize 7168 -t $t --checkpoint $f.ckpt --stats-json $f.log.json $warm | tee $f.log
     fi
 elif [ "$solver" = "-maplesat" ]; then
     if [ "$mode" = "-cas" ]; then
-        ./maplesat-ks/simp/maplesat_static $f -order=$n -no-pre -minclause -exhaustive=$f.exhaust -max-proof-size=7168 -cpu-lim=$t | tee $f.log
+        ./maplesat-ks/simp/maplesat_static $f -order=$n -no-pre -minclause -exhaustive=$f.exhaust -max-proof-size=7168 -cpu-lim=$t -stats-json=$f.log.json | tee $f.log
     elif [ "$mode" = "-sms" ]; then
         triangle_vars=$(( ($n * ($n - 1)) / 2 + 1 ))
         sms_cmd="timeout $t smsg --vertices $n --print-stats True --triangle-vars $triangle_vars --non010 --all-graphs --dimacs $f"
         echo "Executing command: $sms_cmd" | tee $f.log
-        timeout $t smsg --vertices $n --print-stats True --triangle-vars $triangle_vars --non010 --all-graphs --dimacs $f 2>&1 | tee -a $f.log
+        timeout $t smsg --vertices $n --print-stats True --triangle-vars $triangle_vars --non010 --all-graphs --dimacs $f --stats-json $f.log.json 2>&1 | tee -a $f.log
     else
-        ./maplesat-ks/simp/maplesat_static $f -no-pre -max-proof-size=7168 -cpu-lim=$t | tee $f.log
+        ./maplesat-ks/simp/maplesat_static $f -no-pre -max-proof-size=7168 -cpu-lim=$t -stats-json=$f.log.json | tee $f.log
     fi
 else
     echo "Invalid solver option. Use -cadical or -maplesat"
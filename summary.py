@@ -0,0 +1,123 @@
+import argparse
+import json
+import os
+
+# Sums up the --stats-json summaries which the solvers leave next to their
+# logs in a run of parallel-solve.py: '*.log.json' of the cube solves,
+# '*.simplog.json' of the simplifications and '*.march.json' of the cubing
+# steps.  The same figures as summary.sh, without scraping the logs of
+# each solver.
+
+def load(path):
+    try:
+        with open(path, "r") as file:
+            return json.load(file)
+    except (OSError, ValueError):
+        return None
+
+def add_counts(total, counts):
+    for i, count in enumerate(counts):
+        if i < len(total):
+            total[i] += count
+        else:
+            total.append(count)
+
+def summarize(directory):
+    summary = {
+        "nodes": 0,
+        "total_cubes": 0,
+        "leaf_cubes": 0,
+        "timeouted_cubes": 0,
+        "solving_time": 0.0,
+        "sat_time": 0.0,
+        "unsat_time": 0.0,
+        "unknown_time": 0.0,
+        "simp_time": 0.0,
+        "simp_refuted": 0,
+        "cubing_time": 0.0,
+        "cubes_generated": 0,
+        "conflicts": 0,
+        "propagations": 0,
+        "solutions": 0,
+        "canonical": [],
+        "noncanonical": [],
+        "canonicity_time": 0.0,
+        "mus": [],
+        "unreadable": [],
+    }
+    for root, _, files in os.walk(directory):
+        for name in files:
+            path = os.path.join(root, name)
+            if not name.endswith((".log.json", ".simplog.json", ".march.json")):
+                continue
+            stats = load(path)
+            if stats is None:
+                summary["unreadable"].append(path)
+                continue
+            time = stats.get("process_time", 0.0)
+            result = stats.get("result", "UNKNOWN")
+            if name.endswith(".march.json"):
+                summary["cubing_time"] += time
+                summary["cubes_generated"] += stats.get("cubes", 0)
+                continue
+            if name.endswith(".simplog.json"):
+                summary["nodes"] += 1
+                summary["simp_time"] += time
+                summary["simp_refuted"] += result == "UNSATISFIABLE"
+            else:
+                summary["total_cubes"] += 1
+                summary["solving_time"] += time
+                if result == "SATISFIABLE":
+                    summary["leaf_cubes"] += 1
+                    summary["sat_time"] += time
+                elif result == "UNSATISFIABLE":
+                    summary["leaf_cubes"] += 1
+                    summary["unsat_time"] += time
+                else:
+                    summary["timeouted_cubes"] += 1
+                    summary["unknown_time"] += time
+            summary["conflicts"] += stats.get("conflicts", 0)
+            summary["propagations"] += stats.get("propagations", 0)
+            summary["solutions"] += stats.get("solutions", 0)
+            add_counts(summary["canonical"], stats.get("canonical", []))
+            add_counts(summary["noncanonical"], stats.get("noncanonical", []))
+            summary["canonicity_time"] += stats.get("canonicity_time", 0.0)
+            add_counts(summary["mus"], stats.get("mus", []))
+    return summary
+
+def main():
+    parser = argparse.ArgumentParser(description='Sum up the --stats-json summaries of a parallel-solve.py run')
+    parser.add_argument('directory', help='Directory of the run (searched recursively)')
+    parser.add_argument('--json', action='store_true', help='Print the summary as JSON')
+    args = parser.parse_args()
+
+    summary = summarize(args.directory)
+    if args.json:
+        print(json.dumps(summary, indent=2))
+        return
+
+    print(f"Number of nodes in cubing tree: {summary['nodes']}")
+    print(f"Total cubes: {summary['total_cubes']}")
+    print(f"Leaf cubes: {summary['leaf_cubes']}")
+    print(f"Timeouted cubes: {summary['timeouted_cubes']}")
+    print(f"Solving Time: {summary['solving_time']:.2f}")
+    print(f"SAT Time: {summary['sat_time']:.2f}")
+    print(f"UNSAT Time: {summary['unsat_time']:.2f}")
+    print(f"Unknown Time: {summary['unknown_time']:.2f}")
+    print(f"Cubing Time: {summary['cubing_time']:.2f}")
+    print(f"Cubes generated: {summary['cubes_generated']}")
+    print(f"Simp Time: {summary['simp_time']:.2f}")
+    print(f"Cubes refuted by simplification: {summary['simp_refuted']}")
+    print(f"Conflicts: {summary['conflicts']}")
+    print(f"Propagations: {summary['propagations']}")
+    print(f"Solutions: {summary['solutions']}")
+    print(f"Canonicity Time: {summary['canonicity_time']:.2f}")
+    # index i of the per order counts is order i+1
+    for i, (canonical, noncanonical) in enumerate(zip(summary["canonical"], summary["noncanonical"])):
+        if canonical or noncanonical:
+            print(f"  order {i + 1:2d}: {canonical} canonical, {noncanonical} noncanonical")
+    if summary["unreadable"]:
+        print(f"Unreadable summaries (run interrupted?): {len(summary['unreadable'])}")
+
+if __name__ == "__main__":
+    main()
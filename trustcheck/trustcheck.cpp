@@ -0,0 +1,588 @@
+/*------------------------------------------------------------------------*/
+
+// Checks the trusted clauses ('t' lines) of a DRAT proof written by
+// 'cadical-ks --order n ... --perm-out <permutations>'.  Every blocking
+// clause of a noncanonical graph comes with the permutation showing that
+// the graph is not canonical, and every minimal unembeddable subgraph
+// (MUS) clause with the embedding of the MUS, in the same order as the
+// trusted clauses in the proof.  The main thread streams the proof and the
+// permutation file together and hands the pairs in batches to worker
+// threads, which re-derive each clause from its witness.
+//
+// With '--cnf' and '--proof-out' the rest of the proof can then be checked
+// with 'drat-trim': the trusted clauses are appended to the formula and
+// removed from the proof.
+
+/*------------------------------------------------------------------------*/
+
+#include "unembeddable_graphs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cctype>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static void error (const char *fmt, ...) {
+  va_list ap;
+  va_start (ap, fmt);
+  fputs ("trustcheck: error: ", stderr);
+  vfprintf (stderr, fmt, ap);
+  va_end (ap);
+  fputc ('\n', stderr);
+  exit (1);
+}
+
+/*------------------------------------------------------------------------*/
+
+// Buffered input, decompressing '.gz', '.bz2' and '.xz' files through the
+// external tools like 'cadical-ks' does.
+
+class Input {
+  FILE *file;
+  bool piped = false;
+  char buffer[1 << 16];
+  size_t pos = 0, size = 0;
+
+public:
+  const char *path;
+
+  Input (const char *p) : path (p) {
+    const char *tools[][2] = {
+        {".gz", "gzip -c -d"}, {".bz2", "bzip2 -c -d"}, {".xz", "xz -c -d"}};
+    const size_t len = strlen (path);
+    for (auto &tool : tools) {
+      const size_t suffix = strlen (tool[0]);
+      if (len > suffix && !strcmp (path + len - suffix, tool[0])) {
+        const string cmd = string (tool[1]) + " '" + path + "'";
+        file = popen (cmd.c_str (), "r");
+        piped = true;
+        break;
+      }
+    }
+    if (!piped)
+      file = fopen (path, "r");
+    if (!file)
+      error ("can not read '%s'", path);
+  }
+  ~Input () { piped ? pclose (file) : fclose (file); }
+
+  int get () {
+    if (pos == size) {
+      size = fread (buffer, 1, sizeof buffer, file);
+      pos = 0;
+      if (!size)
+        return EOF;
+    }
+    return (unsigned char) buffer[pos++];
+  }
+
+  // The first bytes, without consuming them.
+  //
+  size_t peek (const unsigned char *&bytes) {
+    if (!size)
+      size = fread (buffer, 1, sizeof buffer, file);
+    bytes = (const unsigned char *) buffer;
+    return size;
+  }
+};
+
+// Proof lines, in binary or in text DRAT.
+
+class Proof {
+  Input input;
+  bool binary = false;
+  long lineno = 1;
+
+  int read_int (int &ch) {
+    bool negative = ch == '-';
+    if (negative)
+      ch = input.get ();
+    if (!isdigit (ch))
+      error ("expected literal in line %ld of '%s'", lineno, input.path);
+    long res = 0;
+    while (isdigit (ch)) {
+      res = 10 * res + ch - '0';
+      if (res > INT32_MAX)
+        error ("literal too large in line %ld of '%s'", lineno, input.path);
+      ch = input.get ();
+    }
+    return negative ? -res : res;
+  }
+
+public:
+  // Same guess as 'drat-trim': binary proofs have zero bytes, bytes with
+  // the high bit set or additions 'a'.
+  //
+  Proof (const char *path) : input (path) {
+    const unsigned char *bytes;
+    const size_t size = min (input.peek (bytes), (size_t) 1024);
+    for (size_t i = 0; !binary && i < size; i++)
+      binary = !bytes[i] || bytes[i] >= 0x80 || bytes[i] == 'a';
+  }
+
+  bool is_binary () const { return binary; }
+
+  // Reads the next line into 'lits' and returns its kind, 'a' for
+  // additions, 'd' for deletions and 't' for trusted clauses, or zero at
+  // the end of the proof.
+  //
+  int next (vector<int> &lits) {
+    lits.clear ();
+    if (binary) {
+      const int kind = input.get ();
+      if (kind == EOF)
+        return 0;
+      if (kind != 'a' && kind != 'd' && kind != 't')
+        error ("invalid binary proof line %ld in '%s'", lineno, input.path);
+      for (;;) {
+        unsigned x = 0, shift = 0;
+        int ch;
+        do {
+          if ((ch = input.get ()) == EOF || shift > 28)
+            error ("truncated binary proof line %ld in '%s'", lineno,
+                   input.path);
+          x |= (unsigned) (ch & 0x7f) << shift;
+          shift += 7;
+        } while (ch & 0x80);
+        if (!x)
+          break;
+        lits.push_back ((x & 1) ? -(int) (x >> 1) : (int) (x >> 1));
+      }
+      lineno++;
+      return kind;
+    }
+    int ch;
+    for (;;) {
+      ch = input.get ();
+      if (ch == EOF)
+        return 0;
+      if (ch == 'c') {
+        while ((ch = input.get ()) != '\n' && ch != EOF)
+          ;
+        lineno++;
+      } else if (ch == '\n')
+        lineno++;
+      else if (!isspace (ch))
+        break;
+    }
+    int kind = 'a';
+    if (ch == 'd' || ch == 't')
+      kind = ch, ch = input.get ();
+    for (;;) {
+      while (ch == ' ' || ch == '\t' || ch == '\r')
+        ch = input.get ();
+      const int lit = read_int (ch);
+      if (!lit)
+        break;
+      lits.push_back (lit);
+    }
+    return kind;
+  }
+};
+
+// Writes the lines of a proof in the same format.
+
+static void write_line (FILE *file, bool binary, int kind,
+                        const vector<int> &lits) {
+  if (binary) {
+    fputc (kind, file);
+    for (auto lit : lits) {
+      unsigned x = 2u * abs (lit) + (lit < 0);
+      while (x & ~0x7f)
+        fputc ((x & 0x7f) | 0x80, file), x >>= 7;
+      fputc (x, file);
+    }
+    fputc (0, file);
+  } else {
+    if (kind == 'd')
+      fputs ("d ", file);
+    for (auto lit : lits)
+      fprintf (file, "%d ", lit);
+    fputs ("0\n", file);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+
+static int order;       // vertices
+static int edge_vars;   // variables of the adjacency matrix
+
+static int edge (int i, int j) {
+  if (i < j)
+    swap (i, j);
+  return i * (i - 1) / 2 + j + 1;
+}
+
+// A clause falsified by a graph 'A' together with the (partial)
+// permutation 'p' show that 'A' is not canonical, if under the
+// assignment falsifying the clause the permuted graph 'p(A)' is
+// lexicographically smaller than 'A' (in the order of the edge variables
+// and with edges larger than non-edges).  Then the graph of each
+// isomorphism class which is smallest satisfies the clause.  Going through
+// the entries 'e' of the adjacency matrix in order, the clause must force
+// 'A[e] >= A[p(e)]' (it contains '-e' or 'p(e)') until it forces '>' (it
+// contains both).
+
+static bool check_permutation (const vector<char> &clause, const int *p,
+                               int size) {
+  vector<bool> image (order, false);
+  for (int i = 0; i < size; i++) {
+    if (p[i] < 0 || p[i] >= order || image[p[i]])
+      return false;
+    image[p[i]] = true;
+  }
+  for (int j = 1; j < size; j++)
+    for (int i = 0; i < j; i++) {
+      const int e = edge (i, j), f = edge (p[i], p[j]);
+      if (e == f)
+        continue;
+      const bool at_least = clause[e] & 2, at_most = clause[f] & 1;
+      if (at_least && at_most)
+        return true;
+      if (!at_least && !at_most)
+        return false;
+    }
+  return false;
+}
+
+// A MUS clause is justified if it contains the negation of every edge of
+// the MUS 'g' embedded by 'p', where 'p[i]' is the vertex of the graph
+// playing vertex 'i' of the MUS.  Then every graph falsifying it contains
+// the MUS.
+
+static int mus_order (int g) { return g < 2 ? 10 : g < 7 ? 11 : 12; }
+
+static bool check_mus (const vector<char> &clause, int g, const int *p,
+                       int size) {
+  if (g < 0 || g >= 17 || size != mus_order (g))
+    return false;
+  vector<bool> image (order, false);
+  for (int i = 0; i < size; i++) {
+    if (p[i] < 0 || p[i] >= order || image[p[i]])
+      return false;
+    image[p[i]] = true;
+  }
+  for (int j = 1; j < size; j++)
+    for (int i = 0; i < j; i++)
+      if (mus[g][j * (j - 1) / 2 + i] && !(clause[edge (p[i], p[j])] & 2))
+        return false;
+  return true;
+}
+
+/*------------------------------------------------------------------------*/
+
+// Trusted clauses with their witnesses, checked by one worker.
+
+struct Batch {
+  struct Item {
+    long index;     // of the trusted clause in the proof, from 1
+    int mus;        // MUS index, or -1 for a permutation
+    size_t clause, clause_size, witness, witness_size;
+  };
+  vector<Item> items;
+  vector<int> lits, witnesses;
+};
+
+static const size_t batch_size = 1 << 12;
+static const size_t max_batches = 64; // queued, to bound the memory
+
+static struct {
+  mutex lock;
+  condition_variable wakeup;
+  deque<Batch> batches;
+  bool finished = false;
+} work_queue;
+
+static atomic<long> checked_permutations{0}, checked_mus{0};
+static atomic<long> first_failure{0};
+
+static void fail (long index) {
+  long expected = first_failure;
+  while ((!expected || index < expected) &&
+         !first_failure.compare_exchange_weak (expected, index))
+    ;
+}
+
+// The clause as marks of its literals per edge variable, 1 for positive
+// and 2 for negative ones.  Other literals do not matter.
+
+static bool check (const Batch &batch, const Batch::Item &item,
+                   vector<char> &marks) {
+  fill (marks.begin (), marks.end (), 0);
+  for (size_t i = 0; i < item.clause_size; i++) {
+    const int lit = batch.lits[item.clause + i];
+    if (abs (lit) <= edge_vars)
+      marks[abs (lit)] |= lit < 0 ? 2 : 1;
+  }
+  const int *p = batch.witnesses.data () + item.witness;
+  if (item.mus >= 0)
+    return check_mus (marks, item.mus, p, item.witness_size);
+  return check_permutation (marks, p, item.witness_size);
+}
+
+static void work () {
+  vector<char> marks (edge_vars + 1);
+  for (;;) {
+    Batch batch;
+    {
+      unique_lock<mutex> guard (work_queue.lock);
+      work_queue.wakeup.wait (guard, [] {
+        return !work_queue.batches.empty () || work_queue.finished;
+      });
+      if (work_queue.batches.empty ())
+        return;
+      batch = move (work_queue.batches.front ());
+      work_queue.batches.pop_front ();
+    }
+    work_queue.wakeup.notify_all ();
+    for (const auto &item : batch.items) {
+      if (!check (batch, item, marks))
+        fail (item.index);
+      else if (item.mus >= 0)
+        checked_mus++;
+      else
+        checked_permutations++;
+    }
+  }
+}
+
+static void submit (Batch &batch) {
+  {
+    unique_lock<mutex> guard (work_queue.lock);
+    work_queue.wakeup.wait (guard,
+                       [] { return work_queue.batches.size () < max_batches; });
+    work_queue.batches.push_back (move (batch));
+  }
+  work_queue.wakeup.notify_all ();
+  batch = Batch ();
+}
+
+/*------------------------------------------------------------------------*/
+
+// Permutation file lines are 'p[0] p[1] ...' for noncanonical graphs and
+// 'Minimal unembeddable subgraph <g>:p[0] p[1] ...' for MUS clauses.
+
+static bool read_witness (Input &input, int &g, vector<int> &p) {
+  static const char mus_prefix[] = "Minimal unembeddable subgraph";
+  string line;
+  int ch;
+  while ((ch = input.get ()) != EOF && ch != '\n')
+    line += ch;
+  if (ch == EOF && line.empty ())
+    return false;
+  p.clear ();
+  g = -1;
+  const char *s = line.c_str ();
+  if (!strncmp (s, mus_prefix, sizeof mus_prefix - 1)) {
+    g = strtol (s + sizeof mus_prefix - 1, (char **) &s, 10);
+    if (*s++ != ':')
+      error ("invalid line '%s' in '%s'", line.c_str (), input.path);
+  }
+  for (;;) {
+    while (*s == ' ')
+      s++;
+    if (!*s)
+      break;
+    char *end;
+    const long val = strtol (s, &end, 10);
+    if (end == s)
+      error ("invalid line '%s' in '%s'", line.c_str (), input.path);
+    p.push_back (val);
+    s = end;
+  }
+  return true;
+}
+
+// A blocking clause of a solution (see 'cb_check_found_model') has no
+// witness and consists of all the edge variables.
+
+static bool is_solution (const vector<int> &clause) {
+  if ((int) clause.size () != edge_vars)
+    return false;
+  vector<bool> seen (edge_vars + 1, false);
+  for (auto lit : clause) {
+    if (abs (lit) > edge_vars || seen[abs (lit)])
+      return false;
+    seen[abs (lit)] = true;
+  }
+  return true;
+}
+
+static void usage () {
+  printf (
+      "usage: trustcheck [<option> ...] <order> <proof> <permutations>\n"
+      "\n"
+      "Checks the trusted clauses of a DRAT proof of 'cadical-ks' with\n"
+      "the permutations written by its '--perm-out' option.\n"
+      "\n"
+      "  -t <int>              worker threads [hardware threads]\n"
+      "  --cnf <in> <out>      write the formula with the trusted clauses\n"
+      "  --proof-out <file>    write the proof without the trusted clauses\n"
+      "  --allow-solutions     accept blocking clauses of solutions\n");
+}
+
+int main (int argc, char **argv) {
+  int threads = 0;
+  const char *cnf_in = 0, *cnf_out = 0, *proof_out = 0;
+  bool allow_solutions = false;
+  vector<const char *> positional;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp (argv[i], "-h") || !strcmp (argv[i], "--help")) {
+      usage ();
+      return 0;
+    } else if (!strcmp (argv[i], "-t") && i + 1 < argc)
+      threads = atoi (argv[++i]);
+    else if (!strcmp (argv[i], "--cnf") && i + 2 < argc)
+      cnf_in = argv[i + 1], cnf_out = argv[i + 2], i += 2;
+    else if (!strcmp (argv[i], "--proof-out") && i + 1 < argc)
+      proof_out = argv[++i];
+    else if (!strcmp (argv[i], "--allow-solutions"))
+      allow_solutions = true;
+    else if (argv[i][0] == '-')
+      error ("invalid option '%s' (try '-h')", argv[i]);
+    else
+      positional.push_back (argv[i]);
+  }
+  if (positional.size () != 3)
+    error ("expected '<order> <proof> <permutations>' (try '-h')");
+  order = atoi (positional[0]);
+  if (order < 2 || order > 64)
+    error ("invalid order '%s'", positional[0]);
+  edge_vars = order * (order - 1) / 2;
+  if (threads <= 0)
+    threads = max (1u, thread::hardware_concurrency ());
+
+  const auto start = chrono::steady_clock::now ();
+  Proof proof (positional[1]);
+  Input permutations (positional[2]);
+  FILE *out = 0, *trusted = 0;
+  if (proof_out && !(out = fopen (proof_out, "w")))
+    error ("can not write '%s'", proof_out);
+  if (cnf_out && !(trusted = tmpfile ()))
+    error ("can not create temporary file");
+
+  vector<thread> workers;
+  for (int i = 0; i < threads; i++)
+    workers.emplace_back (work);
+
+  Batch batch;
+  vector<int> lits, p;
+  vector<char> marks (edge_vars + 1);
+  long lines = 0, trusted_clauses = 0, solutions = 0;
+  int g, kind;
+  bool pending = false; // witness read but not yet used
+  while ((kind = proof.next (lits))) {
+    lines++;
+    if (kind != 't') {
+      if (out)
+        write_line (out, proof.is_binary (), kind, lits);
+      continue;
+    }
+    trusted_clauses++;
+    if (trusted)
+      write_line (trusted, false, 'a', lits);
+    if (!pending)
+      pending = read_witness (permutations, g, p);
+
+    // A solution clause takes no witness, unless that happens to justify
+    // it anyway.
+
+    if (is_solution (lits)) {
+      Batch single;
+      single.lits = lits;
+      single.witnesses = p;
+      single.items.push_back ({trusted_clauses, g, 0, lits.size (), 0,
+                               p.size ()});
+      if (!pending || !check (single, single.items[0], marks)) {
+        solutions++;
+        if (!allow_solutions)
+          fail (trusted_clauses);
+        continue;
+      }
+    }
+    if (!pending) {
+      fail (trusted_clauses);
+      continue;
+    }
+    pending = false;
+    batch.items.push_back ({trusted_clauses, g, batch.lits.size (),
+                            lits.size (), batch.witnesses.size (),
+                            p.size ()});
+    batch.lits.insert (batch.lits.end (), lits.begin (), lits.end ());
+    batch.witnesses.insert (batch.witnesses.end (), p.begin (), p.end ());
+    if (batch.items.size () == batch_size)
+      submit (batch);
+  }
+  if (!batch.items.empty ())
+    submit (batch);
+  {
+    lock_guard<mutex> guard (work_queue.lock);
+    work_queue.finished = true;
+  }
+  work_queue.wakeup.notify_all ();
+  for (auto &worker : workers)
+    worker.join ();
+
+  const bool leftover = pending || read_witness (permutations, g, p);
+  if (out)
+    fclose (out);
+
+  if (trusted) {
+    FILE *cnf = fopen (cnf_in, "r"), *res = fopen (cnf_out, "w");
+    if (!cnf)
+      error ("can not read '%s'", cnf_in);
+    if (!res)
+      error ("can not write '%s'", cnf_out);
+    int ch, vars = 0;
+    long clauses = 0;
+    while ((ch = getc (cnf)) == 'c')
+      while ((ch = getc (cnf)) != '\n' && ch != EOF)
+        ;
+    if (ch != 'p' || fscanf (cnf, " cnf %d %ld", &vars, &clauses) != 2)
+      error ("invalid header in '%s'", cnf_in);
+    fprintf (res, "p cnf %d %ld", vars, clauses + trusted_clauses);
+    while ((ch = getc (cnf)) != EOF)
+      putc (ch, res);
+    rewind (trusted);
+    while ((ch = getc (trusted)) != EOF)
+      putc (ch, res);
+    fclose (cnf);
+    fclose (trusted);
+    fclose (res);
+  }
+
+  const double seconds =
+      chrono::duration<double> (chrono::steady_clock::now () - start)
+          .count ();
+  printf ("c %ld proof lines, %ld trusted clauses in %.2f seconds with %d "
+          "threads\n",
+          lines, trusted_clauses, seconds, threads);
+  printf ("c %ld noncanonical and %ld MUS clauses checked, %ld "
+          "solutions\n",
+          checked_permutations.load (), checked_mus.load (), solutions);
+  if (first_failure) {
+    printf ("c trusted clause %ld is not justified\n",
+            first_failure.load ());
+    printf ("s NOT VERIFIED\n");
+    return 1;
+  }
+  if (leftover) {
+    printf ("c more witnesses than trusted clauses\n");
+    printf ("s NOT VERIFIED\n");
+    return 1;
+  }
+  printf ("s VERIFIED\n");
+  return 0;
+}